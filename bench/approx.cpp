@@ -0,0 +1,164 @@
+#include <gmath.hpp>
+#include <approx.hpp>
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+using namespace gmath;
+
+static const int count = 1 << 16;
+static const int repeat = 100;
+
+// Errors are in ulp of the correctly rounded float result: |value - exact| over the
+// spacing of floats at the exact value, taken from a double reference.
+
+struct report
+{
+	double ulp;
+	double ns;
+};
+
+static double ulps(const double value, const double reference)
+{
+	float r = (float)reference;
+	float a = r < 0.0f ? -r : r;
+	double step = (double)(nextafterf(a, FLT_MAX) - a);
+	return fabs(value - reference) / step;
+}
+
+template <typename F> static double measure(const F& kernel)
+{
+	double best = 1e30;
+	for (int r = 0; r < repeat; r++)
+	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		kernel();
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count();
+		best = ns < best ? ns : best;
+	}
+
+	return best / (double)count;
+}
+
+template <typename F, typename R> static report scalar(const std::vector<float>& in, const F& f, const R& reference)
+{
+	report r = { 0.0, 0.0 };
+	for (size_t i = 0; i < in.size(); i++)
+	{
+		double e = ulps((double)f(in[i]), reference((double)in[i]));
+		r.ulp = e > r.ulp ? e : r.ulp;
+	}
+
+	std::vector<float> out(in.size());
+	r.ns = measure([&]()
+	{
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			out[i] = f(in[i]);
+		}
+	});
+	return r;
+}
+
+template <typename F> static report vector3(const std::vector<vec3>& in, const F& f)
+{
+	report r = { 0.0, 0.0 };
+	for (size_t i = 0; i < in.size(); i++)
+	{
+		vec3 value = f(in[i]);
+		double m = sqrt(((double)in[i].x * in[i].x) + ((double)in[i].y * in[i].y) + ((double)in[i].z * in[i].z));
+		double exact[3] = { in[i].x / m, in[i].y / m, in[i].z / m };
+		for (int k = 0; k < 3; k++)
+		{
+			double e = ulps((double)value[k], exact[k]);
+			r.ulp = e > r.ulp ? e : r.ulp;
+		}
+	}
+
+	std::vector<vec3> out(in.size());
+	r.ns = measure([&]()
+	{
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			out[i] = f(in[i]);
+		}
+	});
+	return r;
+}
+
+// sincos is timed as one call writing both results; its error is the worse of the two.
+template <typename P> static report fused(const std::vector<float>& in, const P p)
+{
+	report r = { 0.0, 0.0 };
+	for (size_t i = 0; i < in.size(); i++)
+	{
+		float s, c;
+		sincos(in[i], s, c, p);
+		double es = ulps((double)s, ::sin((double)in[i]));
+		double ec = ulps((double)c, ::cos((double)in[i]));
+		r.ulp = es > r.ulp ? es : r.ulp;
+		r.ulp = ec > r.ulp ? ec : r.ulp;
+	}
+
+	std::vector<float> out(in.size() * 2);
+	r.ns = measure([&]()
+	{
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			sincos(in[i], out[i * 2], out[(i * 2) + 1], p);
+		}
+	});
+	return r;
+}
+
+static void print(const char* name, const char* policy, const report& r)
+{
+	printf("%-10s %-8s %12.1f %10.3f\n", name, policy, r.ulp, r.ns);
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<float> positive(count), angles(count);
+	std::vector<vec3> vectors(count);
+	for (int i = 0; i < count; i++)
+	{
+		float t = (float)i / (float)count;
+		positive[i] = 1e-3f + (t * 1e3f);
+		angles[i] = (t - 0.5f) * 200.0f;
+		vectors[i] = vec3(cosf(t * 97.0f) * (1.0f + t), sinf(t * 13.0f) * 3.0f, t - 0.5f);
+	}
+
+	printf("%-10s %-8s %12s %10s\n", "function", "policy", "max ulp", "ns/op");
+
+	print("rsqrt", "exact", scalar(positive, [](float x) { return rsqrt(x, precision::exact()); }, [](double x) { return 1.0 / sqrt(x); }));
+	print("rsqrt", "fast", scalar(positive, [](float x) { return rsqrt(x, precision::fast()); }, [](double x) { return 1.0 / sqrt(x); }));
+	print("rsqrt", "fastest", scalar(positive, [](float x) { return rsqrt(x, precision::fastest()); }, [](double x) { return 1.0 / sqrt(x); }));
+
+	print("sqrt", "exact", scalar(positive, [](float x) { return sqrt(x, precision::exact()); }, [](double x) { return sqrt(x); }));
+	print("sqrt", "fast", scalar(positive, [](float x) { return sqrt(x, precision::fast()); }, [](double x) { return sqrt(x); }));
+	print("sqrt", "fastest", scalar(positive, [](float x) { return sqrt(x, precision::fastest()); }, [](double x) { return sqrt(x); }));
+
+	print("sin", "exact", scalar(angles, [](float x) { return sin(x, precision::exact()); }, [](double x) { return sin(x); }));
+	print("sin", "fast", scalar(angles, [](float x) { return sin(x, precision::fast()); }, [](double x) { return sin(x); }));
+	print("sin", "fastest", scalar(angles, [](float x) { return sin(x, precision::fastest()); }, [](double x) { return sin(x); }));
+
+	print("cos", "exact", scalar(angles, [](float x) { return cos(x, precision::exact()); }, [](double x) { return cos(x); }));
+	print("cos", "fast", scalar(angles, [](float x) { return cos(x, precision::fast()); }, [](double x) { return cos(x); }));
+	print("cos", "fastest", scalar(angles, [](float x) { return cos(x, precision::fastest()); }, [](double x) { return cos(x); }));
+
+	print("tan", "exact", scalar(angles, [](float x) { return tan(x, precision::exact()); }, [](double x) { return ::tan(x); }));
+	print("tan", "fast", scalar(angles, [](float x) { return tan(x, precision::fast()); }, [](double x) { return ::tan(x); }));
+	print("tan", "fastest", scalar(angles, [](float x) { return tan(x, precision::fastest()); }, [](double x) { return ::tan(x); }));
+
+	print("sincos", "exact", fused(angles, precision::exact()));
+	print("sincos", "fast", fused(angles, precision::fast()));
+	print("sincos", "fastest", fused(angles, precision::fastest()));
+
+	print("normalize", "exact", vector3(vectors, [](const vec3& v) { return normalize(v, precision::exact()); }));
+	print("normalize", "fast", vector3(vectors, [](const vec3& v) { return normalize(v, precision::fast()); }));
+	print("normalize", "fastest", vector3(vectors, [](const vec3& v) { return normalize(v, precision::fastest()); }));
+
+	return 0;
+}
\ No newline at end of file
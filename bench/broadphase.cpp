@@ -0,0 +1,123 @@
+#include <gmath.hpp>
+#include <broadphase.hpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+using namespace gmath;
+
+// Per tick cost of the dynamic tree over boxes drifting through a cube at 60 ticks a second, for a
+// range of margins: how many proxies leave their fat boxes, what keeping the tree up to date costs and
+// how many pairs come out. Pass a box count to change the size.
+
+static const int ticks = 60;
+static const float side = 100.0f;
+static const float dt = 1.0f / 60.0f;
+
+struct body
+{
+	vec3 position;
+	vec3 velocity;
+	vec3 extent;
+};
+
+static float uniform(unsigned int& state)
+{
+	state = (state * 1664525u) + 1013904223u;
+	return (float)(state >> 8) / 16777216.0f;
+}
+
+static double elapsed(const std::chrono::high_resolution_clock::time_point& start)
+{
+	return (double)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count() / 1000.0;
+}
+
+static void step(std::vector<body>& bodies)
+{
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		body& b = bodies[i];
+		b.position = b.position + (b.velocity * dt);
+		float* p = (float*)&b.position;
+		float* v = (float*)&b.velocity;
+		for (int k = 0; k < 3; k++)
+		{
+			if (p[k] < 0.0f || p[k] > side)
+			{
+				v[k] = -v[k];
+			}
+		}
+	}
+}
+
+static void run(const std::vector<body>& start, const float margin)
+{
+	std::vector<body> bodies(start);
+	std::vector<int> proxies(bodies.size());
+	broadphase tree(margin);
+
+	std::chrono::high_resolution_clock::time_point t = std::chrono::high_resolution_clock::now();
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		proxies[i] = tree.create(aabb3(bodies[i].position - bodies[i].extent, bodies[i].position + bodies[i].extent));
+	}
+	double build = elapsed(t);
+	tree.pairs([](const int a, const int b) {});
+
+	double update = 0.0;
+	double enumerate = 0.0;
+	double reinserted = 0.0;
+	double rotations = 0.0;
+	double visited = 0.0;
+	double pairs = 0.0;
+	double tested = 0.0;
+	for (int tick = 0; tick < ticks; tick++)
+	{
+		step(bodies);
+		t = std::chrono::high_resolution_clock::now();
+		for (size_t i = 0; i < bodies.size(); i++)
+		{
+			tree.move(proxies[i], aabb3(bodies[i].position - bodies[i].extent, bodies[i].position + bodies[i].extent));
+		}
+		update += elapsed(t);
+
+		t = std::chrono::high_resolution_clock::now();
+		tree.pairs([](const int a, const int b) {});
+		enumerate += elapsed(t);
+
+		const broadphase::counters& c = tree.stats();
+		reinserted += c.reinserted;
+		rotations += c.rotations;
+		visited += c.visited;
+		pairs += c.pairs;
+		tested += c.tested;
+	}
+
+	printf("%6.2f %8.1f %8.3f %8.3f %10.0f %9.0f %10.0f %9.0f %10.0f %6d\n", margin, build, update / ticks, enumerate / ticks, reinserted / ticks, rotations / ticks, visited / ticks, pairs / ticks, tested / ticks, tree.height());
+}
+
+int main(int argc, char** argv)
+{
+	int count = argc > 1 ? atoi(argv[1]) : 100000;
+	unsigned int state = 5;
+	std::vector<body> bodies(count);
+	for (int i = 0; i < count; i++)
+	{
+		body& b = bodies[i];
+		b.position = vec3(uniform(state) * side, uniform(state) * side, uniform(state) * side);
+		b.velocity = vec3(uniform(state) - 0.5f, uniform(state) - 0.5f, uniform(state) - 0.5f) * 4.0f;
+		b.extent = vec3(0.25f + uniform(state), 0.25f + uniform(state), 0.25f + uniform(state)) * 0.5f;
+	}
+
+	const float margins[] = { 0.0f, 0.02f, 0.05f, 0.1f, 0.2f, 0.5f };
+	printf("%d boxes, %d ticks; build and per tick times in ms, the rest per tick averages\n", count, ticks);
+	printf("%6s %8s %8s %8s %10s %9s %10s %9s %10s %6s\n", "margin", "build", "update", "pairs", "reinserted", "rotations", "visited", "new pairs", "tested", "height");
+	for (int i = 0; i < (int)(sizeof(margins) / sizeof(margins[0])); i++)
+	{
+		run(bodies, margins[i]);
+	}
+
+	return 0;
+}
\ No newline at end of file
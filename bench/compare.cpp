@@ -0,0 +1,217 @@
+#include <gmath.hpp>
+#include <batch.hpp>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+
+// Flop counts are nominal, taken from the textbook formula for each operation and shared by both
+// libraries so that GFLOP/s compares like with like. sqrt, division and tan count as one flop each.
+//
+//   vec3_add_scale    a + b * s                           6
+//   vec4_madd         a * b + c                           8
+//   vec3_dot                                              5
+//   vec3_cross        unnormalized                        9
+//   vec3_normalize    dot, sqrt, reciprocal, 3 mul       10
+//   mat4_multiply     64 mul, 48 add                    112
+//   mat4_inverse      cofactor expansion                140
+//   transform_points  affine 3x4 per point               18
+//   perspective                                          12
+//   look                                                 56
+//   project           2 mat-vec, divide, remap           66
+//   unproject         multiply, inverse, mat-vec        290
+
+static const int count = 1 << 14;
+static const int repeat = 200;
+
+static_assert(sizeof(gmath::vec3) == sizeof(glm::vec3) && sizeof(gmath::mat4) == sizeof(glm::mat4), "layouts must match to compare outputs");
+
+struct result
+{
+	const char* name;
+	int flops;
+	double gmath;
+	double glm;
+	float difference;
+};
+
+template <typename F> static double measure(const F& kernel)
+{
+	double best = 1e30;
+	for (int r = 0; r < repeat; r++)
+	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		kernel();
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count();
+		best = ns < best ? ns : best;
+	}
+
+	return best / (double)count;
+}
+
+static float difference(const float* x, const float* y, const size_t count)
+{
+	float d = 0.0f;
+	for (size_t i = 0; i < count; i++)
+	{
+		float e = (x[i] - y[i]) / (1.0f + (y[i] < 0.0f ? -y[i] : y[i]));
+		e = e < 0.0f ? -e : e;
+		d = e > d ? e : d;
+	}
+
+	return d;
+}
+
+template <typename G, typename L, typename U, typename V> static result compare(const char* name, const int flops, const G& gkernel, const L& lkernel, const std::vector<U>& gout, const std::vector<V>& lout)
+{
+	result r;
+	r.name = name;
+	r.flops = flops;
+	r.gmath = measure(gkernel);
+	r.glm = measure(lkernel);
+	r.difference = difference((const float*)&gout[0], (const float*)&lout[0], (gout.size() * sizeof(U)) / sizeof(float));
+	return r;
+}
+
+static glm::mat4 convert(const gmath::mat4& m)
+{
+	glm::mat4 out;
+	for (int c = 0; c < 4; c++)
+	{
+		out[c] = glm::vec4(m._columns[c].x, m._columns[c].y, m._columns[c].z, m._columns[c].w);
+	}
+
+	return out;
+}
+
+static const char* isa()
+{
+#if defined(GMATH_AVX512)
+	return "avx512";
+#elif defined(GMATH_AVX2)
+	return "avx2";
+#elif defined(GMATH_AVX)
+	return "avx";
+#elif defined(GMATH_SSE41)
+	return "sse4.1";
+#else
+	return "none";
+#endif
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<gmath::mat4> ga(count), gb(count), gm(count);
+	std::vector<gmath::vec4> gx(count), gy(count), gz(count), gv(count);
+	std::vector<gmath::vec3> gp(count), gq(count), gu(count), gw(count);
+	std::vector<glm::mat4> la(count), lb(count), lm(count);
+	std::vector<glm::vec4> lx(count), ly(count), lz(count), lv(count);
+	std::vector<glm::vec3> lp(count), lq(count), lu(count), lw(count);
+	std::vector<float> fov(count), gs(count), ls(count);
+	for (int i = 0; i < count; i++)
+	{
+		float f = (float)i;
+		ga[i] = gmath::translate(gmath::rotate(gmath::scale(1.0f + (f * 1e-4f), 2.0f, 0.5f), f, gmath::vec3(1.0f, 2.0f, 3.0f)), f * 1e-2f, -f * 1e-2f, 1.0f);
+		gb[i] = gmath::perspective(45.0f + (f * 1e-3f), 1.5f, 0.1f, 100.0f);
+		la[i] = convert(ga[i]);
+		lb[i] = convert(gb[i]);
+
+		gx[i] = gmath::vec4(f, 1.0f - f, 0.25f * f, 1.0f);
+		gy[i] = gmath::vec4(0.5f, -2.0f, f * 1e-3f, 3.0f);
+		gz[i] = gmath::vec4(1.0f, 2.0f, 3.0f, -f);
+		lx[i] = glm::vec4(gx[i].x, gx[i].y, gx[i].z, gx[i].w);
+		ly[i] = glm::vec4(gy[i].x, gy[i].y, gy[i].z, gy[i].w);
+		lz[i] = glm::vec4(gz[i].x, gz[i].y, gz[i].z, gz[i].w);
+
+		gp[i] = gmath::vec3(f * 1e-2f, 2.0f, 1.0f - (f * 1e-2f));
+		gq[i] = gmath::vec3(-1.0f, f * 5e-3f, 3.0f);
+		lp[i] = glm::vec3(gp[i].x, gp[i].y, gp[i].z);
+		lq[i] = glm::vec3(gq[i].x, gq[i].y, gq[i].z);
+
+		gw[i] = gmath::vec3((float)(i % 128) / 127.0f, (float)((i / 128) % 128) / 127.0f, 0.5f + ((float)(i % 7) * 0.05f));
+		lw[i] = glm::vec3(gw[i].x, gw[i].y, gw[i].z);
+
+		fov[i] = 30.0f + (float)(i % 90);
+	}
+
+	const float s = 0.75f;
+	const gmath::vec3 gup(0.0f, 1.0f, 0.0f);
+	const glm::vec3 lup(0.0f, 1.0f, 0.0f);
+	const glm::vec4 viewport(0.0f, 0.0f, 1.0f, 1.0f);
+	std::vector<result> results;
+
+	results.push_back(compare("vec3_add_scale", 6,
+		[&]() { for (int i = 0; i < count; i++) { gu[i] = gp[i] + (gq[i] * s); } },
+		[&]() { for (int i = 0; i < count; i++) { lu[i] = lp[i] + (lq[i] * s); } },
+		gu, lu));
+	results.push_back(compare("vec4_madd", 8,
+		[&]() { for (int i = 0; i < count; i++) { gv[i] = (gx[i] * gy[i]) + gz[i]; } },
+		[&]() { for (int i = 0; i < count; i++) { lv[i] = (lx[i] * ly[i]) + lz[i]; } },
+		gv, lv));
+	results.push_back(compare("vec3_dot", 5,
+		[&]() { for (int i = 0; i < count; i++) { gs[i] = gmath::dot(gp[i], gq[i]); } },
+		[&]() { for (int i = 0; i < count; i++) { ls[i] = glm::dot(lp[i], lq[i]); } },
+		gs, ls));
+	results.push_back(compare("vec3_cross", 9,
+		[&]() { for (int i = 0; i < count; i++) { gu[i] = gmath::crossUnnormalized(gp[i], gq[i]); } },
+		[&]() { for (int i = 0; i < count; i++) { lu[i] = glm::cross(lp[i], lq[i]); } },
+		gu, lu));
+	results.push_back(compare("vec3_normalize", 10,
+		[&]() { for (int i = 0; i < count; i++) { gu[i] = gmath::normalize(gq[i]); } },
+		[&]() { for (int i = 0; i < count; i++) { lu[i] = glm::normalize(lq[i]); } },
+		gu, lu));
+	results.push_back(compare("mat4_multiply", 112,
+		[&]() { for (int i = 0; i < count; i++) { gm[i] = gb[i] * ga[i]; } },
+		[&]() { for (int i = 0; i < count; i++) { lm[i] = lb[i] * la[i]; } },
+		gm, lm));
+	results.push_back(compare("mat4_inverse", 140,
+		[&]() { for (int i = 0; i < count; i++) { gm[i] = gmath::inverse(ga[i]); } },
+		[&]() { for (int i = 0; i < count; i++) { lm[i] = glm::inverse(la[i]); } },
+		gm, lm));
+	results.push_back(compare("transform_points", 18,
+		[&]() { gmath::transformPoints(ga[1], &gp[0], &gu[0], count); },
+		[&]() { for (int i = 0; i < count; i++) { lu[i] = glm::vec3(la[1] * glm::vec4(lp[i], 1.0f)); } },
+		gu, lu));
+	results.push_back(compare("perspective", 12,
+		[&]() { for (int i = 0; i < count; i++) { gm[i] = gmath::perspective(fov[i], 1.5f, 0.1f, 100.0f); } },
+		[&]() { for (int i = 0; i < count; i++) { lm[i] = glm::perspective(glm::radians(fov[i]), 1.5f, 0.1f, 100.0f); } },
+		gm, lm));
+	results.push_back(compare("look", 56,
+		[&]() { for (int i = 0; i < count; i++) { gm[i] = gmath::look(gp[i], gq[i], gup); } },
+		[&]() { for (int i = 0; i < count; i++) { lm[i] = glm::lookAt(lp[i], lq[i], lup); } },
+		gm, lm));
+	results.push_back(compare("project", 66,
+		[&]() { for (int i = 0; i < count; i++) { gu[i] = gmath::project(gq[i], ga[i], gb[i]); } },
+		[&]() { for (int i = 0; i < count; i++) { lu[i] = glm::project(lq[i], la[i], lb[i], viewport); } },
+		gu, lu));
+	results.push_back(compare("unproject", 290,
+		[&]() { for (int i = 0; i < count; i++) { gu[i] = gmath::unproject(gw[i], ga[i], gb[i]); } },
+		[&]() { for (int i = 0; i < count; i++) { lu[i] = glm::unProject(lw[i], la[i], lb[i], viewport); } },
+		gu, lu));
+
+	bool agree = true;
+	printf("{\n");
+#if defined(__VERSION__)
+	printf("  \"compiler\": \"%s\",\n", __VERSION__);
+#endif
+	printf("  \"simd\": \"%s\",\n", isa());
+	printf("  \"count\": %d,\n", count);
+	printf("  \"repeat\": %d,\n", repeat);
+	printf("  \"benchmarks\": [\n");
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const result& r = results[i];
+		printf("    { \"name\": \"%s\", \"flops\": %d, ", r.name, r.flops);
+		printf("\"gmath\": { \"ns_per_op\": %.4f, \"gflops\": %.3f }, ", r.gmath, (double)r.flops / r.gmath);
+		printf("\"glm\": { \"ns_per_op\": %.4f, \"gflops\": %.3f }, ", r.glm, (double)r.flops / r.glm);
+		printf("\"speedup\": %.3f, \"max_difference\": %.3g }%s\n", r.glm / r.gmath, r.difference, i + 1 < results.size() ? "," : "");
+		agree = agree && r.difference < 1e-3f;
+	}
+	printf("  ]\n");
+	printf("}\n");
+
+	return agree ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include <gmath.hpp>
+#include <fixed.hpp>
+
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+using namespace gmath;
+
+static const int count = 1 << 16;
+static const int repeat = 100;
+
+// sqrt and normalize in float, fixed32 and fixed64 over the same inputs. Errors are the largest
+// distance from a double reference, in steps of the type: ulp for float, the last fractional bit
+// for the fixed types.
+
+struct report
+{
+	double steps;
+	double ns;
+};
+
+template <typename F> static double measure(const F& kernel)
+{
+	double best = 1e30;
+	for (int r = 0; r < repeat; r++)
+	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		kernel();
+		double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - start).count();
+		best = ns < best ? ns : best;
+	}
+
+	return best / (double)count;
+}
+
+static double step(const float x) { float a = x < 0.0f ? -x : x; return (double)(nextafterf(a, FLT_MAX) - a); }
+template <typename S, int F> static double step(const tfixed<S, F>&) { return 1.0 / (double)((S)1 << F); }
+
+template <typename T> static report roots(const std::vector<double>& in)
+{
+	report r = { 0.0, 0.0 };
+	std::vector<T> x(in.size());
+	for (size_t i = 0; i < in.size(); i++)
+	{
+		x[i] = T(in[i]);
+		double e = fabs((double)sqrt(x[i]) - ::sqrt((double)x[i])) / step(sqrt(x[i]));
+		r.steps = e > r.steps ? e : r.steps;
+	}
+
+	std::vector<T> out(in.size());
+	r.ns = measure([&]()
+	{
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			out[i] = sqrt(x[i]);
+		}
+	});
+	return r;
+}
+
+template <typename T> static report normals(const std::vector<tvec3<double> >& in)
+{
+	report r = { 0.0, 0.0 };
+	std::vector<tvec3<T> > v(in.size());
+	for (size_t i = 0; i < in.size(); i++)
+	{
+		v[i] = tvec3<T>(T(in[i].x), T(in[i].y), T(in[i].z));
+		tvec3<T> n = normalize(v[i]);
+		double x = (double)v[i].x;
+		double y = (double)v[i].y;
+		double z = (double)v[i].z;
+		double m = ::sqrt((x * x) + (y * y) + (z * z));
+		double exact[3] = { x / m, y / m, z / m };
+		for (int k = 0; k < 3; k++)
+		{
+			double e = fabs((double)n[k] - exact[k]) / step(n[k]);
+			r.steps = e > r.steps ? e : r.steps;
+		}
+	}
+
+	std::vector<tvec3<T> > out(in.size());
+	r.ns = measure([&]()
+	{
+		for (size_t i = 0; i < in.size(); i++)
+		{
+			out[i] = normalize(v[i]);
+		}
+	});
+	return r;
+}
+
+static void print(const char* name, const char* type, const report& r)
+{
+	printf("%-10s %-8s %10.1f %10.3f\n", name, type, r.steps, r.ns);
+}
+
+int main(int argc, char** argv)
+{
+	std::vector<double> positive(count);
+	std::vector<tvec3<double> > vectors(count);
+	for (int i = 0; i < count; i++)
+	{
+		double t = (double)i / (double)count;
+		positive[i] = 1e-3 + (t * 1e4);
+		vectors[i] = tvec3<double>(::cos(t * 97.0) * (1.0 + t), ::sin(t * 13.0) * 3.0, t - 0.5);
+	}
+
+	printf("%-10s %-8s %10s %10s\n", "function", "type", "max steps", "ns/op");
+
+	print("sqrt", "float", roots<float>(positive));
+	print("sqrt", "fixed32", roots<fixed32>(positive));
+	print("sqrt", "fixed64", roots<fixed64>(positive));
+
+	print("normalize", "float", normals<float>(vectors));
+	print("normalize", "fixed32", normals<fixed32>(vectors));
+	print("normalize", "fixed64", normals<fixed64>(vectors));
+
+	return 0;
+}
\ No newline at end of file
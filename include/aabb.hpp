@@ -0,0 +1,491 @@
+#ifndef AABB_H
+#define AABB_H
+
+#include <float.h>
+
+#include <gmath.hpp>
+#include <batch.hpp>
+
+namespace gmath
+{
+
+#if !(defined(taabb2) || defined(taabb3) || defined(aabb2) || defined(aabb3))
+// Axis-aligned boxes stored as their two corners and nothing else. A default box is empty, min above
+// max, so merging points or boxes into it grows it from nothing. Boxes that only touch overlap, and
+// points on a face are contained.
+template <typename T> struct taabb2
+{
+
+	inline taabb2() : min((T)FLT_MAX), max((T)-FLT_MAX) {}
+	inline taabb2(const tvec2<T>& p) : min(p), max(p) {}
+	inline taabb2(const tvec2<T>& min, const tvec2<T>& max) : min(min), max(max) {}
+
+	tvec2<T> min;
+	tvec2<T> max;
+
+};
+template <typename T> struct taabb3
+{
+
+	inline taabb3() : min((T)FLT_MAX), max((T)-FLT_MAX) {}
+	inline taabb3(const tvec3<T>& p) : min(p), max(p) {}
+	inline taabb3(const tvec3<T>& min, const tvec3<T>& max) : min(min), max(max) {}
+
+	tvec3<T> min;
+	tvec3<T> max;
+
+};
+
+template <typename T> inline bool empty(const taabb2<T>& b)
+{
+	return b.min.x > b.max.x || b.min.y > b.max.y;
+}
+template <typename T> inline tvec2<T> center(const taabb2<T>& b)
+{
+	return (b.min + b.max) * (T)0.5;
+}
+template <typename T> inline tvec2<T> size(const taabb2<T>& b)
+{
+	return b.max - b.min;
+}
+template <typename T> inline T area(const taabb2<T>& b)
+{
+	return empty(b) ? (T)0 : (b.max.x - b.min.x) * (b.max.y - b.min.y);
+}
+template <typename T> inline taabb2<T> merge(const taabb2<T>& a, const taabb2<T>& b)
+{
+	return taabb2<T>(tvec2<T>(a.min.x < b.min.x ? a.min.x : b.min.x, a.min.y < b.min.y ? a.min.y : b.min.y), tvec2<T>(a.max.x > b.max.x ? a.max.x : b.max.x, a.max.y > b.max.y ? a.max.y : b.max.y));
+}
+template <typename T> inline taabb2<T> merge(const taabb2<T>& b, const tvec2<T>& p)
+{
+	return merge(b, taabb2<T>(p));
+}
+// Empty when the boxes do not overlap.
+template <typename T> inline taabb2<T> intersection(const taabb2<T>& a, const taabb2<T>& b)
+{
+	return taabb2<T>(tvec2<T>(a.min.x > b.min.x ? a.min.x : b.min.x, a.min.y > b.min.y ? a.min.y : b.min.y), tvec2<T>(a.max.x < b.max.x ? a.max.x : b.max.x, a.max.y < b.max.y ? a.max.y : b.max.y));
+}
+template <typename T> inline bool overlaps(const taabb2<T>& a, const taabb2<T>& b)
+{
+	return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+}
+template <typename T> inline bool contains(const taabb2<T>& b, const tvec2<T>& p)
+{
+	return b.min.x <= p.x && p.x <= b.max.x && b.min.y <= p.y && p.y <= b.max.y;
+}
+template <typename T> inline bool contains(const taabb2<T>& a, const taabb2<T>& b)
+{
+	return a.min.x <= b.min.x && b.max.x <= a.max.x && a.min.y <= b.min.y && b.max.y <= a.max.y;
+}
+
+template <typename T> inline bool empty(const taabb3<T>& b)
+{
+	return b.min.x > b.max.x || b.min.y > b.max.y || b.min.z > b.max.z;
+}
+template <typename T> inline tvec3<T> center(const taabb3<T>& b)
+{
+	return (b.min + b.max) * (T)0.5;
+}
+template <typename T> inline tvec3<T> size(const taabb3<T>& b)
+{
+	return b.max - b.min;
+}
+// Surface area, the usual cost weight for bounding volume hierarchies.
+template <typename T> inline T area(const taabb3<T>& b)
+{
+	tvec3<T> d = b.max - b.min;
+	return empty(b) ? (T)0 : (T)2 * ((d.x * d.y) + (d.y * d.z) + (d.z * d.x));
+}
+template <typename T> inline T volume(const taabb3<T>& b)
+{
+	tvec3<T> d = b.max - b.min;
+	return empty(b) ? (T)0 : d.x * d.y * d.z;
+}
+template <typename T> inline taabb3<T> merge(const taabb3<T>& a, const taabb3<T>& b)
+{
+	taabb3<T> r;
+	for (int k = 0; k < 3; k++)
+	{
+		((T*)&r.min)[k] = ((const T*)&a.min)[k] < ((const T*)&b.min)[k] ? ((const T*)&a.min)[k] : ((const T*)&b.min)[k];
+		((T*)&r.max)[k] = ((const T*)&a.max)[k] > ((const T*)&b.max)[k] ? ((const T*)&a.max)[k] : ((const T*)&b.max)[k];
+	}
+
+	return r;
+}
+template <typename T> inline taabb3<T> merge(const taabb3<T>& b, const tvec3<T>& p)
+{
+	return merge(b, taabb3<T>(p));
+}
+// Empty when the boxes do not overlap.
+template <typename T> inline taabb3<T> intersection(const taabb3<T>& a, const taabb3<T>& b)
+{
+	taabb3<T> r;
+	for (int k = 0; k < 3; k++)
+	{
+		((T*)&r.min)[k] = ((const T*)&a.min)[k] > ((const T*)&b.min)[k] ? ((const T*)&a.min)[k] : ((const T*)&b.min)[k];
+		((T*)&r.max)[k] = ((const T*)&a.max)[k] < ((const T*)&b.max)[k] ? ((const T*)&a.max)[k] : ((const T*)&b.max)[k];
+	}
+
+	return r;
+}
+template <typename T> inline bool overlaps(const taabb3<T>& a, const taabb3<T>& b)
+{
+	return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y && a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+template <typename T> inline bool contains(const taabb3<T>& b, const tvec3<T>& p)
+{
+	return b.min.x <= p.x && p.x <= b.max.x && b.min.y <= p.y && p.y <= b.max.y && b.min.z <= p.z && p.z <= b.max.z;
+}
+template <typename T> inline bool contains(const taabb3<T>& a, const taabb3<T>& b)
+{
+	return a.min.x <= b.min.x && b.max.x <= a.max.x && a.min.y <= b.min.y && b.max.y <= a.max.y && a.min.z <= b.min.z && b.max.z <= a.max.z;
+}
+// The box around b after the affine transform m, by Arvo's method: the center goes through m and each
+// half extent is spread over the axes by the absolute value of the upper 3x3. Tight for rotations of
+// the box, never smaller than the transformed corners.
+template <typename T> inline taabb3<T> transform(const tmat4x4<T>& m, const taabb3<T>& b)
+{
+	if (empty(b))
+	{
+		return b;
+	}
+
+	tvec3<T> c = center(b);
+	tvec3<T> e = size(b) * (T)0.5;
+	taabb3<T> r;
+	for (int k = 0; k < 3; k++)
+	{
+		T x = m._columns[3][k];
+		T y = (T)0;
+		for (int j = 0; j < 3; j++)
+		{
+			T a = m._columns[j][k];
+			x += a * ((const T*)&c)[j];
+			y += (a < (T)0 ? -a : a) * ((const T*)&e)[j];
+		}
+
+		((T*)&r.min)[k] = x - y;
+		((T*)&r.max)[k] = x + y;
+	}
+
+	return r;
+}
+
+namespace simd
+{
+
+// e[0] to e[3] hold min x, min y, max x and max y of L::width boxes
+template <typename L, typename T> inline void gather(const taabb2<T>* b, L* e)
+{
+	T x[L::width];
+	for (int k = 0; k < 4; k++)
+	{
+		for (int j = 0; j < L::width; j++)
+		{
+			x[j] = ((const T*)(b + j))[k];
+		}
+
+		e[k] = L::load(x);
+	}
+}
+// e[0] to e[2] hold the min corners and e[3] to e[5] the max corners of L::width boxes
+template <typename L, typename T> inline void gather(const taabb3<T>* b, L* e)
+{
+	T x[L::width];
+	for (int k = 0; k < 6; k++)
+	{
+		for (int j = 0; j < L::width; j++)
+		{
+			x[j] = ((const T*)(b + j))[k];
+		}
+
+		e[k] = L::load(x);
+	}
+}
+template <typename L, typename T> inline void broadcast(const taabb2<T>& b, L* e)
+{
+	for (int k = 0; k < 4; k++)
+	{
+		e[k] = L(((const T*)&b)[k]);
+	}
+}
+template <typename L, typename T> inline void broadcast(const taabb3<T>& b, L* e)
+{
+	for (int k = 0; k < 6; k++)
+	{
+		e[k] = L(((const T*)&b)[k]);
+	}
+}
+
+#if defined(GMATH_SSE41)
+// A float box is six consecutive floats: lo gets the min corner and hi the max corner, each from one
+// unaligned load, with the fourth lane left holding a component of the other corner.
+inline void load(const taabb3<float>& b, __m128& lo, __m128& hi)
+{
+	lo = _mm_loadu_ps(&b.min.x);
+	hi = _mm_loadu_ps(&b.min.z);
+	hi = _mm_shuffle_ps(hi, hi, _MM_SHUFFLE(0, 3, 2, 1));
+}
+inline void store(taabb3<float>& b, const __m128 lo, const __m128 hi)
+{
+	native::store3(b.min, lo);
+	native::store3(b.max, hi);
+}
+// Lanes 0 and 1 compare box <= x and lanes 2 and 3 box >= x, so a 2D box [min, max] against x = p, p
+// contains a point, against another box contains it and against the other box swapped overlaps it.
+inline bool within(const __m128 box, const __m128 x)
+{
+	return _mm_movemask_ps(_mm_blend_ps(_mm_cmple_ps(box, x), _mm_cmpge_ps(box, x), 0xC)) == 0xF;
+}
+
+inline void gather(const taabb2<float>* b, f32x4* e)
+{
+	__m128 r0 = _mm_loadu_ps(&b[0].min.x);
+	__m128 r1 = _mm_loadu_ps(&b[1].min.x);
+	__m128 r2 = _mm_loadu_ps(&b[2].min.x);
+	__m128 r3 = _mm_loadu_ps(&b[3].min.x);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	e[0] = r0;
+	e[1] = r1;
+	e[2] = r2;
+	e[3] = r3;
+}
+inline void gather(const taabb3<float>* b, f32x4* e)
+{
+	__m128 l0 = _mm_loadu_ps(&b[0].min.x);
+	__m128 l1 = _mm_loadu_ps(&b[1].min.x);
+	__m128 l2 = _mm_loadu_ps(&b[2].min.x);
+	__m128 l3 = _mm_loadu_ps(&b[3].min.x);
+	__m128 h0 = _mm_loadu_ps(&b[0].min.z);
+	__m128 h1 = _mm_loadu_ps(&b[1].min.z);
+	__m128 h2 = _mm_loadu_ps(&b[2].min.z);
+	__m128 h3 = _mm_loadu_ps(&b[3].min.z);
+	_MM_TRANSPOSE4_PS(l0, l1, l2, l3);
+	_MM_TRANSPOSE4_PS(h0, h1, h2, h3);
+	e[0] = l0;
+	e[1] = l1;
+	e[2] = l2;
+	e[3] = h1;
+	e[4] = h2;
+	e[5] = h3;
+}
+#endif
+#if defined(GMATH_AVX)
+inline void gather(const taabb2<float>* b, f32x8* e)
+{
+	f32x4 lo[4];
+	f32x4 hi[4];
+	gather(b, lo);
+	gather(b + 4, hi);
+	for (int k = 0; k < 4; k++)
+	{
+		e[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(lo[k].value), hi[k].value, 1);
+	}
+}
+inline void gather(const taabb3<float>* b, f32x8* e)
+{
+	f32x4 lo[6];
+	f32x4 hi[6];
+	gather(b, lo);
+	gather(b + 4, hi);
+	for (int k = 0; k < 6; k++)
+	{
+		e[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(lo[k].value), hi[k].value, 1);
+	}
+}
+#endif
+
+}
+
+#if defined(GMATH_SSE41)
+inline taabb2<float> merge(const taabb2<float>& a, const taabb2<float>& b)
+{
+	__m128 x = _mm_loadu_ps(&a.min.x);
+	__m128 y = _mm_loadu_ps(&b.min.x);
+	taabb2<float> r;
+	_mm_storeu_ps(&r.min.x, _mm_blend_ps(_mm_min_ps(x, y), _mm_max_ps(x, y), 0xC));
+	return r;
+}
+inline taabb2<float> intersection(const taabb2<float>& a, const taabb2<float>& b)
+{
+	__m128 x = _mm_loadu_ps(&a.min.x);
+	__m128 y = _mm_loadu_ps(&b.min.x);
+	taabb2<float> r;
+	_mm_storeu_ps(&r.min.x, _mm_blend_ps(_mm_max_ps(x, y), _mm_min_ps(x, y), 0xC));
+	return r;
+}
+inline bool overlaps(const taabb2<float>& a, const taabb2<float>& b)
+{
+	__m128 y = _mm_loadu_ps(&b.min.x);
+	return simd::within(_mm_loadu_ps(&a.min.x), _mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+inline bool contains(const taabb2<float>& b, const tvec2<float>& p)
+{
+	__m128 x = _mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)&p));
+	return simd::within(_mm_loadu_ps(&b.min.x), _mm_movelh_ps(x, x));
+}
+inline bool contains(const taabb2<float>& a, const taabb2<float>& b)
+{
+	return simd::within(_mm_loadu_ps(&a.min.x), _mm_loadu_ps(&b.min.x));
+}
+
+inline taabb3<float> merge(const taabb3<float>& a, const taabb3<float>& b)
+{
+	__m128 a0, a1, b0, b1;
+	simd::load(a, a0, a1);
+	simd::load(b, b0, b1);
+	taabb3<float> r;
+	simd::store(r, _mm_min_ps(a0, b0), _mm_max_ps(a1, b1));
+	return r;
+}
+inline taabb3<float> intersection(const taabb3<float>& a, const taabb3<float>& b)
+{
+	__m128 a0, a1, b0, b1;
+	simd::load(a, a0, a1);
+	simd::load(b, b0, b1);
+	taabb3<float> r;
+	simd::store(r, _mm_max_ps(a0, b0), _mm_min_ps(a1, b1));
+	return r;
+}
+inline bool overlaps(const taabb3<float>& a, const taabb3<float>& b)
+{
+	__m128 a0, a1, b0, b1;
+	simd::load(a, a0, a1);
+	simd::load(b, b0, b1);
+	return (_mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(a0, b1), _mm_cmple_ps(b0, a1))) & 7) == 7;
+}
+inline bool contains(const taabb3<float>& b, const tvec3<float>& p)
+{
+	__m128 b0, b1;
+	simd::load(b, b0, b1);
+	__m128 x = native::load3(p);
+	return (_mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(b0, x), _mm_cmple_ps(x, b1))) & 7) == 7;
+}
+inline bool contains(const taabb3<float>& a, const taabb3<float>& b)
+{
+	__m128 a0, a1, b0, b1;
+	simd::load(a, a0, a1);
+	simd::load(b, b0, b1);
+	return (_mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(a0, b0), _mm_cmple_ps(b1, a1))) & 7) == 7;
+}
+inline float area(const taabb3<float>& b)
+{
+	__m128 b0, b1;
+	simd::load(b, b0, b1);
+	__m128 d = _mm_sub_ps(b1, b0);
+	if ((_mm_movemask_ps(_mm_cmplt_ps(d, _mm_setzero_ps())) & 7) != 0)
+	{
+		return 0.0f;
+	}
+
+	// xy + yz + zx in lane 0
+	return 2.0f * _mm_cvtss_f32(_mm_dp_ps(d, _mm_shuffle_ps(d, d, _MM_SHUFFLE(3, 0, 2, 1)), 0x71));
+}
+inline taabb3<float> transform(const tmat4x4<float>& m, const taabb3<float>& b)
+{
+	if (empty(b))
+	{
+		return b;
+	}
+
+	__m128 b0, b1;
+	simd::load(b, b0, b1);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 sign = _mm_set1_ps(-0.0f);
+	__m128 c = _mm_mul_ps(_mm_add_ps(b0, b1), half);
+	__m128 e = _mm_mul_ps(_mm_sub_ps(b1, b0), half);
+	__m128 c0 = simd::column(m, 0);
+	__m128 c1 = simd::column(m, 1);
+	__m128 c2 = simd::column(m, 2);
+	__m128 x = simd::madd(c0, _mm_shuffle_ps(c, c, _MM_SHUFFLE(0, 0, 0, 0)), simd::column(m, 3));
+	x = simd::madd(c1, _mm_shuffle_ps(c, c, _MM_SHUFFLE(1, 1, 1, 1)), x);
+	x = simd::madd(c2, _mm_shuffle_ps(c, c, _MM_SHUFFLE(2, 2, 2, 2)), x);
+	__m128 y = _mm_mul_ps(_mm_andnot_ps(sign, c0), _mm_shuffle_ps(e, e, _MM_SHUFFLE(0, 0, 0, 0)));
+	y = simd::madd(_mm_andnot_ps(sign, c1), _mm_shuffle_ps(e, e, _MM_SHUFFLE(1, 1, 1, 1)), y);
+	y = simd::madd(_mm_andnot_ps(sign, c2), _mm_shuffle_ps(e, e, _MM_SHUFFLE(2, 2, 2, 2)), y);
+
+	taabb3<float> r;
+	simd::store(r, _mm_sub_ps(x, y), _mm_add_ps(x, y));
+	return r;
+}
+#endif
+
+namespace batch
+{
+
+template <typename L, typename T> inline typename L::mask overlap(const L* box, const taabb2<T>* boxes)
+{
+	L b[4];
+	simd::gather(boxes, b);
+	return (box[0] <= b[2]) & (b[0] <= box[2]) & (box[1] <= b[3]) & (b[1] <= box[3]);
+}
+template <typename L, typename T> inline typename L::mask overlap(const L* box, const taabb3<T>* boxes)
+{
+	L b[6];
+	simd::gather(boxes, b);
+	typename L::mask m = (box[0] <= b[3]) & (b[0] <= box[3]);
+	m = m & (box[1] <= b[4]) & (b[1] <= box[4]);
+	return m & (box[2] <= b[5]) & (b[2] <= box[5]);
+}
+
+template <typename L, typename B> inline void overlaps(const B& box, const B* boxes, unsigned int* result, const size_t count)
+{
+	L b[6];
+	simd::broadcast(box, b);
+
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		unsigned int word = 0;
+		for (int k = 0; k < 32; k += L::width)
+		{
+			word |= (unsigned int)simd::bits(overlap<L>(b, boxes + i + k)) << k;
+		}
+		result[i >> 5] = word;
+	}
+	if (i < count)
+	{
+		unsigned int word = 0;
+		for (int k = 0; i + k < count; k++)
+		{
+			word |= gmath::overlaps(box, boxes[i + k]) ? (1u << k) : 0u;
+		}
+		result[i >> 5] = word;
+	}
+}
+
+}
+
+// Bit (i % 32) of result[i / 32] is set when boxes[i] overlaps box, the layout of cullBoxes, for
+// broadphase and region queries over many boxes. Empty boxes never overlap anything.
+template <typename T> inline void overlaps(const taabb2<T>& box, const taabb2<T>* boxes, unsigned int* result, const size_t count)
+{
+	batch::overlaps<typename simd::widest<T>::type>(box, boxes, result, count);
+}
+template <typename T> inline void overlaps(const taabb3<T>& box, const taabb3<T>* boxes, unsigned int* result, const size_t count)
+{
+	batch::overlaps<typename simd::widest<T>::type>(box, boxes, result, count);
+}
+
+template <typename T> inline void overlaps(const taabb2<T>& box, const taabb2<T>* boxes, unsigned int* result, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		overlaps(box, boxes + begin, result + (begin >> 5), end - begin);
+	});
+}
+template <typename T> inline void overlaps(const taabb3<T>& box, const taabb3<T>* boxes, unsigned int* result, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		overlaps(box, boxes + begin, result + (begin >> 5), end - begin);
+	});
+}
+
+typedef taabb2<float> aabb2;
+typedef taabb3<float> aabb3;
+#endif
+
+}
+
+#endif
\ No newline at end of file
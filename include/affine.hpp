@@ -0,0 +1,190 @@
+#ifndef AFFINE_H
+#define AFFINE_H
+
+#include <gmath.hpp>
+
+namespace gmath
+{
+
+#if !(defined(taffine3) || defined(affine3))
+template <typename T> struct taffine3
+{
+
+	inline GMATH_CONSTEXPR taffine3()
+	{
+		this->_columns[0] = tvec3<T>((T)1, (T)0, (T)0);
+		this->_columns[1] = tvec3<T>((T)0, (T)1, (T)0);
+		this->_columns[2] = tvec3<T>((T)0, (T)0, (T)1);
+		this->_columns[3] = tvec3<T>((T)0, (T)0, (T)0);
+	}
+	inline GMATH_CONSTEXPR taffine3(
+		const tvec3<T>& v0, const tvec3<T>& v1, const tvec3<T>& v2, const tvec3<T>& v3
+		)
+	{
+		this->_columns[0] = v0;
+		this->_columns[1] = v1;
+		this->_columns[2] = v2;
+		this->_columns[3] = v3;
+	}
+	inline GMATH_CONSTEXPR taffine3(const tmat3x3<T>& m, const tvec3<T>& translation)
+	{
+		this->_columns[0] = m._columns[0];
+		this->_columns[1] = m._columns[1];
+		this->_columns[2] = m._columns[2];
+		this->_columns[3] = translation;
+	}
+	inline GMATH_CONSTEXPR taffine3(const tmat4x4<T>& m)
+	{
+		this->_columns[0] = tvec3<T>(m._columns[0].x, m._columns[0].y, m._columns[0].z);
+		this->_columns[1] = tvec3<T>(m._columns[1].x, m._columns[1].y, m._columns[1].z);
+		this->_columns[2] = tvec3<T>(m._columns[2].x, m._columns[2].y, m._columns[2].z);
+		this->_columns[3] = tvec3<T>(m._columns[3].x, m._columns[3].y, m._columns[3].z);
+	}
+
+	inline GMATH_CONSTEXPR const int columns() const
+	{
+		return 4;
+	}
+	inline GMATH_CONSTEXPR const int rows() const
+	{
+		return 3;
+	}
+
+	inline operator T*() const
+	{
+		return (T*)(this->_columns[0]);
+	}
+	inline GMATH_CONSTEXPR operator tmat4x4<T>() const
+	{
+		return tmat4x4<T>(
+			tvec4<T>(this->_columns[0], (T)0),
+			tvec4<T>(this->_columns[1], (T)0),
+			tvec4<T>(this->_columns[2], (T)0),
+			tvec4<T>(this->_columns[3], (T)1)
+			);
+	}
+	inline void operator*=(const taffine3<T>& m)
+	{
+		*this = *this * m;
+	}
+	inline tvec3<T>& operator[](const int index)
+	{
+		return this->_columns[index % this->columns()];
+	}
+	inline const tvec3<T>& operator[](const int index) const
+	{
+		return this->_columns[index % this->columns()];
+	}
+
+	tvec3<T> _columns[4];
+
+};
+
+template <typename T> inline tmat3x3<T> linear(const taffine3<T>& m)
+{
+	return tmat3x3<T>(m._columns[0], m._columns[1], m._columns[2]);
+}
+template <typename T> inline tvec3<T> translation(const taffine3<T>& m)
+{
+	return m._columns[3];
+}
+
+template <typename T> inline tvec3<T> transformPoint(const taffine3<T>& m, const tvec3<T>& v)
+{
+	return (m._columns[0] * v.x) + (m._columns[1] * v.y) + (m._columns[2] * v.z) + m._columns[3];
+}
+template <typename T> inline tvec3<T> transformVector(const taffine3<T>& m, const tvec3<T>& v)
+{
+	return (m._columns[0] * v.x) + (m._columns[1] * v.y) + (m._columns[2] * v.z);
+}
+
+template <typename T> inline T determinate(const taffine3<T>& m)
+{
+	const tvec3<T>& c0 = m._columns[0];
+	const tvec3<T>& c1 = m._columns[1];
+	const tvec3<T>& c2 = m._columns[2];
+	return
+		(c0.x * ((c1.y * c2.z) - (c1.z * c2.y))) +
+		(c0.y * ((c1.z * c2.x) - (c1.x * c2.z))) +
+		(c0.z * ((c1.x * c2.y) - (c1.y * c2.x)));
+}
+
+// Any invertible transform, by cofactors of the linear part; they are written out because cross()
+// normalizes its result.
+template <typename T> inline taffine3<T> inverse(const taffine3<T>& m)
+{
+	const tvec3<T>& c0 = m._columns[0];
+	const tvec3<T>& c1 = m._columns[1];
+	const tvec3<T>& c2 = m._columns[2];
+	tvec3<T> r0((c1.y * c2.z) - (c1.z * c2.y), (c1.z * c2.x) - (c1.x * c2.z), (c1.x * c2.y) - (c1.y * c2.x));
+	tvec3<T> r1((c2.y * c0.z) - (c2.z * c0.y), (c2.z * c0.x) - (c2.x * c0.z), (c2.x * c0.y) - (c2.y * c0.x));
+	tvec3<T> r2((c0.y * c1.z) - (c0.z * c1.y), (c0.z * c1.x) - (c0.x * c1.z), (c0.x * c1.y) - (c0.y * c1.x));
+	T determinant = dot(c0, r0);
+	r0 /= determinant;
+	r1 /= determinant;
+	r2 /= determinant;
+
+	taffine3<T> inverse(
+		tvec3<T>(r0.x, r1.x, r2.x),
+		tvec3<T>(r0.y, r1.y, r2.y),
+		tvec3<T>(r0.z, r1.z, r2.z),
+		tvec3<T>((T)0, (T)0, (T)0)
+		);
+	inverse._columns[3] = -transformVector(inverse, m._columns[3]);
+	return inverse;
+}
+// Only for mutually orthogonal columns, a rotation of an axis scale (m = T * R * S): the transpose of
+// the linear part with each row divided by the squared column length. A scale applied after the
+// rotation (m = S * R) shears the columns and gives a wrong result; use inverse() for those.
+template <typename T> inline taffine3<T> inverseOrthogonal(const taffine3<T>& m)
+{
+	tvec3<T> c0 = m._columns[0] / dot(m._columns[0], m._columns[0]);
+	tvec3<T> c1 = m._columns[1] / dot(m._columns[1], m._columns[1]);
+	tvec3<T> c2 = m._columns[2] / dot(m._columns[2], m._columns[2]);
+
+	taffine3<T> inverse(
+		tvec3<T>(c0.x, c1.x, c2.x),
+		tvec3<T>(c0.y, c1.y, c2.y),
+		tvec3<T>(c0.z, c1.z, c2.z),
+		tvec3<T>((T)0, (T)0, (T)0)
+		);
+	inverse._columns[3] = -transformVector(inverse, m._columns[3]);
+	return inverse;
+}
+// Only for rotations and translations, where the inverse of the linear part is its transpose.
+template <typename T> inline taffine3<T> inverseRigid(const taffine3<T>& m)
+{
+	taffine3<T> inverse(
+		tvec3<T>(m._columns[0].x, m._columns[1].x, m._columns[2].x),
+		tvec3<T>(m._columns[0].y, m._columns[1].y, m._columns[2].y),
+		tvec3<T>(m._columns[0].z, m._columns[1].z, m._columns[2].z),
+		tvec3<T>((T)0, (T)0, (T)0)
+		);
+	inverse._columns[3] = -transformVector(inverse, m._columns[3]);
+	return inverse;
+}
+
+template <typename T> inline taffine3<T> operator*(const taffine3<T>& m0, const taffine3<T>& m1)
+{
+	return taffine3<T>(
+		transformVector(m0, m1._columns[0]),
+		transformVector(m0, m1._columns[1]),
+		transformVector(m0, m1._columns[2]),
+		transformPoint(m0, m1._columns[3])
+		);
+}
+template <typename T> inline tvec3<T> operator*(const taffine3<T>& m, const tvec3<T>& v)
+{
+	return transformPoint(m, v);
+}
+template <typename T> inline tvec4<T> operator*(const taffine3<T>& m, const tvec4<T>& v)
+{
+	return tvec4<T>((m._columns[0] * v.x) + (m._columns[1] * v.y) + (m._columns[2] * v.z) + (m._columns[3] * v.w), v.w);
+}
+
+typedef taffine3<float> affine3;
+#endif
+
+}
+
+#endif
\ No newline at end of file
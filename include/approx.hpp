@@ -0,0 +1,287 @@
+#ifndef APPROX_H
+#define APPROX_H
+
+#include <gmath.hpp>
+
+namespace gmath
+{
+
+namespace precision
+{
+
+template <int L> struct policy {};
+typedef policy<0> exact;
+typedef policy<1> fast;
+typedef policy<2> fastest;
+
+}
+
+// Maximum error against the correctly rounded float result, as reported by bench/approx.
+// An approximation is only kept where it measures faster than libm; everywhere else the
+// policy forwards to the exact function.
+//
+//   rsqrt      fast     rsqrtss + 1 Newton step (SSE)       3.5 ulp
+//              fastest  rsqrtss (SSE)                       4833 ulp
+//                       bit estimate + 1 Newton step        28365 ulp
+//   normalize  fast     as rsqrt (SSE)                      4 ulp per component
+//              fastest  as rsqrt (SSE)                      5224 ulp per component
+//   sin/cos    fastest  degree 5/4 polynomial               208 ulp
+//   tan        fastest  as sin / cos                        261 ulp
+//
+// sqrt stays exact at every level: sqrtss, and sqrtps once the compiler vectorizes a
+// loop, beat x * rsqrt(x). The trig reduction is accurate for |x| < 8192.
+
+template <typename T, int L> inline T rsqrt(const T x, const precision::policy<L>)
+{
+	return (T)1 / (T)::sqrt(x);
+}
+#if defined(GMATH_SSE41)
+inline float rsqrt(const float x, const precision::fast)
+{
+	float r = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+	return r * (1.5f - (0.5f * x * r * r));
+}
+#endif
+inline float rsqrt(const float x, const precision::fastest)
+{
+#if defined(GMATH_SSE41)
+	return _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+#else
+	union { float f; unsigned int i; } u;
+	u.f = x;
+	u.i = 0x5f375a86u - (u.i >> 1);
+	float r = u.f;
+	return r * (1.5f - (0.5f * x * r * r));
+#endif
+}
+
+template <typename T, int L> inline T sqrt(const T x, const precision::policy<L>)
+{
+	return (T)::sqrt(x);
+}
+
+template <typename T, int L> inline void sincos(const T x, T& s, T& c, const precision::policy<L>)
+{
+	s = (T)::sin(x);
+	c = (T)::cos(x);
+}
+// Branchless so that loops over it stay straight-line: the quadrant swaps sin and cos
+// on odd k and flips the signs through the sign bit.
+inline void sincos(const float x, float& s, float& c, const precision::fastest)
+{
+	float j = ((x * 0.636619772f) + 12582912.0f) - 12582912.0f;
+	unsigned int k = (unsigned int)(int)j;
+	float r = ((x - (j * 1.5703125f)) - (j * 4.837512969970703125e-4f)) - (j * 7.54978995489188216e-8f);
+	float z = r * r;
+
+	float sr = (((8.164674286e-3f * z) - 1.666346105e-1f) * z * r) + r;
+	float cr = (((4.048939201e-2f * z) - 4.997764819e-1f) * z) + 1.0f;
+
+	union { float f; unsigned int i; } us, uc;
+	us.f = (k & 1) ? cr : sr;
+	uc.f = (k & 1) ? sr : cr;
+	us.i ^= (k & 2) << 30;
+	uc.i ^= ((k + 1) & 2) << 30;
+	s = us.f;
+	c = uc.f;
+}
+
+template <typename T, int L> inline T sin(const T x, const precision::policy<L>)
+{
+	return (T)::sin(x);
+}
+template <typename T, int L> inline T cos(const T x, const precision::policy<L>)
+{
+	return (T)::cos(x);
+}
+template <typename T, int L> inline T tan(const T x, const precision::policy<L>)
+{
+	return (T)::tan(x);
+}
+inline float sin(const float x, const precision::fastest p)
+{
+	float s, c;
+	sincos(x, s, c, p);
+	return s;
+}
+inline float cos(const float x, const precision::fastest p)
+{
+	float s, c;
+	sincos(x, s, c, p);
+	return c;
+}
+inline float tan(const float x, const precision::fastest p)
+{
+	float s, c;
+	sincos(x, s, c, p);
+	return s / c;
+}
+
+template <typename T, int L> inline T magnitude(const tvec2<T>& v, const precision::policy<L> p)
+{
+	return sqrt(dot(v, v), p);
+}
+template <typename T, int L> inline T magnitude(const tvec3<T>& v, const precision::policy<L> p)
+{
+	return sqrt(dot(v, v), p);
+}
+template <typename T, int L> inline T magnitude(const tvec4<T>& v, const precision::policy<L> p)
+{
+	return sqrt(dot(v, v), p);
+}
+template <typename T> inline T magnitude(const tvec2<T>& v, const precision::exact)
+{
+	return magnitude(v);
+}
+template <typename T> inline T magnitude(const tvec3<T>& v, const precision::exact)
+{
+	return magnitude(v);
+}
+template <typename T> inline T magnitude(const tvec4<T>& v, const precision::exact)
+{
+	return magnitude(v);
+}
+
+template <typename T, int L> inline T distance(const tvec2<T>& v0, const tvec2<T>& v1, const precision::policy<L> p)
+{
+	return magnitude(v1 - v0, p);
+}
+template <typename T, int L> inline T distance(const tvec3<T>& v0, const tvec3<T>& v1, const precision::policy<L> p)
+{
+	return magnitude(v1 - v0, p);
+}
+template <typename T, int L> inline T distance(const tvec4<T>& v0, const tvec4<T>& v1, const precision::policy<L> p)
+{
+	return magnitude(v1 - v0, p);
+}
+
+template <typename T, int L> inline tvec2<T> normalize(const tvec2<T>& v, const precision::policy<L>)
+{
+	return normalize(v);
+}
+template <typename T, int L> inline tvec3<T> normalize(const tvec3<T>& v, const precision::policy<L>)
+{
+	return normalize(v);
+}
+template <typename T, int L> inline tvec4<T> normalize(const tvec4<T>& v, const precision::policy<L>)
+{
+	return normalize(v);
+}
+
+#if defined(GMATH_SSE41)
+inline tvec2<float> normalize(const tvec2<float>& v, const precision::fast p)
+{
+	float d = dot(v, v);
+	return d > 0.0f ? v * rsqrt(d, p) : tvec2<float>();
+}
+inline tvec2<float> normalize(const tvec2<float>& v, const precision::fastest p)
+{
+	float d = dot(v, v);
+	return d > 0.0f ? v * rsqrt(d, p) : tvec2<float>();
+}
+inline tvec3<float> normalize(const tvec3<float>& v, const precision::fast p)
+{
+	float d = dot(v, v);
+	return d > 0.0f ? v * rsqrt(d, p) : tvec3<float>();
+}
+inline tvec3<float> normalize(const tvec3<float>& v, const precision::fastest p)
+{
+	float d = dot(v, v);
+	return d > 0.0f ? v * rsqrt(d, p) : tvec3<float>();
+}
+inline tvec4<float> normalize(const tvec4<float>& v, const precision::fast)
+{
+	__m128 x = simd::load(v);
+	__m128 d = _mm_dp_ps(x, x, 0xFF);
+	__m128 r = _mm_rsqrt_ps(d);
+	r = _mm_mul_ps(r, _mm_sub_ps(_mm_set1_ps(1.5f), _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), d), _mm_mul_ps(r, r))));
+	return simd::store(_mm_and_ps(_mm_mul_ps(x, r), _mm_cmpgt_ps(d, _mm_setzero_ps())));
+}
+inline tvec4<float> normalize(const tvec4<float>& v, const precision::fastest)
+{
+	__m128 x = simd::load(v);
+	__m128 d = _mm_dp_ps(x, x, 0xFF);
+	return simd::store(_mm_and_ps(_mm_mul_ps(x, _mm_rsqrt_ps(d)), _mm_cmpgt_ps(d, _mm_setzero_ps())));
+}
+#endif
+
+template <typename T, int L> inline tvec3<T> cross(const tvec3<T>& v0, const tvec3<T>& v1, const precision::policy<L> p)
+{
+	return normalize(crossUnnormalized(v0, v1), p);
+}
+
+template <typename T, int L> inline tmat3x3<T> rotate2d(const T theta, const precision::policy<L> p)
+{
+	T s, c;
+	sincos(radians<T>(theta), s, c, p);
+
+	return tmat3x3<T>(
+		c, -s, (T)0,
+		s, c, (T)0,
+		(T)0, (T)0, (T)1
+		);
+}
+template <typename T, int L> inline tmat4x4<T> rotateX(const T theta, const precision::policy<L> p)
+{
+	T s, c;
+	sincos(radians<T>(theta), s, c, p);
+
+	return tmat4x4<T>(
+		(T)1, (T)0, (T)0, (T)0,
+		(T)0, c, -s, (T)0,
+		(T)0, s, c, (T)0,
+		(T)0, (T)0, (T)0, (T)1
+		);
+}
+template <typename T, int L> inline tmat4x4<T> rotateY(const T theta, const precision::policy<L> p)
+{
+	T s, c;
+	sincos(radians<T>(theta), s, c, p);
+
+	return tmat4x4<T>(
+		c, (T)0, s, (T)0,
+		(T)0, (T)1, (T)0, (T)0,
+		-s, (T)0, c, (T)0,
+		(T)0, (T)0, (T)0, (T)1
+		);
+}
+template <typename T, int L> inline tmat4x4<T> rotateZ(const T theta, const precision::policy<L> p)
+{
+	T s, c;
+	sincos(radians<T>(theta), s, c, p);
+
+	return tmat4x4<T>(
+		c, -s, (T)0, (T)0,
+		s, c, (T)0, (T)0,
+		(T)0, (T)0, (T)1, (T)0,
+		(T)0, (T)0, (T)0, (T)1
+		);
+}
+template <typename T, int L> inline tmat4x4<T> rotate(const T theta, const tvec3<T>& axis, const precision::policy<L> p)
+{
+	T s, c;
+	sincos(radians<T>(theta), s, c, p);
+	tvec3<T> axis_ = normalize(axis, p);
+	tvec3<T> temp = ((T)1 - c) * axis_;
+
+	return tmat4x4<T>(
+		c + (temp.x * axis_.x), (temp.y * axis_.x) - (s * axis_.z), (temp.z * axis_.x) + (s * axis_.y), (T)0,
+		(temp.x * axis_.y) + (s * axis_.z), c + (temp.y * axis_.y), (temp.z * axis_.y) - (s * axis_.x), (T)0,
+		(temp.x * axis_.z) - (s * axis_.y), (temp.y * axis_.z) + (s * axis_.x), c + (temp.z * axis_.z), (T)0,
+		(T)0, (T)0, (T)0, (T)1
+		);
+}
+template <typename T, int L> inline tmat4x4<T> perspective(const T fov, const T aspect, const T nearZ, const T farZ, const precision::policy<L> p)
+{
+	T range = tan(radians<T>(fov) / (T)2, p);
+	return tmat4x4<T>(
+		(T)1 / (aspect * range), (T)0, (T)0, (T)0,
+		(T)0, (T)1 / range, (T)0, (T)0,
+		(T)0, (T)0, -(farZ + nearZ) / (farZ - nearZ), -((T)2 * farZ * nearZ) / (farZ - nearZ),
+		(T)0, (T)0, (T)-1, (T)0
+		);
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -144,6 +144,14 @@ public:
 			this->_count = 0;
 		}
 	}
+	void reset()
+	{
+		if (this->_count > 0 && this->_data != 0)
+		{
+			memset(this->_data, 0, sizeof(T) * this->_count);
+			this->_count = 0;
+		}
+	}
 
 	void resize(const int length)
 	{
@@ -0,0 +1,584 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+#include <gmath.hpp>
+
+#if !defined(GMATH_BATCH_GRAIN)
+#define GMATH_BATCH_GRAIN 4096
+#endif
+
+namespace gmath
+{
+
+template <typename F> inline void parallel(const size_t count, unsigned int threads, const F& kernel)
+{
+	if (threads == 0)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+
+	size_t chunks = count / GMATH_BATCH_GRAIN;
+	if (chunks < (size_t)threads)
+	{
+		threads = (unsigned int)chunks;
+	}
+
+	if (threads < 2)
+	{
+		kernel((size_t)0, count);
+		return;
+	}
+
+	size_t step = (((count + threads - 1) / threads) + 63) & ~(size_t)63;
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	size_t begin = 0;
+	try
+	{
+		for (; workers.size() < threads - 1 && begin + step < count; begin += step)
+		{
+			workers.push_back(std::thread(kernel, begin, begin + step));
+		}
+
+		kernel(begin, count);
+	}
+	catch (...)
+	{
+		// a thread that failed to start or a throwing kernel still leaves the others to finish
+		for (size_t i = 0; i < workers.size(); i++)
+		{
+			workers[i].join();
+		}
+		throw;
+	}
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+}
+
+template <typename T> inline void transformPoints(const tmat4x4<T>& m, const tvec3<T>* in, tvec3<T>* out, const size_t count)
+{
+	const tvec4<T> c0 = m._columns[0];
+	const tvec4<T> c1 = m._columns[1];
+	const tvec4<T> c2 = m._columns[2];
+	const tvec4<T> c3 = m._columns[3];
+	for (size_t i = 0; i < count; i++)
+	{
+		const T x = in[i].x;
+		const T y = in[i].y;
+		const T z = in[i].z;
+		out[i].x = (c0.x * x) + (c1.x * y) + (c2.x * z) + c3.x;
+		out[i].y = (c0.y * x) + (c1.y * y) + (c2.y * z) + c3.y;
+		out[i].z = (c0.z * x) + (c1.z * y) + (c2.z * z) + c3.z;
+	}
+}
+template <typename T> inline void transformVectors(const tmat4x4<T>& m, const tvec3<T>* in, tvec3<T>* out, const size_t count)
+{
+	const tvec4<T> c0 = m._columns[0];
+	const tvec4<T> c1 = m._columns[1];
+	const tvec4<T> c2 = m._columns[2];
+	for (size_t i = 0; i < count; i++)
+	{
+		const T x = in[i].x;
+		const T y = in[i].y;
+		const T z = in[i].z;
+		out[i].x = (c0.x * x) + (c1.x * y) + (c2.x * z);
+		out[i].y = (c0.y * x) + (c1.y * y) + (c2.y * z);
+		out[i].z = (c0.z * x) + (c1.z * y) + (c2.z * z);
+	}
+}
+template <typename T> inline void transformProjected(const tmat4x4<T>& m, const tvec3<T>* in, tvec3<T>* out, const size_t count)
+{
+	const tvec4<T> c0 = m._columns[0];
+	const tvec4<T> c1 = m._columns[1];
+	const tvec4<T> c2 = m._columns[2];
+	const tvec4<T> c3 = m._columns[3];
+	for (size_t i = 0; i < count; i++)
+	{
+		const T x = in[i].x;
+		const T y = in[i].y;
+		const T z = in[i].z;
+		const T w = (c0.w * x) + (c1.w * y) + (c2.w * z) + c3.w;
+		out[i].x = ((c0.x * x) + (c1.x * y) + (c2.x * z) + c3.x) / w;
+		out[i].y = ((c0.y * x) + (c1.y * y) + (c2.y * z) + c3.y) / w;
+		out[i].z = ((c0.z * x) + (c1.z * y) + (c2.z * z) + c3.z) / w;
+	}
+}
+template <typename T> inline void transform4(const tmat4x4<T>& m, const tvec4<T>* in, tvec4<T>* out, const size_t count)
+{
+	const tvec4<T> c0 = m._columns[0];
+	const tvec4<T> c1 = m._columns[1];
+	const tvec4<T> c2 = m._columns[2];
+	const tvec4<T> c3 = m._columns[3];
+	for (size_t i = 0; i < count; i++)
+	{
+		const T x = in[i].x;
+		const T y = in[i].y;
+		const T z = in[i].z;
+		const T w = in[i].w;
+		out[i].x = (c0.x * x) + (c1.x * y) + (c2.x * z) + (c3.x * w);
+		out[i].y = (c0.y * x) + (c1.y * y) + (c2.y * z) + (c3.y * w);
+		out[i].z = (c0.z * x) + (c1.z * y) + (c2.z * z) + (c3.z * w);
+		out[i].w = (c0.w * x) + (c1.w * y) + (c2.w * z) + (c3.w * w);
+	}
+}
+template <typename T> inline void nlerp(const tquat<T>* q0, const tquat<T>* q1, const T* t, tquat<T>* out, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = nlerp(q0[i], q1[i], t[i]);
+	}
+}
+template <typename T> inline void slerp(const tquat<T>* q0, const tquat<T>* q1, const T* t, tquat<T>* out, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = slerp(q0[i], q1[i], t[i]);
+	}
+}
+template <typename T> inline void decompose(const tmat4x4<T>* m, tvec3<T>* translation, tquat<T>* rotation, tvec3<T>* scale, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		decompose(m[i], translation[i], rotation[i], scale[i]);
+	}
+}
+// Moves positions kept in double to be relative to origin, usually the camera, then narrows them
+// to float. Subtracting first keeps the precision where it matters, close to the origin.
+template <typename T> inline void rebase(const tvec3<T>& origin, const tvec3<T>* in, tvec3<float>* out, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = tvec3<float>((float)(in[i].x - origin.x), (float)(in[i].y - origin.y), (float)(in[i].z - origin.z));
+	}
+}
+
+namespace simd
+{
+
+template <typename L, typename T> inline void gather(const tvec4<T>* v, L* e)
+{
+	T x[L::width];
+	for (int k = 0; k < 4; k++)
+	{
+		for (int j = 0; j < L::width; j++)
+		{
+			x[j] = ((const T*)(v + j))[k];
+		}
+
+		e[k] = L::load(x);
+	}
+}
+template <typename L, typename T> inline void gather(const tvec3<T>* v, L* e)
+{
+	T x[L::width];
+	for (int k = 0; k < 3; k++)
+	{
+		for (int j = 0; j < L::width; j++)
+		{
+			x[j] = ((const T*)(v + j))[k];
+		}
+
+		e[k] = L::load(x);
+	}
+}
+
+}
+
+#if defined(GMATH_SSE41)
+// The float kernels that dispatch selects between at run time, built here once more for the
+// instruction set this translation unit targets. The double overloads ahead of them let
+// inverseLanes run one double matrix per lane as well.
+namespace native
+{
+#if defined(GMATH_AVX)
+inline __m256d add(const __m256d a, const __m256d b) { return _mm256_add_pd(a, b); }
+inline __m256d sub(const __m256d a, const __m256d b) { return _mm256_sub_pd(a, b); }
+inline __m256d mul(const __m256d a, const __m256d b) { return _mm256_mul_pd(a, b); }
+inline __m256d div(const __m256d a, const __m256d b) { return _mm256_div_pd(a, b); }
+inline __m256d magnitude(const __m256d a) { return _mm256_and_pd(a, _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFll))); }
+inline __m256d lessEqual(const __m256d a, const __m256d b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+inline __m256d select(const __m256d m, const __m256d a, const __m256d b) { return _mm256_blendv_pd(b, a, m); }
+inline int bits(const __m256d m) { return _mm256_movemask_pd(m); }
+inline void fill(__m256d& x, const double v) { x = _mm256_set1_pd(v); }
+
+inline void transpose(__m256d& r0, __m256d& r1, __m256d& r2, __m256d& r3)
+{
+	__m256d t0 = _mm256_unpacklo_pd(r0, r1);
+	__m256d t1 = _mm256_unpackhi_pd(r0, r1);
+	__m256d t2 = _mm256_unpacklo_pd(r2, r3);
+	__m256d t3 = _mm256_unpackhi_pd(r2, r3);
+	r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+	r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+	r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+	r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+inline void gather(const tmat4x4<double>* m, __m256d* e)
+{
+	for (int c = 0; c < 4; c++)
+	{
+		__m256d r0 = simd::column(m[0], c);
+		__m256d r1 = simd::column(m[1], c);
+		__m256d r2 = simd::column(m[2], c);
+		__m256d r3 = simd::column(m[3], c);
+		transpose(r0, r1, r2, r3);
+		e[(c * 4) + 0] = r0;
+		e[(c * 4) + 1] = r1;
+		e[(c * 4) + 2] = r2;
+		e[(c * 4) + 3] = r3;
+	}
+}
+inline void scatter(const __m256d* e, tmat4x4<double>* m)
+{
+	for (int c = 0; c < 4; c++)
+	{
+		__m256d r0 = e[(c * 4) + 0];
+		__m256d r1 = e[(c * 4) + 1];
+		__m256d r2 = e[(c * 4) + 2];
+		__m256d r3 = e[(c * 4) + 3];
+		transpose(r0, r1, r2, r3);
+		_mm256_storeu_pd((double*)&m[0]._columns[c], r0);
+		_mm256_storeu_pd((double*)&m[1]._columns[c], r1);
+		_mm256_storeu_pd((double*)&m[2]._columns[c], r2);
+		_mm256_storeu_pd((double*)&m[3]._columns[c], r3);
+	}
+}
+#endif
+
+#define GMATH_KERNEL_SSE41
+#if defined(GMATH_AVX)
+#define GMATH_KERNEL_AVX
+#endif
+#if defined(GMATH_FMA)
+#define GMATH_KERNEL_FMA
+#endif
+#if defined(GMATH_AVX512)
+#define GMATH_KERNEL_AVX512
+#endif
+#include <kernels.hpp>
+#undef GMATH_KERNEL_AVX512
+#undef GMATH_KERNEL_FMA
+#undef GMATH_KERNEL_AVX
+#undef GMATH_KERNEL_SSE41
+}
+
+namespace simd
+{
+
+inline void gather(const tvec4<float>* v, f32x4* e)
+{
+	__m128 r0 = load(v[0]);
+	__m128 r1 = load(v[1]);
+	__m128 r2 = load(v[2]);
+	__m128 r3 = load(v[3]);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	e[0] = r0;
+	e[1] = r1;
+	e[2] = r2;
+	e[3] = r3;
+}
+inline void gather(const tvec3<float>* v, f32x4* e)
+{
+	__m128 r0 = native::load3(v[0]);
+	__m128 r1 = native::load3(v[1]);
+	__m128 r2 = native::load3(v[2]);
+	__m128 r3 = native::load3(v[3]);
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	e[0] = r0;
+	e[1] = r1;
+	e[2] = r2;
+}
+
+#if defined(GMATH_AVX)
+inline void gather(const tvec4<float>* v, f32x8* e)
+{
+	__m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(load(v[0])), load(v[4]), 1);
+	__m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(load(v[1])), load(v[5]), 1);
+	__m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(load(v[2])), load(v[6]), 1);
+	__m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(load(v[3])), load(v[7]), 1);
+	native::transpose(r0, r1, r2, r3);
+	e[0] = r0;
+	e[1] = r1;
+	e[2] = r2;
+	e[3] = r3;
+}
+inline void gather(const tvec3<float>* v, f32x8* e)
+{
+	__m256 r0 = _mm256_insertf128_ps(_mm256_castps128_ps256(native::load3(v[0])), native::load3(v[4]), 1);
+	__m256 r1 = _mm256_insertf128_ps(_mm256_castps128_ps256(native::load3(v[1])), native::load3(v[5]), 1);
+	__m256 r2 = _mm256_insertf128_ps(_mm256_castps128_ps256(native::load3(v[2])), native::load3(v[6]), 1);
+	__m256 r3 = _mm256_insertf128_ps(_mm256_castps128_ps256(native::load3(v[3])), native::load3(v[7]), 1);
+	native::transpose(r0, r1, r2, r3);
+	e[0] = r0;
+	e[1] = r1;
+	e[2] = r2;
+}
+
+inline void gather(const tvec4<double>* v, f64x4* e)
+{
+	__m256d r0 = load(v[0]);
+	__m256d r1 = load(v[1]);
+	__m256d r2 = load(v[2]);
+	__m256d r3 = load(v[3]);
+	native::transpose(r0, r1, r2, r3);
+	e[0] = r0;
+	e[1] = r1;
+	e[2] = r2;
+	e[3] = r3;
+}
+inline void store3(tvec3<double>& v, const __m256d x)
+{
+	_mm_storeu_pd((double*)&v, _mm256_castpd256_pd128(x));
+	_mm_store_sd((double*)&v + 2, _mm256_extractf128_pd(x, 1));
+}
+#endif
+
+}
+
+inline void transformPoints(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	native::transformPoints(m, in, out, count);
+}
+inline void transformVectors(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	native::transformVectors(m, in, out, count);
+}
+inline void transformProjected(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	native::transformProjected(m, in, out, count);
+}
+inline void transform4(const tmat4x4<float>& m, const tvec4<float>* in, tvec4<float>* out, const size_t count)
+{
+	native::transform4(m, in, out, count);
+}
+inline void nlerp(const tquat<float>* q0, const tquat<float>* q1, const float* t, tquat<float>* out, const size_t count)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 sign = _mm_set1_ps(-0.0f);
+	for (size_t i = 0; i < count; i++)
+	{
+		__m128 a = _mm_loadu_ps((const float*)(q0 + i));
+		__m128 b = _mm_loadu_ps((const float*)(q1 + i));
+		__m128 s = _mm_set1_ps(t[i]);
+		__m128 r = simd::madd(b, _mm_xor_ps(s, _mm_and_ps(_mm_dp_ps(a, b, 0xFF), sign)), _mm_mul_ps(a, _mm_sub_ps(one, s)));
+		_mm_storeu_ps((float*)(out + i), _mm_div_ps(r, _mm_sqrt_ps(_mm_dp_ps(r, r, 0xFF))));
+	}
+}
+
+#if defined(GMATH_AVX)
+inline void transformPoints(const tmat4x4<double>& m, const tvec3<double>* in, tvec3<double>* out, const size_t count)
+{
+	const __m256d c0 = simd::column(m, 0);
+	const __m256d c1 = simd::column(m, 1);
+	const __m256d c2 = simd::column(m, 2);
+	const __m256d c3 = simd::column(m, 3);
+	for (size_t i = 0; i < count; i++)
+	{
+		const double* v = (const double*)(in + i);
+		__m256d r = simd::madd(c0, _mm256_broadcast_sd(v), c3);
+		r = simd::madd(c1, _mm256_broadcast_sd(v + 1), r);
+		r = simd::madd(c2, _mm256_broadcast_sd(v + 2), r);
+		simd::store3(out[i], r);
+	}
+}
+inline void transformVectors(const tmat4x4<double>& m, const tvec3<double>* in, tvec3<double>* out, const size_t count)
+{
+	const __m256d c0 = simd::column(m, 0);
+	const __m256d c1 = simd::column(m, 1);
+	const __m256d c2 = simd::column(m, 2);
+	for (size_t i = 0; i < count; i++)
+	{
+		const double* v = (const double*)(in + i);
+		__m256d r = _mm256_mul_pd(c0, _mm256_broadcast_sd(v));
+		r = simd::madd(c1, _mm256_broadcast_sd(v + 1), r);
+		r = simd::madd(c2, _mm256_broadcast_sd(v + 2), r);
+		simd::store3(out[i], r);
+	}
+}
+inline void transformProjected(const tmat4x4<double>& m, const tvec3<double>* in, tvec3<double>* out, const size_t count)
+{
+	const __m256d c0 = simd::column(m, 0);
+	const __m256d c1 = simd::column(m, 1);
+	const __m256d c2 = simd::column(m, 2);
+	const __m256d c3 = simd::column(m, 3);
+	for (size_t i = 0; i < count; i++)
+	{
+		const double* v = (const double*)(in + i);
+		__m256d r = simd::madd(c0, _mm256_broadcast_sd(v), c3);
+		r = simd::madd(c1, _mm256_broadcast_sd(v + 1), r);
+		r = simd::madd(c2, _mm256_broadcast_sd(v + 2), r);
+		__m256d w = _mm256_permute_pd(r, 0xF);
+		simd::store3(out[i], _mm256_div_pd(r, _mm256_permute2f128_pd(w, w, 0x11)));
+	}
+}
+inline void transform4(const tmat4x4<double>& m, const tvec4<double>* in, tvec4<double>* out, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		_mm256_storeu_pd((double*)(out + i), simd::transform(m, (const double*)(in + i)));
+	}
+}
+inline void rebase(const tvec3<double>& origin, const tvec3<double>* in, tvec3<float>* out, const size_t count)
+{
+	// four points are twelve doubles, which is three registers whatever the alignment of x, y and z
+	const __m256d o0 = _mm256_setr_pd(origin.x, origin.y, origin.z, origin.x);
+	const __m256d o1 = _mm256_setr_pd(origin.y, origin.z, origin.x, origin.y);
+	const __m256d o2 = _mm256_setr_pd(origin.z, origin.x, origin.y, origin.z);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		const double* p = (const double*)(in + i);
+		float* q = (float*)(out + i);
+		_mm_storeu_ps(q, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(p), o0)));
+		_mm_storeu_ps(q + 4, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(p + 4), o1)));
+		_mm_storeu_ps(q + 8, _mm256_cvtpd_ps(_mm256_sub_pd(_mm256_loadu_pd(p + 8), o2)));
+	}
+	for (; i < count; i++)
+	{
+		out[i] = tvec3<float>((float)(in[i].x - origin.x), (float)(in[i].y - origin.y), (float)(in[i].z - origin.z));
+	}
+}
+#endif
+
+#endif
+
+// Inverts count matrices. When singular is not null it receives 1 for every matrix whose
+// determinant magnitude is at or below epsilon; those come back as identity.
+template <typename T> inline void inverseBatch(const tmat4x4<T>* in, tmat4x4<T>* out, unsigned char* singular, const size_t count, const T epsilon = (T)0)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		T determinant;
+		tmat4x4<T> m = inverse(in[i], determinant);
+		bool degenerate = (determinant < (T)0 ? -determinant : determinant) <= epsilon;
+		out[i] = degenerate ? tmat4x4<T>() : m;
+		if (singular != 0)
+		{
+			singular[i] = degenerate ? 1 : 0;
+		}
+	}
+}
+#if defined(GMATH_AVX) && !defined(GMATH_AVX2)
+// One matrix per lane through the float kernel's inverseLanes. With AVX2 a double register holding
+// a single column makes the column inverse faster, so the template above is used instead.
+inline void inverseBatch(const tmat4x4<double>* in, tmat4x4<double>* out, unsigned char* singular, const size_t count, const double epsilon = 0.0)
+{
+	__m256d threshold;
+	native::fill(threshold, epsilon);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4)
+	{
+		int flags = native::inverseLanes(in + i, out + i, threshold);
+		for (int k = 0; singular != 0 && k < 4; k++)
+		{
+			singular[i + k] = (unsigned char)((flags >> k) & 1);
+		}
+	}
+
+	inverseBatch<double>(in + i, out + i, singular != 0 ? singular + i : 0, count - i, epsilon);
+}
+#endif
+template <typename T> inline void multiplyBatch(const tmat4x4<T>* m0, const tmat4x4<T>* m1, tmat4x4<T>* out, const size_t count)
+{
+	// the SIMD operator* already broadcasts whole columns, transposing to one matrix per lane is slower
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = m0[i] * m1[i];
+	}
+}
+
+#if defined(GMATH_SSE41)
+inline void inverseBatch(const tmat4x4<float>* in, tmat4x4<float>* out, unsigned char* singular, const size_t count, const float epsilon = 0.0f)
+{
+	native::inverseBatch(in, out, singular, count, epsilon);
+}
+inline void multiplyBatch(const tmat4x4<float>* m0, const tmat4x4<float>* m1, tmat4x4<float>* out, const size_t count)
+{
+	native::multiplyBatch(m0, m1, out, count);
+}
+#endif
+
+template <typename T> inline void transformPoints(const tmat4x4<T>& m, const tvec3<T>* in, tvec3<T>* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		transformPoints(m, in + begin, out + begin, end - begin);
+	});
+}
+template <typename T> inline void transformVectors(const tmat4x4<T>& m, const tvec3<T>* in, tvec3<T>* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		transformVectors(m, in + begin, out + begin, end - begin);
+	});
+}
+template <typename T> inline void transformProjected(const tmat4x4<T>& m, const tvec3<T>* in, tvec3<T>* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		transformProjected(m, in + begin, out + begin, end - begin);
+	});
+}
+template <typename T> inline void transform4(const tmat4x4<T>& m, const tvec4<T>* in, tvec4<T>* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		transform4(m, in + begin, out + begin, end - begin);
+	});
+}
+
+template <typename T> inline void inverseBatch(const tmat4x4<T>* in, tmat4x4<T>* out, unsigned char* singular, const size_t count, const T epsilon, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		inverseBatch(in + begin, out + begin, singular != 0 ? singular + begin : 0, end - begin, epsilon);
+	});
+}
+template <typename T> inline void multiplyBatch(const tmat4x4<T>* m0, const tmat4x4<T>* m1, tmat4x4<T>* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		multiplyBatch(m0 + begin, m1 + begin, out + begin, end - begin);
+	});
+}
+
+template <typename T> inline void decompose(const tmat4x4<T>* m, tvec3<T>* translation, tquat<T>* rotation, tvec3<T>* scale, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		decompose(m + begin, translation + begin, rotation + begin, scale + begin, end - begin);
+	});
+}
+
+template <typename T> inline void rebase(const tvec3<T>& origin, const tvec3<T>* in, tvec3<float>* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		rebase(origin, in + begin, out + begin, end - begin);
+	});
+}
+template <typename T> inline void nlerp(const tquat<T>* q0, const tquat<T>* q1, const T* t, tquat<T>* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		nlerp(q0 + begin, q1 + begin, t + begin, out + begin, end - begin);
+	});
+}
+template <typename T> inline void slerp(const tquat<T>* q0, const tquat<T>* q1, const T* t, tquat<T>* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		slerp(q0 + begin, q1 + begin, t + begin, out + begin, end - begin);
+	});
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -22,7 +22,7 @@ template <typename T> struct tbox
 		width(p1.x - p0.x),
 		height(p1.y - p0.y) {}
 	inline tbox(const glm::tvec2<T>& p, const T width, const T height) :
-		p0(p - tvec2<T>(width / (T)2, height / (T)2)),
+		p0(p - glm::tvec2<T>(width / (T)2, height / (T)2)),
 		p1(this->p0 + glm::tvec2<T>(width, height)),
 		center(p),
 		width(width),
@@ -0,0 +1,590 @@
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <float.h>
+
+#include <gmath.hpp>
+#include <array.hpp>
+#include <aabb.hpp>
+#include <frustum.hpp>
+#include <intersect.hpp>
+
+namespace gmath
+{
+
+#if !(defined(tbroadphase) || defined(broadphase))
+// A dynamic AABB tree over moving boxes. Each proxy is a leaf holding a fat box, its box grown by the
+// margin on every side, so move() only touches the tree once a box leaves its fat one. Insertion picks
+// the sibling by surface area and the walk back up applies Kensler's tree rotations wherever they shrink
+// a node, which keeps the tree in shape without rebuilds. Nodes come from one pooled array with a free
+// list; a proxy id is the index of its leaf and stays valid until destroy().
+template <typename T> class tbroadphase
+{
+public:
+
+	// Everything between two calls to pairs(). reinserted against moved shows how much motion the margin
+	// absorbs, visited is the nodes walked to keep the tree up to date, the update cost, and tested is the
+	// nodes walked to enumerate pairs.
+	struct counters
+	{
+		int proxies;
+		int height;
+		int moved;
+		int reinserted;
+		int rotations;
+		int visited;
+		int pairs;
+		int tested;
+	};
+
+	tbroadphase(const T margin = (T)0.1) : _root(-1), _free(-1), _proxies(0), _margin(margin), _tick(), _last() {}
+	~tbroadphase() {}
+
+	const int create(const taabb3<T>& box)
+	{
+		int leaf = this->allocate();
+		node* nodes = this->nodes();
+		nodes[leaf].box() = this->fatten(box);
+		nodes[leaf].height = 0;
+		nodes[leaf].child[0] = -1;
+		nodes[leaf].child[1] = -1;
+		this->insert(leaf);
+		this->touch(leaf);
+		this->_proxies++;
+		return leaf;
+	}
+	void destroy(const int proxy)
+	{
+		this->remove(proxy);
+		this->release(proxy);
+		this->_proxies--;
+	}
+	// True when the box left the fat one and the proxy was reinserted, which also queues it for pairs().
+	bool move(const int proxy, const taabb3<T>& box)
+	{
+		this->_tick.moved++;
+		if (gmath::contains(this->nodes()[proxy].box(), box))
+		{
+			return false;
+		}
+
+		this->remove(proxy);
+		this->nodes()[proxy].box() = this->fatten(box);
+		this->insert(proxy);
+		this->touch(proxy);
+		this->_tick.reinserted++;
+		return true;
+	}
+
+	void setMargin(const T margin)
+	{
+		this->_margin = margin;
+	}
+	const T margin() const
+	{
+		return this->_margin;
+	}
+	const int size() const
+	{
+		return this->_proxies;
+	}
+	const int height() const
+	{
+		return this->_root < 0 ? 0 : this->nodes()[this->_root].height;
+	}
+	const taabb3<T>& bounds(const int proxy) const
+	{
+		return this->nodes()[proxy].box();
+	}
+	bool overlapping(const int a, const int b) const
+	{
+		return gmath::overlaps(this->nodes()[a].box(), this->nodes()[b].box());
+	}
+	// The counters of the last tick, ended by the last call to pairs().
+	const counters& stats() const
+	{
+		return this->_last;
+	}
+
+	// Calls f(a, b), a < b, once for every pair of overlapping fat boxes of which at least one was created
+	// or reinserted since the last call: the pairs a contact list has to add. Pairs that stay overlapping
+	// are not reported again, so a contact is kept until overlapping() fails. f must not change the tree.
+	// Returns the number of pairs and ends the tick.
+	template <typename F> int pairs(const F& f)
+	{
+		node* nodes = this->nodes();
+		const int* moves = this->_moves;
+		int found = 0;
+		for (int i = 0; i < this->_moves.count(); i++)
+		{
+			// destroyed proxies keep their entry, and their node may since be an inner one
+			const int q = moves[i];
+			if (nodes[q].height != 0)
+			{
+				continue;
+			}
+
+			// when both moved the pair is reported from the lower id
+			this->_tick.tested += this->search(nodes[q].box(), [&](const int p)
+			{
+				if (p != q && !(nodes[p].moved && p < q))
+				{
+					f(p < q ? p : q, p < q ? q : p);
+					found++;
+				}
+			});
+		}
+		for (int i = 0; i < this->_moves.count(); i++)
+		{
+			nodes[moves[i]].moved = false;
+		}
+		this->_moves.zero();
+
+		this->_tick.pairs = found;
+		this->_tick.proxies = this->_proxies;
+		this->_tick.height = this->height();
+		this->_last = this->_tick;
+		this->_tick = counters();
+		return found;
+	}
+
+	// Calls f(proxy) for every proxy whose fat box overlaps box.
+	template <typename F> void query(const taabb3<T>& box, const F& f) const
+	{
+		this->search(box, f);
+	}
+	// Calls f(proxy, t) for every proxy whose fat box the ray passes through, t being where it enters, with
+	// the nearer child of each node first. f returns the length to cut the ray to: the distance of a real
+	// hit to skip what lies behind it, the ray length or more to go on, 0 to stop.
+	template <typename F> void query(const tray<T>& ray, const F& f) const
+	{
+		if (this->_root < 0)
+		{
+			return;
+		}
+
+		const node* nodes = this->nodes();
+		T origin[3];
+		T inverse[3];
+		for (int k = 0; k < 3; k++)
+		{
+			origin[k] = ((const T*)&ray.origin)[k];
+			inverse[k] = (T)1 / ((const T*)&ray.direction)[k];
+		}
+
+		T length = ray.length;
+		T t = (T)0;
+		if (!slab(nodes[this->_root].box(), origin, inverse, length, t))
+		{
+			return;
+		}
+
+		path<int> stack(this->height() + 1);
+		path<T> entry(this->height() + 1);
+		int top = 0;
+		stack[top] = this->_root;
+		entry[top++] = t;
+		while (top > 0)
+		{
+			top--;
+			const int i = stack[top];
+			if (entry[top] > length)
+			{
+				continue;
+			}
+
+			const node& n = nodes[i];
+			if (n.height == 0)
+			{
+				T cut = f(i, entry[top]);
+				length = cut < length ? cut : length;
+				if (length <= (T)0)
+				{
+					return;
+				}
+
+				continue;
+			}
+
+			T t0 = (T)0;
+			T t1 = (T)0;
+			bool h0 = slab(nodes[n.child[0]].box(), origin, inverse, length, t0);
+			bool h1 = slab(nodes[n.child[1]].box(), origin, inverse, length, t1);
+			int first = t1 < t0 ? 1 : 0;
+			if (first == 0 ? h1 : h0)
+			{
+				stack[top] = n.child[1 - first];
+				entry[top++] = first == 0 ? t1 : t0;
+			}
+			if (first == 0 ? h0 : h1)
+			{
+				stack[top] = n.child[first];
+				entry[top++] = first == 0 ? t0 : t1;
+			}
+		}
+	}
+	// Calls f(proxy) for every proxy whose fat box passes tviewfrustum::intersects. A node wholly on the
+	// inner side of a plane drops that plane for its subtree, so subtrees inside all six are reported
+	// without further tests.
+	template <typename F> void query(const tviewfrustum<T>& frustum, const F& f) const
+	{
+		if (this->_root < 0)
+		{
+			return;
+		}
+
+		const node* nodes = this->nodes();
+		path<int> stack(this->height() + 1);
+		path<int> planes(this->height() + 1);
+		int top = 0;
+		stack[top] = this->_root;
+		planes[top++] = (1 << tviewfrustum<T>::count) - 1;
+		while (top > 0)
+		{
+			top--;
+			const int i = stack[top];
+			const node& n = nodes[i];
+			int mask = planes[top];
+			bool outside = false;
+			for (int k = 0; k < tviewfrustum<T>::count && !outside; k++)
+			{
+				if ((mask & (1 << k)) == 0)
+				{
+					continue;
+				}
+
+				const tvec4<T>& p = frustum.plane(k);
+				T x0 = p.x < (T)0 ? n.box().max.x : n.box().min.x;
+				T y0 = p.y < (T)0 ? n.box().max.y : n.box().min.y;
+				T z0 = p.z < (T)0 ? n.box().max.z : n.box().min.z;
+				T x1 = p.x < (T)0 ? n.box().min.x : n.box().max.x;
+				T y1 = p.y < (T)0 ? n.box().min.y : n.box().max.y;
+				T z1 = p.z < (T)0 ? n.box().min.z : n.box().max.z;
+				outside = (p.x * x1) + (p.y * y1) + (p.z * z1) + p.w < (T)0;
+				mask &= (p.x * x0) + (p.y * y0) + (p.z * z0) + p.w >= (T)0 ? ~(1 << k) : ~0;
+			}
+			if (outside)
+			{
+				continue;
+			}
+
+			if (n.height == 0)
+			{
+				f(i);
+				continue;
+			}
+
+			stack[top] = n.child[1];
+			planes[top++] = mask;
+			stack[top] = n.child[0];
+			planes[top++] = mask;
+		}
+	}
+
+private:
+
+	// child is -1 for leaves, height is 0 for leaves and -1 for free nodes, whose parent links the free list.
+	// The box is kept as min then max in plain storage so nodes stay trivial for Array to clear and copy.
+	struct node
+	{
+		inline taabb3<T>& box()
+		{
+			return *(taabb3<T>*)this->bounds;
+		}
+		inline const taabb3<T>& box() const
+		{
+			return *(const taabb3<T>*)this->bounds;
+		}
+
+		T bounds[6];
+		int parent;
+		int child[2];
+		int height;
+		bool moved;
+	};
+
+	// A traversal stack on the stack, unless the tree is deep enough to need the heap.
+	template <typename U> struct path
+	{
+		path(const int size) : data(size <= 64 ? local : new U[size]) {}
+		~path()
+		{
+			if (this->data != this->local)
+			{
+				delete[] this->data;
+			}
+		}
+
+		U& operator[](const int index)
+		{
+			return this->data[index];
+		}
+
+		U local[64];
+		U* data;
+	};
+
+	inline node* nodes() const
+	{
+		return (node*)this->_nodes;
+	}
+	inline taabb3<T> fatten(const taabb3<T>& box) const
+	{
+		const tvec3<T> margin(this->_margin);
+		return taabb3<T>(box.min - margin, box.max + margin);
+	}
+	static inline bool slab(const taabb3<T>& box, const T* origin, const T* inverse, const T length, T& t)
+	{
+		typedef simd::lane<T> L;
+		L t0((T)0);
+		L t1(length);
+		for (int k = 0; k < 3; k++)
+		{
+			const T b0 = ((const T*)&box.min)[k];
+			const T b1 = ((const T*)&box.max)[k];
+			batch::slab(L(origin[k]), L(inverse[k]), L(inverse[k] < (T)0 ? b1 : b0), L(inverse[k] < (T)0 ? b0 : b1), t0, t1);
+		}
+
+		t = t0.value;
+		return t0.value <= t1.value;
+	}
+
+	template <typename F> int search(const taabb3<T>& box, const F& f) const
+	{
+		if (this->_root < 0)
+		{
+			return 0;
+		}
+
+		const node* nodes = this->nodes();
+		path<int> stack(this->height() + 1);
+		int top = 0;
+		int visited = 0;
+		stack[top++] = this->_root;
+		while (top > 0)
+		{
+			const int i = stack[--top];
+			const node& n = nodes[i];
+			visited++;
+			if (!gmath::overlaps(n.box(), box))
+			{
+				continue;
+			}
+
+			if (n.height == 0)
+			{
+				f(i);
+			}
+			else
+			{
+				stack[top++] = n.child[1];
+				stack[top++] = n.child[0];
+			}
+		}
+
+		return visited;
+	}
+
+	const int allocate()
+	{
+		if (this->_free >= 0)
+		{
+			// moved stays as it is, so a pending entry in _moves is never doubled
+			int index = this->_free;
+			this->_free = this->nodes()[index].parent;
+			return index;
+		}
+
+		node n;
+		n.parent = -1;
+		n.child[0] = -1;
+		n.child[1] = -1;
+		n.height = -1;
+		n.moved = false;
+		return this->_nodes.add(n);
+	}
+	void release(const int index)
+	{
+		node& n = this->nodes()[index];
+		n.height = -1;
+		n.parent = this->_free;
+		this->_free = index;
+	}
+	void touch(const int leaf)
+	{
+		node& n = this->nodes()[leaf];
+		if (!n.moved)
+		{
+			n.moved = true;
+			this->_moves.add(leaf);
+		}
+	}
+
+	// Growing a node by the leaf costs its new area, and every ancestor above pays its own growth.
+	static inline T descent(const node& n, const taabb3<T>& box)
+	{
+		T combined = gmath::area(gmath::merge(n.box(), box));
+		return n.height == 0 ? combined : combined - gmath::area(n.box());
+	}
+	void insert(const int leaf)
+	{
+		node* nodes = this->nodes();
+		this->_tick.visited++;
+		if (this->_root < 0)
+		{
+			this->_root = leaf;
+			nodes[leaf].parent = -1;
+			return;
+		}
+
+		// go down while a child is cheaper to pair with than the node itself
+		const taabb3<T> box = nodes[leaf].box();
+		int sibling = this->_root;
+		while (nodes[sibling].height > 0)
+		{
+			const node& n = nodes[sibling];
+			T combined = gmath::area(gmath::merge(n.box(), box));
+			T cost = (T)2 * combined;
+			T inherited = (T)2 * (combined - gmath::area(n.box()));
+			T c0 = descent(nodes[n.child[0]], box) + inherited;
+			T c1 = descent(nodes[n.child[1]], box) + inherited;
+			if (cost < c0 && cost < c1)
+			{
+				break;
+			}
+
+			sibling = c0 < c1 ? n.child[0] : n.child[1];
+			this->_tick.visited++;
+		}
+
+		int parent = this->allocate();
+		nodes = this->nodes();
+		int above = nodes[sibling].parent;
+		node& p = nodes[parent];
+		p.parent = above;
+		p.box() = gmath::merge(nodes[sibling].box(), box);
+		p.height = nodes[sibling].height + 1;
+		p.child[0] = sibling;
+		p.child[1] = leaf;
+		nodes[sibling].parent = parent;
+		nodes[leaf].parent = parent;
+		if (above < 0)
+		{
+			this->_root = parent;
+		}
+		else
+		{
+			nodes[above].child[nodes[above].child[0] == sibling ? 0 : 1] = parent;
+		}
+
+		this->climb(parent);
+	}
+	void remove(const int leaf)
+	{
+		node* nodes = this->nodes();
+		this->_tick.visited++;
+		if (leaf == this->_root)
+		{
+			this->_root = -1;
+			return;
+		}
+
+		int parent = nodes[leaf].parent;
+		int above = nodes[parent].parent;
+		int sibling = nodes[parent].child[nodes[parent].child[0] == leaf ? 1 : 0];
+		nodes[sibling].parent = above;
+		if (above < 0)
+		{
+			this->_root = sibling;
+		}
+		else
+		{
+			nodes[above].child[nodes[above].child[0] == parent ? 0 : 1] = sibling;
+			this->climb(above);
+		}
+
+		this->release(parent);
+	}
+	// Refits from index up to the root, rotating each node on the way.
+	void climb(int index)
+	{
+		node* nodes = this->nodes();
+		while (index >= 0)
+		{
+			this->rotate(index);
+			node& n = nodes[index];
+			const node& a = nodes[n.child[0]];
+			const node& b = nodes[n.child[1]];
+			n.box() = gmath::merge(a.box(), b.box());
+			n.height = 1 + (a.height > b.height ? a.height : b.height);
+			index = n.parent;
+			this->_tick.visited++;
+		}
+	}
+	// Swaps a child of the node with a grandchild under its other child, when that shrinks the other child
+	// the most. The node keeps its box, so only the child and the heights change.
+	void rotate(const int index)
+	{
+		node* nodes = this->nodes();
+		node& n = nodes[index];
+		T best = (T)0;
+		int up = -1;
+		int down = -1;
+		for (int s = 0; s < 2; s++)
+		{
+			const node& other = nodes[n.child[1 - s]];
+			if (other.height == 0)
+			{
+				continue;
+			}
+
+			T area = gmath::area(other.box());
+			for (int k = 0; k < 2; k++)
+			{
+				T gain = area - gmath::area(gmath::merge(nodes[n.child[s]].box(), nodes[other.child[1 - k]].box()));
+				if (gain > best)
+				{
+					best = gain;
+					up = s;
+					down = k;
+				}
+			}
+		}
+		if (up < 0)
+		{
+			return;
+		}
+
+		const int x = n.child[up];
+		const int p = n.child[1 - up];
+		node& o = nodes[p];
+		const int y = o.child[down];
+		n.child[up] = y;
+		nodes[y].parent = index;
+		o.child[down] = x;
+		nodes[x].parent = p;
+
+		const node& a = nodes[o.child[0]];
+		const node& b = nodes[o.child[1]];
+		o.box() = gmath::merge(a.box(), b.box());
+		o.height = 1 + (a.height > b.height ? a.height : b.height);
+		this->_tick.rotations++;
+	}
+
+	Array<node> _nodes;
+	Array<int> _moves;
+	int _root;
+	int _free;
+	int _proxies;
+	T _margin;
+	counters _tick;
+	counters _last;
+
+};
+
+typedef tbroadphase<float> broadphase;
+#endif
+
+}
+
+#endif
\ No newline at end of file
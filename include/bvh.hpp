@@ -0,0 +1,835 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include <float.h>
+#include <algorithm>
+#include <thread>
+
+#include <gmath.hpp>
+#include <batch.hpp>
+#include <array.hpp>
+#include <intersect.hpp>
+
+#if !defined(GMATH_BVH_BINS)
+#define GMATH_BVH_BINS 16
+#endif
+
+namespace gmath
+{
+
+namespace simd
+{
+
+// The widest lane type no wider than N, for testing the N children of a wide node together.
+template <typename T, int N> struct fit
+{
+	typedef lane<T> type;
+};
+#if defined(GMATH_SSE41)
+template <> struct fit<float, 4>
+{
+	typedef f32x4 type;
+};
+#endif
+#if defined(GMATH_AVX)
+template <> struct fit<float, 8>
+{
+	typedef f32x8 type;
+};
+template <> struct fit<double, 4>
+{
+	typedef f64x4 type;
+};
+template <> struct fit<double, 8>
+{
+	typedef f64x4 type;
+};
+#elif defined(GMATH_SSE41)
+template <> struct fit<float, 8>
+{
+	typedef f32x4 type;
+};
+#endif
+
+}
+
+#if !(defined(tbvh) || defined(bvh4) || defined(bvh8))
+// Bounding volume hierarchy over a triangle mesh with N = 4 or 8 children per node. Nodes hold the
+// boxes of their children side by side so one slab test covers a SIMD register of them, and sit in
+// depth-first order. Leaf triangles are copied into blocks of L::width, laid out the way
+// batch::triangle takes them, so the mesh arrays are only needed again to refit. Leaves hold up to
+// 8 * L::width / N triangles, two blocks under 4-wide nodes and one under 8-wide nodes, whose wider
+// slab test makes splitting a leaf cheaper than testing a second block.
+template <typename T, int N> class tbvh
+{
+public:
+
+	typedef typename simd::fit<T, N>::type L;
+	enum { width = N, leafSize = (8 * L::width) / N < 4 ? 4 : (8 * L::width) / N, depthLimit = 64 };
+
+	tbvh() : _count(0) {}
+	~tbvh() {}
+
+	// Binned SAH over the triangle centroids. Above GMATH_BATCH_GRAIN triangles the two halves of
+	// a split are built on separate threads, until the threads run out.
+	void build(const tvec3<T>* v0, const tvec3<T>* v1, const tvec3<T>* v2, const int count, const unsigned int threads = 1)
+	{
+		this->_nodes.clear();
+		this->_blocks.clear();
+		this->_count = count;
+		if (count < 1)
+		{
+			return;
+		}
+
+		Array<reference> references(count);
+		Array<split> splits(count * 2);
+		scratch s = { (reference*)references, (split*)splits };
+		parallel((size_t)count, threads, [&](const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				const T* a = (const T*)(v0 + i);
+				const T* b = (const T*)(v1 + i);
+				const T* c = (const T*)(v2 + i);
+				reference& r = s.references[i];
+				for (int k = 0; k < 3; k++)
+				{
+					r.bounds[k] = tbvh<T, N>::lower(a[k], tbvh<T, N>::lower(b[k], c[k]));
+					r.bounds[3 + k] = tbvh<T, N>::upper(a[k], tbvh<T, N>::upper(b[k], c[k]));
+					r.center[k] = (r.bounds[k] + r.bounds[3 + k]) * (T)0.5;
+				}
+
+				r.index = (int)i;
+			}
+		});
+
+		unsigned int workers = threads == 0 ? std::thread::hardware_concurrency() : threads;
+		T box[6];
+		T centers[6];
+		tbvh<T, N>::enclose(s.references, 0, count, box, centers);
+
+		int blocks = 0;
+		int root = this->subdivide(s, 0, count, box, centers, 0, workers, blocks);
+		this->_blocks.resize(blocks);
+		this->flatten(s, root);
+		this->load(v0, v1, v2, threads);
+	}
+	// Moves the boxes to new vertex positions while keeping the tree, for meshes that deform
+	// without changing topology. Quality degrades as triangles drift from where they were built.
+	void refit(const tvec3<T>* v0, const tvec3<T>* v1, const tvec3<T>* v2, const unsigned int threads = 1)
+	{
+		this->load(v0, v1, v2, threads);
+
+		// children always come after their parent, so walking backwards sees them first
+		const block* blocks = (const block*)this->_blocks;
+		node* nodes = (node*)this->_nodes;
+		for (int i = this->_nodes.count() - 1; i >= 0; i--)
+		{
+			node& n = nodes[i];
+			for (int j = 0; j < N; j++)
+			{
+				T box[6];
+				tbvh<T, N>::empty(box);
+				if (n.count[j] > 0)
+				{
+					for (int b = n.child[j]; b < n.child[j] + n.count[j]; b++)
+					{
+						tbvh<T, N>::bound(blocks[b], box);
+					}
+				}
+				else if (n.child[j] > 0)
+				{
+					const node& c = nodes[n.child[j]];
+					for (int k = 0; k < N; k++)
+					{
+						for (int e = 0; e < 3; e++)
+						{
+							box[e] = tbvh<T, N>::lower(box[e], c.bounds[e][k]);
+							box[3 + e] = tbvh<T, N>::upper(box[3 + e], c.bounds[3 + e][k]);
+						}
+					}
+				}
+				else
+				{
+					continue;
+				}
+
+				for (int e = 0; e < 6; e++)
+				{
+					n.bounds[e][j] = box[e];
+				}
+			}
+		}
+	}
+
+	// Closest hit along the ray within its length. Returns the index of the triangle and fills hit,
+	// or returns -1 and leaves hit alone.
+	int intersect(const tray<T>& ray, thit<T>& hit) const
+	{
+		if (this->_nodes.count() == 0)
+		{
+			return -1;
+		}
+
+		const node* nodes = (const node*)this->_nodes;
+		const block* blocks = (const block*)this->_blocks;
+		L r[7];
+		L inverse[3];
+		int front[3];
+		int back[3];
+		simd::broadcast(ray, r);
+		tbvh<T, N>::prepare(ray, inverse, front, back);
+
+		int found = -1;
+		T closest = ray.length;
+		T u = (T)0;
+		T v = (T)0;
+		int stack[(depthLimit + 32) * N];
+		T distances[(depthLimit + 32) * N];
+		int top = 1;
+		stack[0] = 0;
+		distances[0] = (T)0;
+		while (top > 0)
+		{
+			top--;
+			if (distances[top] > closest)
+			{
+				continue;
+			}
+
+			const node& n = nodes[stack[top]];
+			T t[N];
+			int mask = tbvh<T, N>::slab(n, r, inverse, front, back, closest, t);
+
+			// leaves are tested on the spot so the closest hit shrinks early; inner nodes are
+			// pushed farthest first so the nearest one comes off the stack first
+			int first = top;
+			for (int j = 0; j < N; j++)
+			{
+				if (((mask >> j) & 1) == 0)
+				{
+					continue;
+				}
+
+				if (n.count[j] > 0)
+				{
+					for (int b = n.child[j]; b < n.child[j] + n.count[j]; b++)
+					{
+						const block& k = blocks[b];
+						L p[9];
+						for (int e = 0; e < 9; e++)
+						{
+							p[e] = L::load(k.v[e]);
+						}
+
+						L tt;
+						L tu;
+						L tv;
+						r[6] = L(closest);
+						int m = simd::bits(batch::triangle(r, p, p + 3, p + 6, tt, tu, tv));
+						if (m != 0)
+						{
+							T dt[L::width];
+							T du[L::width];
+							T dv[L::width];
+							tt.store(dt);
+							tu.store(du);
+							tv.store(dv);
+							for (int l = 0; l < L::width; l++)
+							{
+								if (((m >> l) & 1) != 0 && (found < 0 || dt[l] < closest))
+								{
+									found = k.index[l];
+									closest = dt[l];
+									u = du[l];
+									v = dv[l];
+								}
+							}
+						}
+					}
+				}
+				else
+				{
+					int i = top++;
+					for (; i > first && distances[i - 1] < t[j]; i--)
+					{
+						stack[i] = stack[i - 1];
+						distances[i] = distances[i - 1];
+					}
+
+					stack[i] = n.child[j];
+					distances[i] = t[j];
+				}
+			}
+		}
+
+		if (found >= 0)
+		{
+			hit = thit<T>(closest, u, v);
+		}
+
+		return found;
+	}
+	// True when anything is hit within the ray length. Stops at the first hit found.
+	bool occluded(const tray<T>& ray) const
+	{
+		if (this->_nodes.count() == 0)
+		{
+			return false;
+		}
+
+		const node* nodes = (const node*)this->_nodes;
+		const block* blocks = (const block*)this->_blocks;
+		L r[7];
+		L inverse[3];
+		int front[3];
+		int back[3];
+		simd::broadcast(ray, r);
+		tbvh<T, N>::prepare(ray, inverse, front, back);
+
+		int stack[(depthLimit + 32) * N];
+		int top = 1;
+		stack[0] = 0;
+		while (top > 0)
+		{
+			const node& n = nodes[stack[--top]];
+			T t[N];
+			int mask = tbvh<T, N>::slab(n, r, inverse, front, back, ray.length, t);
+			for (int j = 0; j < N; j++)
+			{
+				if (((mask >> j) & 1) == 0)
+				{
+					continue;
+				}
+
+				if (n.count[j] == 0)
+				{
+					stack[top++] = n.child[j];
+					continue;
+				}
+
+				for (int b = n.child[j]; b < n.child[j] + n.count[j]; b++)
+				{
+					const block& k = blocks[b];
+					L p[9];
+					for (int e = 0; e < 9; e++)
+					{
+						p[e] = L::load(k.v[e]);
+					}
+
+					L tt;
+					L tu;
+					L tv;
+					if (simd::any(batch::triangle(r, p, p + 3, p + 6, tt, tu, tv)))
+					{
+						return true;
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	// Many rays, split across threads. Misses get index -1 and a default thit.
+	void intersect(const tray<T>* rays, thit<T>* hits, int* indices, const size_t count, const unsigned int threads = 1) const
+	{
+		parallel(count, threads, [&](const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				thit<T> h;
+				indices[i] = this->intersect(rays[i], h);
+				hits[i] = h;
+			}
+		});
+	}
+	void occluded(const tray<T>* rays, bool* occluded, const size_t count, const unsigned int threads = 1) const
+	{
+		parallel(count, threads, [&](const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				occluded[i] = this->occluded(rays[i]);
+			}
+		});
+	}
+
+	const int size() const
+	{
+		return this->_count;
+	}
+	const int nodes() const
+	{
+		return this->_nodes.count();
+	}
+	const int blocks() const
+	{
+		return this->_blocks.count();
+	}
+
+private:
+
+	// Empty slots have inverted boxes, which no ray enters.
+	struct node
+	{
+		T bounds[6][N];
+		int child[N];
+		int count[N];
+	};
+	// Unused lanes are degenerate triangles at the origin with index -1.
+	struct block
+	{
+		T v[9][L::width];
+		int index[L::width];
+	};
+	// A binary node from the build. Leaves have left = -1 and own triangles first to first + count.
+	struct split
+	{
+		T bounds[6];
+		int left;
+		int right;
+		int first;
+		int count;
+	};
+	// A triangle during the build. These are partitioned in place rather than through an index
+	// array so that every pass over a range reads memory in order.
+	struct reference
+	{
+		T bounds[6];
+		T center[3];
+		int index;
+	};
+	struct scratch
+	{
+		reference* references;
+		split* splits;
+	};
+
+	static T lower(const T a, const T b)
+	{
+		return a < b ? a : b;
+	}
+	static T upper(const T a, const T b)
+	{
+		return a > b ? a : b;
+	}
+	static void empty(T* box)
+	{
+		box[0] = box[1] = box[2] = (T)FLT_MAX;
+		box[3] = box[4] = box[5] = (T)-FLT_MAX;
+	}
+	static void grow(T* box, const T* b)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			box[k] = tbvh<T, N>::lower(box[k], b[k]);
+			box[3 + k] = tbvh<T, N>::upper(box[3 + k], b[3 + k]);
+		}
+	}
+	// half the surface area, all SAH needs
+	static T area(const T* box)
+	{
+		T x = box[3] - box[0];
+		T y = box[4] - box[1];
+		T z = box[5] - box[2];
+		return (x * y) + (y * z) + (z * x);
+	}
+	// the same arithmetic bins a centroid and later sorts it, so both agree on its side
+	static int bin(const T center, const T origin, const T scale, const int bins)
+	{
+		int b = (int)((center - origin) * scale);
+		return b < bins - 1 ? b : bins - 1;
+	}
+	static T cost(const int count)
+	{
+		return (T)((count + L::width - 1) / L::width);
+	}
+
+	// Copies the vertices of every block from the mesh, through the triangle indices it holds.
+	void load(const tvec3<T>* v0, const tvec3<T>* v1, const tvec3<T>* v2, const unsigned int threads)
+	{
+		block* blocks = (block*)this->_blocks;
+		parallel((size_t)this->_blocks.count(), threads, [&](const size_t begin, const size_t end)
+		{
+			for (size_t i = begin; i < end; i++)
+			{
+				block& b = blocks[i];
+				for (int l = 0; l < L::width; l++)
+				{
+					if (b.index[l] < 0)
+					{
+						continue;
+					}
+
+					const T* p[3] = { (const T*)(v0 + b.index[l]), (const T*)(v1 + b.index[l]), (const T*)(v2 + b.index[l]) };
+					for (int e = 0; e < 9; e++)
+					{
+						b.v[e][l] = p[e / 3][e % 3];
+					}
+				}
+			}
+		});
+	}
+	static void bound(const block& b, T* box)
+	{
+		for (int l = 0; l < L::width; l++)
+		{
+			if (b.index[l] < 0)
+			{
+				continue;
+			}
+
+			for (int e = 0; e < 9; e++)
+			{
+				box[e % 3] = tbvh<T, N>::lower(box[e % 3], b.v[e][l]);
+				box[3 + (e % 3)] = tbvh<T, N>::upper(box[3 + (e % 3)], b.v[e][l]);
+			}
+		}
+	}
+
+	static void prepare(const tray<T>& ray, L* inverse, int* front, int* back)
+	{
+		// the signs come from the reciprocal so that -0 picks the same planes as a negative direction
+		const T* d = (const T*)&ray.direction;
+		for (int k = 0; k < 3; k++)
+		{
+			T i = (T)1 / d[k];
+			inverse[k] = L(i);
+			front[k] = i < (T)0 ? 3 + k : k;
+			back[k] = i < (T)0 ? k : 3 + k;
+		}
+	}
+	// Bit j is set when the ray overlaps child j before length, t[j] being where it enters.
+	static int slab(const node& n, const L* r, const L* inverse, const int* front, const int* back, const T length, T* t)
+	{
+		const L zero((T)0);
+		const L end(length);
+		int mask = 0;
+		for (int j = 0; j < N; j += L::width)
+		{
+			L t0 = zero;
+			L t1 = end;
+			for (int k = 0; k < 3; k++)
+			{
+				batch::slab(r[k], inverse[k], L::load(n.bounds[front[k]] + j), L::load(n.bounds[back[k]] + j), t0, t1);
+			}
+
+			mask |= simd::bits(t0 <= t1) << j;
+			t0.store(t + j);
+		}
+
+		return mask;
+	}
+
+	// Box and centroid bounds of the triangles from begin to end.
+	static void enclose(const reference* references, const int begin, const int end, T* box, T* centers)
+	{
+		tbvh<T, N>::empty(box);
+		tbvh<T, N>::empty(centers);
+		for (int i = begin; i < end; i++)
+		{
+			const reference& r = references[i];
+			tbvh<T, N>::grow(box, r.bounds);
+			for (int k = 0; k < 3; k++)
+			{
+				centers[k] = tbvh<T, N>::lower(centers[k], r.center[k]);
+				centers[3 + k] = tbvh<T, N>::upper(centers[3 + k], r.center[k]);
+			}
+		}
+	}
+
+	// Splits [begin, end) given its box and centroid bounds. The bounds of the halves come out of
+	// the bins and the partition, so each level reads its triangles twice.
+	int subdivide(scratch& s, const int begin, const int end, const T* box, const T* centers, const int depth, const unsigned int threads, int& blocks)
+	{
+		const int B = GMATH_BVH_BINS;
+		const int n = end - begin;
+		const int bins = n < B ? n : B;
+
+		// a split costs one node visit plus each half weighted by its area, a leaf only its blocks
+		T parent = tbvh<T, N>::area(box);
+		T best = n <= leafSize ? parent * tbvh<T, N>::cost(n) : (T)FLT_MAX;
+		int axis = -1;
+		int pivot = 0;
+		T scale[3];
+		T boxes[3][B][6];
+		int counts[3][B];
+		if (n > 1 && depth < depthLimit)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				T extent = centers[3 + k] - centers[k];
+				scale[k] = extent > (T)0 ? (T)bins / extent : (T)0;
+				for (int i = 0; i < bins; i++)
+				{
+					tbvh<T, N>::empty(boxes[k][i]);
+					counts[k][i] = 0;
+				}
+			}
+
+			for (int i = begin; i < end; i++)
+			{
+				const reference& r = s.references[i];
+				for (int k = 0; k < 3; k++)
+				{
+					int b = tbvh<T, N>::bin(r.center[k], centers[k], scale[k], bins);
+					tbvh<T, N>::grow(boxes[k][b], r.bounds);
+					counts[k][b]++;
+				}
+			}
+
+			for (int k = 0; k < 3; k++)
+			{
+				if (scale[k] == (T)0)
+				{
+					continue;
+				}
+
+				T right[B];
+				int rights[B];
+				T acc[6];
+				int c = 0;
+				tbvh<T, N>::empty(acc);
+				for (int i = bins - 1; i > 0; i--)
+				{
+					tbvh<T, N>::grow(acc, boxes[k][i]);
+					c += counts[k][i];
+					right[i] = c > 0 ? tbvh<T, N>::area(acc) * tbvh<T, N>::cost(c) : (T)0;
+					rights[i] = c;
+				}
+
+				c = 0;
+				tbvh<T, N>::empty(acc);
+				for (int i = 0; i < bins - 1; i++)
+				{
+					tbvh<T, N>::grow(acc, boxes[k][i]);
+					c += counts[k][i];
+					if (c == 0 || rights[i + 1] == 0)
+					{
+						continue;
+					}
+
+					T sah = parent + (tbvh<T, N>::area(acc) * tbvh<T, N>::cost(c)) + right[i + 1];
+					if (sah < best)
+					{
+						best = sah;
+						axis = k;
+						pivot = i;
+					}
+				}
+			}
+		}
+
+		if (axis < 0 && n <= leafSize)
+		{
+			split& leaf = s.splits[2 * begin];
+			memcpy(leaf.bounds, box, sizeof(leaf.bounds));
+			leaf.left = -1;
+			leaf.right = -1;
+			leaf.first = begin;
+			leaf.count = n;
+			blocks += (n + L::width - 1) / L::width;
+			return 2 * begin;
+		}
+
+		int middle = begin;
+		T lbox[6];
+		T rbox[6];
+		T lcenters[6];
+		T rcenters[6];
+		if (axis >= 0)
+		{
+			tbvh<T, N>::empty(lbox);
+			tbvh<T, N>::empty(rbox);
+			tbvh<T, N>::empty(lcenters);
+			tbvh<T, N>::empty(rcenters);
+			for (int i = 0; i < bins; i++)
+			{
+				tbvh<T, N>::grow(i <= pivot ? lbox : rbox, boxes[axis][i]);
+			}
+
+			int i = begin;
+			int j = end;
+			while (i < j)
+			{
+				const T* c = s.references[i].center;
+				if (tbvh<T, N>::bin(c[axis], centers[axis], scale[axis], bins) <= pivot)
+				{
+					for (int k = 0; k < 3; k++)
+					{
+						lcenters[k] = tbvh<T, N>::lower(lcenters[k], c[k]);
+						lcenters[3 + k] = tbvh<T, N>::upper(lcenters[3 + k], c[k]);
+					}
+					i++;
+				}
+				else
+				{
+					for (int k = 0; k < 3; k++)
+					{
+						rcenters[k] = tbvh<T, N>::lower(rcenters[k], c[k]);
+						rcenters[3 + k] = tbvh<T, N>::upper(rcenters[3 + k], c[k]);
+					}
+					std::swap(s.references[i], s.references[--j]);
+				}
+			}
+
+			middle = i;
+		}
+		if (middle == begin || middle == end)
+		{
+			// no useful split, or too deep: halve by count along the widest spread of centroids
+			int k = 0;
+			for (int e = 1; e < 3; e++)
+			{
+				k = centers[3 + e] - centers[e] > centers[3 + k] - centers[k] ? e : k;
+			}
+
+			middle = begin + (n / 2);
+			std::nth_element(s.references + begin, s.references + middle, s.references + end, [&](const reference& a, const reference& b)
+			{
+				return a.center[k] < b.center[k];
+			});
+			tbvh<T, N>::enclose(s.references, begin, middle, lbox, lcenters);
+			tbvh<T, N>::enclose(s.references, middle, end, rbox, rcenters);
+		}
+
+		// the subtree over [begin, end) owns slots 2 * begin to 2 * end - 2 and its root sits between
+		// the slots of its halves, so threads never share a slot
+		int left = 0;
+		int right = 0;
+		if (threads > 1 && n > GMATH_BATCH_GRAIN)
+		{
+			int counted = 0;
+			std::thread worker([&]()
+			{
+				left = this->subdivide(s, begin, middle, lbox, lcenters, depth + 1, threads / 2, counted);
+			});
+			right = this->subdivide(s, middle, end, rbox, rcenters, depth + 1, threads - (threads / 2), blocks);
+			worker.join();
+			blocks += counted;
+		}
+		else
+		{
+			left = this->subdivide(s, begin, middle, lbox, lcenters, depth + 1, 1, blocks);
+			right = this->subdivide(s, middle, end, rbox, rcenters, depth + 1, 1, blocks);
+		}
+
+		int slot = (2 * middle) - 1;
+		split& inner = s.splits[slot];
+		memcpy(inner.bounds, box, sizeof(inner.bounds));
+		inner.left = left;
+		inner.right = right;
+		inner.first = begin;
+		inner.count = n;
+		return slot;
+	}
+	// Collapses binary nodes into one wide node by opening the largest inner child until N are
+	// gathered, then lays out its subtrees depth first.
+	int flatten(const scratch& s, const int root)
+	{
+		int children[N];
+		int count = 0;
+		const split& r = s.splits[root];
+		if (r.left < 0)
+		{
+			children[count++] = root;
+		}
+		else
+		{
+			children[count++] = r.left;
+			children[count++] = r.right;
+		}
+		while (count < N)
+		{
+			int open = -1;
+			T largest = (T)-1;
+			for (int j = 0; j < count; j++)
+			{
+				const split& c = s.splits[children[j]];
+				if (c.left >= 0 && tbvh<T, N>::area(c.bounds) > largest)
+				{
+					largest = tbvh<T, N>::area(c.bounds);
+					open = j;
+				}
+			}
+			if (open < 0)
+			{
+				break;
+			}
+
+			const split& c = s.splits[children[open]];
+			children[open] = c.left;
+			children[count++] = c.right;
+		}
+
+		node blank;
+		for (int j = 0; j < N; j++)
+		{
+			T box[6];
+			tbvh<T, N>::empty(box);
+			for (int e = 0; e < 6; e++)
+			{
+				blank.bounds[e][j] = box[e];
+			}
+
+			blank.child[j] = -1;
+			blank.count[j] = 0;
+		}
+
+		int index = this->_nodes.add(blank);
+		for (int j = 0; j < count; j++)
+		{
+			const split& c = s.splits[children[j]];
+			int child = 0;
+			int blocks = 0;
+			if (c.left < 0)
+			{
+				child = this->_blocks.count();
+				blocks = (c.count + L::width - 1) / L::width;
+				for (int b = 0; b < blocks; b++)
+				{
+					block k;
+					memset(&k, 0, sizeof(k));
+					for (int l = 0; l < L::width; l++)
+					{
+						int t = (b * L::width) + l;
+						k.index[l] = t < c.count ? s.references[c.first + t].index : -1;
+					}
+
+					this->_blocks.add(k);
+				}
+			}
+			else
+			{
+				child = this->flatten(s, children[j]);
+			}
+
+			// the array may have grown while the subtree was laid out
+			node& n = ((node*)this->_nodes)[index];
+			for (int e = 0; e < 6; e++)
+			{
+				n.bounds[e][j] = c.bounds[e];
+			}
+
+			n.child[j] = child;
+			n.count[j] = blocks;
+		}
+
+		return index;
+	}
+
+	Array<node> _nodes;
+	Array<block> _blocks;
+	int _count;
+
+};
+
+typedef tbvh<float, 4> bvh4;
+typedef tbvh<float, 8> bvh8;
+#endif
+
+}
+
+#endif
\ No newline at end of file
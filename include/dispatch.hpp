@@ -0,0 +1,290 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gmath.hpp>
+#include <batch.hpp>
+
+#if !defined(GMATH_NO_SIMD) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define GMATH_DISPATCH
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC accepts every intrinsic regardless of /arch, GCC and clang have to be told per function.
+#define GMATH_PRAGMA(x) _Pragma(#x)
+#if defined(__clang__)
+#define GMATH_TARGET_PUSH(t) GMATH_PRAGMA(clang attribute push(__attribute__((target(t))), apply_to = function))
+#define GMATH_TARGET_POP GMATH_PRAGMA(clang attribute pop)
+#elif defined(__GNUC__)
+#define GMATH_TARGET_PUSH(t) GMATH_PRAGMA(GCC push_options) GMATH_PRAGMA(GCC target(t))
+#define GMATH_TARGET_POP GMATH_PRAGMA(GCC pop_options)
+#else
+#define GMATH_TARGET_PUSH(t)
+#define GMATH_TARGET_POP
+#endif
+
+namespace gmath
+{
+
+// Runtime selection of the float batch kernels, for binaries that are built for a baseline CPU and
+// run on whatever is there. The CPU is inspected once, on first use, and the GMATH_SIMD environment
+// variable (scalar, sse4.1, avx2 or avx512) can lower the level, never raise it past what the CPU
+// and OS support. Everything else in gmath stays compile time, set by the GMATH_ macros in simd.hpp.
+namespace dispatch
+{
+
+enum level
+{
+	scalar = 0,
+	sse41,
+	avx2,
+	avx512,
+	levels
+};
+
+struct kernels
+{
+	void (*transformPoints)(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count);
+	void (*transformVectors)(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count);
+	void (*normalize)(const tvec3<float>* in, tvec3<float>* out, const size_t count);
+	void (*multiplyBatch)(const tmat4x4<float>* m0, const tmat4x4<float>* m1, tmat4x4<float>* out, const size_t count);
+	void (*inverseBatch)(const tmat4x4<float>* in, tmat4x4<float>* out, unsigned char* singular, const size_t count, const float epsilon);
+};
+
+namespace scalarKernels
+{
+#include <kernels.hpp>
+}
+
+#if defined(GMATH_DISPATCH)
+namespace sse41Kernels
+{
+GMATH_TARGET_PUSH("sse4.1")
+#define GMATH_KERNEL_SSE41
+#include <kernels.hpp>
+#undef GMATH_KERNEL_SSE41
+GMATH_TARGET_POP
+}
+
+namespace avx2Kernels
+{
+GMATH_TARGET_PUSH("avx2,fma")
+#define GMATH_KERNEL_SSE41
+#define GMATH_KERNEL_AVX
+#define GMATH_KERNEL_FMA
+#include <kernels.hpp>
+#undef GMATH_KERNEL_FMA
+#undef GMATH_KERNEL_AVX
+#undef GMATH_KERNEL_SSE41
+GMATH_TARGET_POP
+}
+
+namespace avx512Kernels
+{
+GMATH_TARGET_PUSH("avx512f,avx2,fma")
+#define GMATH_KERNEL_SSE41
+#define GMATH_KERNEL_AVX
+#define GMATH_KERNEL_FMA
+#define GMATH_KERNEL_AVX512
+#include <kernels.hpp>
+#undef GMATH_KERNEL_AVX512
+#undef GMATH_KERNEL_FMA
+#undef GMATH_KERNEL_AVX
+#undef GMATH_KERNEL_SSE41
+GMATH_TARGET_POP
+}
+
+inline void cpuid(const int leaf, unsigned int* r)
+{
+#if defined(_MSC_VER)
+	__cpuidex((int*)r, leaf, 0);
+#else
+	__cpuid_count(leaf, 0, r[0], r[1], r[2], r[3]);
+#endif
+}
+inline unsigned long long xgetbv()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int lo, hi;
+	__asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+#endif
+
+// The widest level this CPU and OS can run. AVX without AVX2 and FMA counts as sse41.
+inline level detect()
+{
+#if defined(GMATH_DISPATCH)
+	unsigned int r[4];
+	cpuid(0, r);
+	const unsigned int leaves = r[0];
+	cpuid(1, r);
+	if ((r[2] & (1u << 19)) == 0)
+	{
+		return scalar;
+	}
+
+	// the OS has to save the wide registers on a context switch, which XCR0 tells
+	const bool fma = (r[2] & (1u << 12)) != 0;
+	const bool avx = (r[2] & (1u << 28)) != 0;
+	const unsigned long long xcr0 = (r[2] & (1u << 27)) != 0 ? xgetbv() : 0;
+	if (leaves < 7 || !fma || !avx || (xcr0 & 0x6) != 0x6)
+	{
+		return sse41;
+	}
+
+	cpuid(7, r);
+	if ((r[1] & (1u << 5)) == 0)
+	{
+		return sse41;
+	}
+
+	return (r[1] & (1u << 16)) != 0 && (xcr0 & 0xE6) == 0xE6 ? avx512 : avx2;
+#else
+	return scalar;
+#endif
+}
+
+inline const char* name(const level l)
+{
+	switch (l)
+	{
+	case sse41: return "sse4.1";
+	case avx2: return "avx2";
+	case avx512: return "avx512";
+	default: return "scalar";
+	}
+}
+// Returns levels for anything that is not a level name.
+inline level parse(const char* s)
+{
+	if (s == 0)
+	{
+		return levels;
+	}
+
+	for (int l = scalar; l < levels; l++)
+	{
+		if (strcmp(s, name((level)l)) == 0)
+		{
+			return (level)l;
+		}
+	}
+
+	return strcmp(s, "sse41") == 0 ? sse41 : levels;
+}
+
+inline level detected()
+{
+	static const level l = detect();
+	return l;
+}
+inline level& current()
+{
+	static level l = parse(getenv("GMATH_SIMD")) < detected() ? parse(getenv("GMATH_SIMD")) : detected();
+	return l;
+}
+
+// The level the dispatched kernels run at.
+inline level selected()
+{
+	return current();
+}
+// Forces a level, clamped to what was detected, and returns the one in effect. This is meant for
+// tests and start up; it is not synchronized with threads already running kernels.
+inline level select(const level l)
+{
+	current() = l < detected() ? l : detected();
+	return current();
+}
+
+#define GMATH_KERNELS(n) { n::transformPoints, n::transformVectors, n::normalize, n::multiplyBatch, n::inverseBatch }
+inline const kernels& table()
+{
+#if defined(GMATH_DISPATCH)
+	static const kernels tables[levels] = { GMATH_KERNELS(scalarKernels), GMATH_KERNELS(sse41Kernels), GMATH_KERNELS(avx2Kernels), GMATH_KERNELS(avx512Kernels) };
+	return tables[current()];
+#else
+	static const kernels k = GMATH_KERNELS(scalarKernels);
+	return k;
+#endif
+}
+#undef GMATH_KERNELS
+
+inline void transformPoints(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	table().transformPoints(m, in, out, count);
+}
+inline void transformVectors(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	table().transformVectors(m, in, out, count);
+}
+inline void normalize(const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	table().normalize(in, out, count);
+}
+inline void multiplyBatch(const tmat4x4<float>* m0, const tmat4x4<float>* m1, tmat4x4<float>* out, const size_t count)
+{
+	table().multiplyBatch(m0, m1, out, count);
+}
+inline void inverseBatch(const tmat4x4<float>* in, tmat4x4<float>* out, unsigned char* singular, const size_t count, const float epsilon = 0.0f)
+{
+	table().inverseBatch(in, out, singular, count, epsilon);
+}
+
+inline void transformPoints(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count, const unsigned int threads)
+{
+	const kernels& k = table();
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		k.transformPoints(m, in + begin, out + begin, end - begin);
+	});
+}
+inline void transformVectors(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count, const unsigned int threads)
+{
+	const kernels& k = table();
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		k.transformVectors(m, in + begin, out + begin, end - begin);
+	});
+}
+inline void normalize(const tvec3<float>* in, tvec3<float>* out, const size_t count, const unsigned int threads)
+{
+	const kernels& k = table();
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		k.normalize(in + begin, out + begin, end - begin);
+	});
+}
+inline void multiplyBatch(const tmat4x4<float>* m0, const tmat4x4<float>* m1, tmat4x4<float>* out, const size_t count, const unsigned int threads)
+{
+	const kernels& k = table();
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		k.multiplyBatch(m0 + begin, m1 + begin, out + begin, end - begin);
+	});
+}
+inline void inverseBatch(const tmat4x4<float>* in, tmat4x4<float>* out, unsigned char* singular, const size_t count, const float epsilon, const unsigned int threads)
+{
+	const kernels& k = table();
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		k.inverseBatch(in + begin, out + begin, singular != 0 ? singular + begin : 0, end - begin, epsilon);
+	});
+}
+
+}
+
+}
+
+#endif
\ No newline at end of file
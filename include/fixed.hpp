@@ -0,0 +1,567 @@
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <limits>
+
+#include <gmath.hpp>
+#include <batch.hpp>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace gmath
+{
+
+// Integer helpers behind tfixed. Everything here is plain integer arithmetic with the rounding spelled
+// out, so a result depends only on its inputs, never on the compiler, the flags or the FPU.
+namespace fixedpoint
+{
+
+// Sums and products wrap around instead of being undefined on overflow.
+inline int add(const int a, const int b) { return (int)((unsigned int)a + (unsigned int)b); }
+inline long long add(const long long a, const long long b) { return (long long)((unsigned long long)a + (unsigned long long)b); }
+inline int sub(const int a, const int b) { return (int)((unsigned int)a - (unsigned int)b); }
+inline long long sub(const long long a, const long long b) { return (long long)((unsigned long long)a - (unsigned long long)b); }
+
+// The unsigned product x * y as its high and low 64 bits.
+inline void wide(const unsigned long long x, const unsigned long long y, unsigned long long& hi, unsigned long long& lo)
+{
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 p = (unsigned __int128)x * y;
+	hi = (unsigned long long)(p >> 64);
+	lo = (unsigned long long)p;
+#elif defined(_MSC_VER) && defined(_M_X64)
+	lo = _umul128(x, y, &hi);
+#else
+	unsigned long long p00 = (x & 0xFFFFFFFF) * (y & 0xFFFFFFFF);
+	unsigned long long p01 = (x & 0xFFFFFFFF) * (y >> 32);
+	unsigned long long p10 = (x >> 32) * (y & 0xFFFFFFFF);
+	unsigned long long p11 = (x >> 32) * (y >> 32);
+	unsigned long long middle = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+	lo = (middle << 32) | (p00 & 0xFFFFFFFF);
+	hi = p11 + (p01 >> 32) + (p10 >> 32) + (middle >> 32);
+#endif
+}
+
+// floor(a * b / 2^shift), kept to the width of the operands; shift is 1 to 63.
+inline int mul(const int a, const int b, const int shift)
+{
+	return (int)(((long long)a * b) >> shift);
+}
+inline long long mul(const long long a, const long long b, const int shift)
+{
+#if defined(__SIZEOF_INT128__)
+	return (long long)(((__int128)a * b) >> shift);
+#else
+	unsigned long long hi;
+	unsigned long long lo;
+	wide((unsigned long long)a, (unsigned long long)b, hi, lo);
+
+	// the unsigned product, corrected to the signed one
+	hi -= (a < 0 ? (unsigned long long)b : 0) + (b < 0 ? (unsigned long long)a : 0);
+	return (long long)((hi << (64 - shift)) | (lo >> shift));
+#endif
+}
+
+// a * 2^shift / b rounded toward zero, kept to the width of the operands; b is not 0.
+inline int div(const int a, const int b, const int shift)
+{
+	return (int)(((long long)a * (1LL << shift)) / b);
+}
+inline long long div(const long long a, const long long b, const int shift)
+{
+#if defined(__SIZEOF_INT128__)
+	return (long long)(((__int128)a * ((__int128)1 << shift)) / b);
+#else
+	unsigned long long n = a < 0 ? 0 - (unsigned long long)a : (unsigned long long)a;
+	unsigned long long d = b < 0 ? 0 - (unsigned long long)b : (unsigned long long)b;
+	unsigned long long hi = n >> (64 - shift);
+	unsigned long long lo = n << shift;
+	unsigned long long q = 0;
+	unsigned long long r = 0;
+	for (int i = 127; i >= 0; i--)
+	{
+		r = (r << 1) | (i >= 64 ? (hi >> (i - 64)) & 1 : (lo >> i) & 1);
+		if (r >= d)
+		{
+			r -= d;
+			q |= i < 64 ? 1ULL << i : 0;
+		}
+	}
+
+	return (long long)((a < 0) != (b < 0) ? 0 - q : q);
+#endif
+}
+
+// The index of the highest set bit of x, which is not 0.
+inline int top(const unsigned long long x)
+{
+#if defined(__GNUC__)
+	return 63 - __builtin_clzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i;
+	_BitScanReverse64(&i, x);
+	return (int)i;
+#else
+	int r = 0;
+	for (unsigned long long y = x >> 1; y != 0; y >>= 1)
+	{
+		r++;
+	}
+
+	return r;
+#endif
+}
+
+// floor(sqrt(x)). The top eight bits of x pick a root rounded up from the table, which starts Newton
+// steps above the root with about eight bits right; from above the steps only come down, three or four
+// of them, and the first one that does not is the floor.
+inline unsigned long long isqrt(const unsigned long long x)
+{
+	// ceil(sqrt(k + 1) * 2^11) for k from 64 to 255
+	static const unsigned short roots[192] =
+	{
+		16512, 16639, 16764, 16889, 17012, 17135, 17257, 17378, 17499, 17618, 17737, 17855, 17972, 18088, 18204, 18318,
+		18432, 18546, 18659, 18771, 18882, 18993, 19103, 19212, 19321, 19430, 19537, 19644, 19751, 19857, 19962, 20067,
+		20171, 20275, 20378, 20480, 20583, 20684, 20785, 20886, 20986, 21086, 21185, 21284, 21382, 21480, 21578, 21674,
+		21771, 21867, 21963, 22058, 22153, 22247, 22342, 22435, 22528, 22621, 22714, 22806, 22898, 22989, 23080, 23171,
+		23261, 23351, 23441, 23530, 23619, 23708, 23796, 23884, 23972, 24059, 24146, 24233, 24319, 24405, 24491, 24576,
+		24662, 24747, 24831, 24915, 25000, 25083, 25167, 25250, 25333, 25416, 25498, 25580, 25662, 25743, 25825, 25906,
+		25987, 26067, 26148, 26228, 26308, 26387, 26466, 26546, 26624, 26703, 26782, 26860, 26938, 27015, 27093, 27170,
+		27247, 27324, 27401, 27477, 27554, 27630, 27705, 27781, 27856, 27931, 28006, 28081, 28156, 28230, 28304, 28378,
+		28452, 28526, 28599, 28672, 28746, 28818, 28891, 28964, 29036, 29108, 29180, 29252, 29323, 29395, 29466, 29537,
+		29608, 29679, 29749, 29820, 29890, 29960, 30030, 30100, 30169, 30239, 30308, 30377, 30446, 30515, 30584, 30652,
+		30720, 30789, 30857, 30925, 30992, 31060, 31127, 31195, 31262, 31329, 31396, 31462, 31529, 31596, 31662, 31728,
+		31794, 31860, 31926, 31991, 32057, 32122, 32187, 32252, 32317, 32382, 32447, 32511, 32576, 32640, 32704, 32768
+	};
+
+	if (x == 0)
+	{
+		return 0;
+	}
+
+	const int h = top(x) >> 1;
+	const int s = (2 * h) - 6;
+	const int k = (int)(s >= 0 ? x >> s : x << -s);
+	unsigned long long r = (((unsigned long long)roots[k - 64] << h) >> 14) + 1;
+	for (;;)
+	{
+		unsigned long long next = (r + (x / r)) >> 1;
+		if (next >= r)
+		{
+			return r;
+		}
+		r = next;
+	}
+}
+
+// floor(sqrt(x * 2^fraction)) for x at least 0 and fraction up to 32.
+inline int root(const int x, const int fraction)
+{
+	return (int)isqrt((unsigned long long)x << fraction);
+}
+inline long long root(const long long x, const int fraction)
+{
+	const int half = fraction >> 1;
+	const unsigned long long y = (unsigned long long)x << (fraction & 1);
+	if (half == 0 || (y >> (64 - (2 * half))) == 0)
+	{
+		return (long long)isqrt(y << (2 * half));
+	}
+
+	// y * 2^(2 * half) takes more than 64 bits. The root of y, shifted up, is within 2^half of its
+	// root, and y is at least 2^32 here, so one Newton step lands on the root or one above it.
+	const unsigned long long r0 = isqrt(y);
+	const unsigned long long r = ((r0 << half) + ((y / r0) << half) + (((y % r0) << half) / r0)) >> 1;
+	unsigned long long hi;
+	unsigned long long lo;
+	wide(r, r, hi, lo);
+	const unsigned long long yhi = y >> (64 - (2 * half));
+	const unsigned long long ylo = y << (2 * half);
+	return (long long)((hi > yhi) || (hi == yhi && lo > ylo) ? r - 1 : r);
+}
+
+// A quarter of a sine wave in Q32.32, built once from a Taylor series in Q3.61.
+struct table
+{
+	enum { segments = 1024 };
+
+	table()
+	{
+		const long long halfPi = 0x3243F6A8885A308DLL;
+		for (int k = 0; k <= segments; k++)
+		{
+			long long x = mul(halfPi, (long long)k << 51, 61);
+			long long x2 = mul(x, x, 61);
+			long long term = x;
+			long long sum = x;
+			for (int n = 1; n < 13; n++)
+			{
+				term = -mul(term, x2, 61) / ((2 * n) * ((2 * n) + 1));
+				sum += term;
+			}
+			this->sine[k] = (sum + (1LL << 28)) >> 29;
+		}
+	}
+
+	long long sine[segments + 1];
+};
+
+inline const long long* sines()
+{
+	static const table t;
+	return t.sine;
+}
+
+// Sine and cosine of a Q32.32 angle in radians, both in Q32.32. The angle is split into the nearest
+// table entry and a remainder of at most half a segment, which a second order expansion around that
+// entry takes care of; the result is within a few Q32.32 steps.
+inline void sincos(const long long angle, long long& s, long long& c)
+{
+	const long long halfPi = 0x3243F6A8885A308DLL;
+	const long long twoOverPi = 0x28BE60DB9391054ALL;
+	const long long* sine = sines();
+
+	long long k = (mul(angle, twoOverPi, 62) + (1LL << 21)) >> 22;
+	long long b = angle - mul(k, halfPi, 39);
+	long long h = mul(b, b, 33);
+	int index = (int)(k & (table::segments - 1));
+
+	long long si = sine[index];
+	long long ci = sine[table::segments - index];
+	long long sb = si + mul(b, ci, 32) - mul(h, si, 32);
+	long long cb = ci - mul(b, si, 32) - mul(h, ci, 32);
+	switch ((k >> 10) & 3)
+	{
+	case 0: s = sb; c = cb; break;
+	case 1: s = cb; c = -sb; break;
+	case 2: s = -sb; c = -cb; break;
+	default: s = -cb; c = sb; break;
+	}
+}
+
+}
+
+#if !(defined(tfixed) || defined(fixed32) || defined(fixed64))
+// A signed fixed point number with F fractional bits stored in S, int or long long, with F at most 32.
+// Conversions from float and double round to nearest, everything after that is integer arithmetic:
+// sums wrap, products and quotients round toward negative infinity and zero respectively, and division
+// by zero saturates, as do integers beyond range(). sqrt, sin, cos and tan below give the same bits on
+// every platform, so vectors and matrices of these can be stepped in lockstep on different machines.
+template <typename S, int F> struct tfixed
+{
+
+	inline GMATH_CONSTEXPR tfixed() : value(0) {}
+	inline GMATH_CONSTEXPR tfixed(const int x) : value((long long)x >= range() ? (std::numeric_limits<S>::max)() : (long long)x < -range() ? -(std::numeric_limits<S>::max)() : (S)x * ((S)1 << F)) {}
+	inline GMATH_CONSTEXPR tfixed(const float x) : value((S)(((double)x * (double)((S)1 << F)) + (x < 0.0f ? -0.5 : 0.5))) {}
+	inline GMATH_CONSTEXPR tfixed(const double x) : value((S)((x * (double)((S)1 << F)) + (x < 0.0 ? -0.5 : 0.5))) {}
+
+	// Integers from -range() to range() - 1 convert exactly.
+	static inline GMATH_CONSTEXPR long long range()
+	{
+		return 1LL << ((sizeof(S) * 8) - 1 - F);
+	}
+	static inline tfixed<S, F> bits(const S x)
+	{
+		tfixed<S, F> r;
+		r.value = x;
+		return r;
+	}
+
+	inline explicit operator int() const { return (int)(this->value / ((S)1 << F)); }
+	inline explicit operator float() const { return (float)((double)this->value / (double)((S)1 << F)); }
+	inline explicit operator double() const { return (double)this->value / (double)((S)1 << F); }
+
+	inline tfixed<S, F>& operator+=(const tfixed<S, F>& x)
+	{
+		this->value = fixedpoint::add(this->value, x.value);
+		return *this;
+	}
+	inline tfixed<S, F>& operator-=(const tfixed<S, F>& x)
+	{
+		this->value = fixedpoint::sub(this->value, x.value);
+		return *this;
+	}
+	inline tfixed<S, F>& operator*=(const tfixed<S, F>& x)
+	{
+		this->value = fixedpoint::mul(this->value, x.value, F);
+		return *this;
+	}
+	inline tfixed<S, F>& operator/=(const tfixed<S, F>& x)
+	{
+		if (x.value == 0)
+		{
+			this->value = this->value < 0 ? -(std::numeric_limits<S>::max)() : (std::numeric_limits<S>::max)();
+			return *this;
+		}
+
+		this->value = fixedpoint::div(this->value, x.value, F);
+		return *this;
+	}
+
+	inline tfixed<S, F> operator-() const { return bits(fixedpoint::sub((S)0, this->value)); }
+	inline tfixed<S, F> operator+() const { return *this; }
+
+	friend inline tfixed<S, F> operator+(tfixed<S, F> a, const tfixed<S, F>& b) { return a += b; }
+	friend inline tfixed<S, F> operator-(tfixed<S, F> a, const tfixed<S, F>& b) { return a -= b; }
+	friend inline tfixed<S, F> operator*(tfixed<S, F> a, const tfixed<S, F>& b) { return a *= b; }
+	friend inline tfixed<S, F> operator/(tfixed<S, F> a, const tfixed<S, F>& b) { return a /= b; }
+
+	friend inline bool operator==(const tfixed<S, F>& a, const tfixed<S, F>& b) { return a.value == b.value; }
+	friend inline bool operator!=(const tfixed<S, F>& a, const tfixed<S, F>& b) { return a.value != b.value; }
+	friend inline bool operator<(const tfixed<S, F>& a, const tfixed<S, F>& b) { return a.value < b.value; }
+	friend inline bool operator<=(const tfixed<S, F>& a, const tfixed<S, F>& b) { return a.value <= b.value; }
+	friend inline bool operator>(const tfixed<S, F>& a, const tfixed<S, F>& b) { return a.value > b.value; }
+	friend inline bool operator>=(const tfixed<S, F>& a, const tfixed<S, F>& b) { return a.value >= b.value; }
+
+	S value;
+
+};
+
+namespace fixedpoint
+{
+
+template <typename S, int F> inline long long widen(const tfixed<S, F>& x)
+{
+	return (long long)x.value * (1LL << (32 - F));
+}
+template <typename S, int F> inline tfixed<S, F> narrow(const long long x)
+{
+	return tfixed<S, F>::bits((S)((x + ((1LL << (32 - F)) >> 1)) >> (32 - F)));
+}
+
+}
+
+template <typename S, int F> inline tfixed<S, F> abs(const tfixed<S, F>& x)
+{
+	return x.value < 0 ? -x : x;
+}
+
+// Negative numbers have no root and give 0.
+template <typename S, int F> inline tfixed<S, F> sqrt(const tfixed<S, F>& x)
+{
+	if (x.value <= 0)
+	{
+		return tfixed<S, F>();
+	}
+
+	return tfixed<S, F>::bits(fixedpoint::root(x.value, F));
+}
+
+// One reciprocal for all the components instead of a quotient each. With the length m in [2^L, 2^(L + 1)),
+// q = 2^(B + L) / m always keeps B - 1 significant bits, and each component is a product and a shift,
+// within a step of the exact quotient.
+template <int N, typename S, int F> inline tvec<N, tfixed<S, F> > normalize(const tvec<N, tfixed<S, F> >& v)
+{
+	const int B = ((int)sizeof(S) * 8) - 2;
+	const tfixed<S, F> d = dot(v, v);
+	tvec<N, tfixed<S, F> > r;
+	if (d.value <= 0)
+	{
+		return r;
+	}
+
+	const S m = fixedpoint::root(d.value, F);
+	const int L = fixedpoint::top((unsigned long long)m);
+	const S q = fixedpoint::div((S)1 << (B - 1), m, L + 1);
+	const int shift = B + L - F;
+	tlanes<N>::each([&](const int i) {
+		r[i] = tfixed<S, F>::bits(shift < 64 ? fixedpoint::mul(v[i].value, q, shift) : fixedpoint::mul(v[i].value, q, 63) >> (shift - 63));
+	});
+	return r;
+}
+
+template <typename S, int F> inline tfixed<S, F> sin(const tfixed<S, F>& x)
+{
+	long long s;
+	long long c;
+	fixedpoint::sincos(fixedpoint::widen(x), s, c);
+	return fixedpoint::narrow<S, F>(s);
+}
+template <typename S, int F> inline tfixed<S, F> cos(const tfixed<S, F>& x)
+{
+	long long s;
+	long long c;
+	fixedpoint::sincos(fixedpoint::widen(x), s, c);
+	return fixedpoint::narrow<S, F>(c);
+}
+template <typename S, int F> inline tfixed<S, F> tan(const tfixed<S, F>& x)
+{
+	long long s;
+	long long c;
+	fixedpoint::sincos(fixedpoint::widen(x), s, c);
+	return fixedpoint::narrow<S, F>(s) / fixedpoint::narrow<S, F>(c);
+}
+
+// The constant-foldable double versions would go through the FPU.
+template <typename S, int F> inline tfixed<S, F> csin(const tfixed<S, F>& x) { return sin(x); }
+template <typename S, int F> inline tfixed<S, F> ccos(const tfixed<S, F>& x) { return cos(x); }
+template <typename S, int F> inline tfixed<S, F> ctan(const tfixed<S, F>& x) { return tan(x); }
+
+typedef tfixed<int, 16> fixed32;
+typedef tfixed<long long, 32> fixed64;
+
+// Q16.16 kernels on integer registers. Integer sums do not depend on their order, so these give the
+// same bits as the scalar templates they replace.
+#if defined(GMATH_SSE41)
+namespace simd
+{
+
+inline __m128i load(const tvec4<fixed32>& v)
+{
+	return _mm_loadu_si128((const __m128i*)&v);
+}
+inline tvec4<fixed32> store(const __m128i x)
+{
+	tvec4<fixed32> v;
+	_mm_storeu_si128((__m128i*)&v, x);
+	return v;
+}
+inline __m128i column(const tmat4x4<fixed32>& m, const int index)
+{
+	return _mm_loadu_si128((const __m128i*)&m._columns[index]);
+}
+// Bits 16 to 47 of each 64 bit product, the even lanes shifted down and the odd ones up into place.
+inline __m128i mul16(const __m128i a, const __m128i b)
+{
+	__m128i even = _mm_srli_epi64(_mm_mul_epi32(a, b), 16);
+	__m128i odd = _mm_slli_epi64(_mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32)), 16);
+	return _mm_blend_epi16(even, odd, 0xCC);
+}
+inline __m128i transform(const tmat4x4<fixed32>& m, const __m128i v)
+{
+	__m128i r = mul16(column(m, 0), _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 0, 0, 0)));
+	r = _mm_add_epi32(r, mul16(column(m, 1), _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 1, 1))));
+	r = _mm_add_epi32(r, mul16(column(m, 2), _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 2, 2))));
+	return _mm_add_epi32(r, mul16(column(m, 3), _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3))));
+}
+inline void store3(tvec3<fixed32>& v, const __m128i x)
+{
+	_mm_storel_epi64((__m128i*)&v, x);
+	v.z.value = _mm_extract_epi32(x, 2);
+}
+
+#if defined(GMATH_AVX2)
+inline __m256i mul16(const __m256i a, const __m256i b)
+{
+	__m256i even = _mm256_srli_epi64(_mm256_mul_epi32(a, b), 16);
+	__m256i odd = _mm256_slli_epi64(_mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32)), 16);
+	return _mm256_blend_epi16(even, odd, 0xCC);
+}
+inline __m256i broadcast(const tvec4<fixed32>& v)
+{
+	return _mm256_broadcastsi128_si256(load(v));
+}
+inline __m256i load3x2(const tvec3<fixed32>* v)
+{
+	return _mm256_castps_si256(native::load3x2((const tvec3<float>*)v));
+}
+inline void store3x2(tvec3<fixed32>* v, const __m256i x)
+{
+	native::store3x2((tvec3<float>*)v, _mm256_castsi256_ps(x));
+}
+#endif
+
+}
+
+inline tvec4<fixed32> operator+(const tvec4<fixed32>& v0, const tvec4<fixed32>& v1)
+{
+	return simd::store(_mm_add_epi32(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<fixed32> operator-(const tvec4<fixed32>& v0, const tvec4<fixed32>& v1)
+{
+	return simd::store(_mm_sub_epi32(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<fixed32> operator*(const tvec4<fixed32>& v0, const tvec4<fixed32>& v1)
+{
+	return simd::store(simd::mul16(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<fixed32> operator*(const tvec4<fixed32>& v, const fixed32 x)
+{
+	return simd::store(simd::mul16(simd::load(v), _mm_set1_epi32(x.value)));
+}
+inline tvec4<fixed32> operator*(const tmat4x4<fixed32>& m, const tvec4<fixed32>& v)
+{
+	return simd::store(simd::transform(m, simd::load(v)));
+}
+inline tmat4x4<fixed32> operator*(const tmat4x4<fixed32>& m0, const tmat4x4<fixed32>& m1)
+{
+	tmat4x4<fixed32> r;
+	for (int i = 0; i < 4; i++)
+	{
+		_mm_storeu_si128((__m128i*)&r._columns[i], simd::transform(m0, simd::column(m1, i)));
+	}
+
+	return r;
+}
+
+inline void transformPoints(const tmat4x4<fixed32>& m, const tvec3<fixed32>* in, tvec3<fixed32>* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_AVX2)
+	const __m256i w0 = simd::broadcast(m._columns[0]);
+	const __m256i w1 = simd::broadcast(m._columns[1]);
+	const __m256i w2 = simd::broadcast(m._columns[2]);
+	const __m256i w3 = simd::broadcast(m._columns[3]);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m256i v = simd::load3x2(in + i);
+		__m256i r = _mm256_add_epi32(w3, simd::mul16(w0, _mm256_shuffle_epi32(v, _MM_SHUFFLE(0, 0, 0, 0))));
+		r = _mm256_add_epi32(r, simd::mul16(w1, _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 1, 1))));
+		r = _mm256_add_epi32(r, simd::mul16(w2, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 2, 2))));
+		simd::store3x2(out + i, r);
+	}
+#endif
+	const __m128i c0 = simd::column(m, 0);
+	const __m128i c1 = simd::column(m, 1);
+	const __m128i c2 = simd::column(m, 2);
+	const __m128i c3 = simd::column(m, 3);
+	for (; i < count; i++)
+	{
+		__m128i r = _mm_add_epi32(c3, simd::mul16(c0, _mm_set1_epi32(in[i].x.value)));
+		r = _mm_add_epi32(r, simd::mul16(c1, _mm_set1_epi32(in[i].y.value)));
+		r = _mm_add_epi32(r, simd::mul16(c2, _mm_set1_epi32(in[i].z.value)));
+		simd::store3(out[i], r);
+	}
+}
+inline void transformVectors(const tmat4x4<fixed32>& m, const tvec3<fixed32>* in, tvec3<fixed32>* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_AVX2)
+	const __m256i w0 = simd::broadcast(m._columns[0]);
+	const __m256i w1 = simd::broadcast(m._columns[1]);
+	const __m256i w2 = simd::broadcast(m._columns[2]);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m256i v = simd::load3x2(in + i);
+		__m256i r = simd::mul16(w0, _mm256_shuffle_epi32(v, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm256_add_epi32(r, simd::mul16(w1, _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 1, 1, 1))));
+		r = _mm256_add_epi32(r, simd::mul16(w2, _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 2, 2, 2))));
+		simd::store3x2(out + i, r);
+	}
+#endif
+	const __m128i c0 = simd::column(m, 0);
+	const __m128i c1 = simd::column(m, 1);
+	const __m128i c2 = simd::column(m, 2);
+	for (; i < count; i++)
+	{
+		__m128i r = simd::mul16(c0, _mm_set1_epi32(in[i].x.value));
+		r = _mm_add_epi32(r, simd::mul16(c1, _mm_set1_epi32(in[i].y.value)));
+		r = _mm_add_epi32(r, simd::mul16(c2, _mm_set1_epi32(in[i].z.value)));
+		simd::store3(out[i], r);
+	}
+}
+inline void transform4(const tmat4x4<fixed32>& m, const tvec4<fixed32>* in, tvec4<fixed32>* out, const size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		out[i] = simd::store(simd::transform(m, simd::load(in[i])));
+	}
+}
+#endif
+#endif
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,241 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <gmath.hpp>
+#include <batch.hpp>
+
+namespace gmath
+{
+
+#if !(defined(tviewfrustum) || defined(viewfrustum))
+template <typename T> class tviewfrustum
+{
+public:
+
+	enum { left = 0, right, bottom, top, nearZ, farZ, count };
+
+	tviewfrustum() {}
+	tviewfrustum(const tmat4x4<T>& viewProjection)
+	{
+		this->set(viewProjection);
+	}
+	~tviewfrustum() {}
+
+	void set(const tmat4x4<T>& viewProjection)
+	{
+		// Gribb-Hartmann: each plane is the last row of the matrix plus or minus one of the others
+		const tmat4x4<T>& m = viewProjection;
+		tvec4<T> r0(m._columns[0].x, m._columns[1].x, m._columns[2].x, m._columns[3].x);
+		tvec4<T> r1(m._columns[0].y, m._columns[1].y, m._columns[2].y, m._columns[3].y);
+		tvec4<T> r2(m._columns[0].z, m._columns[1].z, m._columns[2].z, m._columns[3].z);
+		tvec4<T> r3(m._columns[0].w, m._columns[1].w, m._columns[2].w, m._columns[3].w);
+
+		this->_planes[left] = r3 + r0;
+		this->_planes[right] = r3 - r0;
+		this->_planes[bottom] = r3 + r1;
+		this->_planes[top] = r3 - r1;
+		this->_planes[nearZ] = r3 + r2;
+		this->_planes[farZ] = r3 - r2;
+		for (int i = 0; i < count; i++)
+		{
+			tvec4<T>& p = this->_planes[i];
+			p = p / magnitude(tvec3<T>(p.x, p.y, p.z));
+		}
+	}
+
+	const tvec4<T>& plane(const int index) const
+	{
+		return this->_planes[index % count];
+	}
+
+	T distance(const int index, const tvec3<T>& p) const
+	{
+		const tvec4<T>& plane = this->_planes[index % count];
+		return (plane.x * p.x) + (plane.y * p.y) + (plane.z * p.z) + plane.w;
+	}
+	bool contains(const tvec3<T>& p) const
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (this->distance(i, p) < (T)0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+	bool intersects(const tvec4<T>& sphere) const
+	{
+		tvec3<T> center(sphere.x, sphere.y, sphere.z);
+		for (int i = 0; i < count; i++)
+		{
+			if (this->distance(i, center) < -sphere.w)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+	bool intersects(const tvec3<T>& min, const tvec3<T>& max) const
+	{
+		for (int i = 0; i < count; i++)
+		{
+			const tvec4<T>& p = this->_planes[i];
+			tvec3<T> corner = select(lessThan(tvec3<T>(p.x, p.y, p.z), tvec3<T>((T)0)), min, max);
+			if (this->distance(i, corner) < (T)0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+private:
+
+	tvec4<T> _planes[count];
+
+};
+
+namespace batch
+{
+
+template <typename L, typename T> inline typename L::mask cullSphere(const L* planes, const tvec4<T>* spheres)
+{
+	L s[4];
+	simd::gather(spheres, s);
+
+	L radius = -s[3];
+	typename L::mask visible = madd(planes[2], s[2], madd(planes[1], s[1], madd(planes[0], s[0], planes[3]))) >= radius;
+	for (int i = 1; i < 6; i++)
+	{
+		const L* p = planes + (i * 4);
+		visible = visible & (madd(p[2], s[2], madd(p[1], s[1], madd(p[0], s[0], p[3]))) >= radius);
+	}
+
+	return visible;
+}
+template <typename L, typename T> inline typename L::mask cullBox(const L* planes, const bool* side, const tvec3<T>* min, const tvec3<T>* max)
+{
+	L b0[3];
+	L b1[3];
+	simd::gather(min, b0);
+	simd::gather(max, b1);
+
+	// the corner furthest along each plane normal decides, picked per plane rather than per box
+	const L zero((T)0);
+	typename L::mask visible = zero == zero;
+	for (int i = 0; i < 6; i++)
+	{
+		const L* p = planes + (i * 4);
+		const bool* s = side + (i * 3);
+		L x = s[0] ? b0[0] : b1[0];
+		L y = s[1] ? b0[1] : b1[1];
+		L z = s[2] ? b0[2] : b1[2];
+		visible = visible & (madd(p[2], z, madd(p[1], y, madd(p[0], x, p[3]))) >= zero);
+	}
+
+	return visible;
+}
+
+template <typename L, typename T> inline void broadcast(const tviewfrustum<T>& f, L* planes)
+{
+	for (int i = 0; i < 6; i++)
+	{
+		const tvec4<T>& p = f.plane(i);
+		planes[(i * 4) + 0] = L(p.x);
+		planes[(i * 4) + 1] = L(p.y);
+		planes[(i * 4) + 2] = L(p.z);
+		planes[(i * 4) + 3] = L(p.w);
+	}
+}
+
+}
+
+// Bit (i % 32) of visible[i / 32] is set when sphere i (center, radius) touches the frustum.
+// Spheres are tested a SIMD register at a time; a partial last word has its unused bits cleared.
+template <typename T> inline void cullSpheres(const tviewfrustum<T>& f, const tvec4<T>* spheres, unsigned int* visible, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	L planes[24];
+	batch::broadcast(f, planes);
+
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		unsigned int word = 0;
+		for (int k = 0; k < 32; k += L::width)
+		{
+			word |= (unsigned int)simd::bits(batch::cullSphere<L>(planes, spheres + i + k)) << k;
+		}
+		visible[i >> 5] = word;
+	}
+	if (i < count)
+	{
+		unsigned int word = 0;
+		for (int k = 0; i + k < count; k++)
+		{
+			word |= f.intersects(spheres[i + k]) ? (1u << k) : 0u;
+		}
+		visible[i >> 5] = word;
+	}
+}
+// Same layout as cullSpheres, for boxes given as separate min and max corner arrays.
+template <typename T> inline void cullBoxes(const tviewfrustum<T>& f, const tvec3<T>* min, const tvec3<T>* max, unsigned int* visible, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	L planes[24];
+	bool side[18];
+	batch::broadcast(f, planes);
+	for (int i = 0; i < 6; i++)
+	{
+		const tvec4<T>& p = f.plane(i);
+		side[(i * 3) + 0] = p.x < (T)0;
+		side[(i * 3) + 1] = p.y < (T)0;
+		side[(i * 3) + 2] = p.z < (T)0;
+	}
+
+	size_t i = 0;
+	for (; i + 32 <= count; i += 32)
+	{
+		unsigned int word = 0;
+		for (int k = 0; k < 32; k += L::width)
+		{
+			word |= (unsigned int)simd::bits(batch::cullBox<L>(planes, side, min + i + k, max + i + k)) << k;
+		}
+		visible[i >> 5] = word;
+	}
+	if (i < count)
+	{
+		unsigned int word = 0;
+		for (int k = 0; i + k < count; k++)
+		{
+			word |= f.intersects(min[i + k], max[i + k]) ? (1u << k) : 0u;
+		}
+		visible[i >> 5] = word;
+	}
+}
+
+template <typename T> inline void cullSpheres(const tviewfrustum<T>& f, const tvec4<T>* spheres, unsigned int* visible, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		cullSpheres(f, spheres + begin, visible + (begin >> 5), end - begin);
+	});
+}
+template <typename T> inline void cullBoxes(const tviewfrustum<T>& f, const tvec3<T>* min, const tvec3<T>* max, unsigned int* visible, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		cullBoxes(f, min + begin, max + begin, visible + (begin >> 5), end - begin);
+	});
+}
+
+typedef tviewfrustum<float> viewfrustum;
+#endif
+
+}
+
+#endif
\ No newline at end of file
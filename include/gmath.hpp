@@ -6,11 +6,41 @@
 #include <math.h>
 #include <float.h>
 #include <string.h>
+#include <type_traits>
 
 #include <fuzzy.hpp>
 #include <ray.hpp>
 #include <box.hpp>
 
+#if !defined(GMATH_CONSTEXPR)
+#if (__cplusplus >= 201402L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+#define GMATH_CONSTEXPR constexpr
+#else
+#define GMATH_CONSTEXPR
+#endif
+#endif
+
+// Only asked where the trig functions can be constexpr, before C++14 they always call libm.
+#if !defined(GMATH_CONSTANT_EVALUATED) && ((__cplusplus >= 201402L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L))
+#if defined(__cpp_lib_is_constant_evaluated)
+#define GMATH_CONSTANT_EVALUATED() std::is_constant_evaluated()
+#elif defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define GMATH_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#elif (defined(__GNUC__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define GMATH_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#endif
+#endif
+
+#if !defined(GMATH_ALIGN)
+#if defined(_MSC_VER)
+#define GMATH_ALIGN(n) __declspec(align(n))
+#else
+#define GMATH_ALIGN(n) __attribute__((aligned(n)))
+#endif
+#endif
+
 namespace gmath
 {
 
@@ -69,150 +99,175 @@ template <typename T> inline T abs(T x)
 #endif
 
 #if !defined(radians)
-template <typename T> inline T radians(T angle) { return angle * ((T)PI / (T)180); }
+template <typename T> inline GMATH_CONSTEXPR T radians(T angle) { return angle * ((T)PI / (T)180); }
 #endif
 
 #if !defined(degrees)
-template <typename T> inline T degrees(T angle) { return angle * ((T)180 / (T)PI); }
+template <typename T> inline GMATH_CONSTEXPR T degrees(T angle) { return angle * ((T)180 / (T)PI); }
 #endif
 
-#if !(defined(tvec2) || defined(tvec3) || defined(tvec4) || defined(vec2) || defined(vec3) || defined(vec4) || defined(ivec2) || defined(ivec3) || defined(ivec4))
-template <typename T> struct tvec2;
-template <typename T> struct tvec3;
-template <typename T> struct tvec4;
-
-template <typename T> struct tvec2
+#if !(defined(csin) || defined(ccos) || defined(ctan))
+// Compile-time capable sin/cos/tan in double precision. In constant evaluation these
+// reduce to [-pi/4, pi/4] with a three part pi/2 and sum the Taylor series, within
+// 3 ulp of libm (4 for ctan) for |x| < 2^19 * pi/2, so builders fed with constants
+// fold to static data. At runtime, or where constant evaluation cannot be detected, they call libm.
+inline GMATH_CONSTEXPR double cquadrant(const double x, int& quadrant)
 {
-
-	inline tvec2() : x((T)0), y((T)0) {}
-	inline tvec2(const T x) : x(x), y(x) {}
-	inline tvec2(const T x, const T y) : x(x), y(y) {}
-	inline tvec2(const tvec2<T>& v) : x(v.x), y(v.y) {}
-	inline tvec2(const tvec3<T>& v) : x(v.x), y(v.y) {}
-	inline tvec2(const tvec4<T>& v) : x(v.x), y(v.y) {}
-	inline ~tvec2() {}
-
-	template <typename U> inline tvec2(const tvec2<U>& v) : x((T)v.x), y((T)v.y) {}
-	template <typename U> inline tvec2(const tvec3<U>& v) : x((T)v.x), y((T)v.y) {}
-	template <typename U> inline tvec2(const tvec4<U>& v) : x((T)v.x), y((T)v.y) {}
-
-	inline const int length() const
+	double t = x * 0.63661977236758134308;
+	long long k = (long long)(t + (t < 0.0 ? -0.5 : 0.5));
+	quadrant = (int)(k & 3);
+	double d = (double)k;
+	return (((x - (d * 1.57079632673412561417e+00)) - (d * 6.07710050630396597660e-11)) - (d * 2.02226624871116645580e-21)) - (d * 8.47842766036889956997e-32);
+}
+inline GMATH_CONSTEXPR double csinr(const double r)
+{
+	double r2 = r * r;
+	double sum = 1.0;
+	for (int i = 17; i > 1; i -= 2)
 	{
-		return 2;
+		sum = 1.0 - ((r2 / (double)(i * (i - 1))) * sum);
 	}
 
-	inline void operator=(const tvec2<T>& v)
-	{
-		this->x = v.x;
-		this->y = v.y;
-	}
-	inline operator T*() const
-	{
-		return (T*)this;
-	}
-	inline tvec2<T> operator+() const
-	{
-		return tvec2<T>(+this->x, +this->y);
-	}
-	inline tvec2<T> operator-() const
-	{
-		return tvec2<T>(-this->x, -this->y);
-	}
-	inline void operator+=(const tvec2<T>& v)
+	return r * sum;
+}
+inline GMATH_CONSTEXPR double ccosr(const double r)
+{
+	double r2 = r * r;
+	double sum = 1.0;
+	for (int i = 18; i > 0; i -= 2)
 	{
-		this->x += v.x;
-		this->y += v.y;
+		sum = 1.0 - ((r2 / (double)(i * (i - 1))) * sum);
 	}
-	inline void operator+=(const T& x)
+
+	return sum;
+}
+inline GMATH_CONSTEXPR double csin(const double x)
+{
+#if defined(GMATH_CONSTANT_EVALUATED)
+	if (!GMATH_CONSTANT_EVALUATED())
 	{
-		this->x += x;
-		this->y += x;
+		return ::sin(x);
 	}
-	inline void operator-=(const tvec2<T>& v)
+#else
+	return ::sin(x);
+#endif
+	int quadrant = 0;
+	double r = cquadrant(x, quadrant);
+	switch (quadrant)
 	{
-		this->x -= v.x;
-		this->y -= v.y;
+	case 0:
+		return csinr(r);
+	case 1:
+		return ccosr(r);
+	case 2:
+		return -csinr(r);
+	default:
+		return -ccosr(r);
 	}
-	inline void operator-=(const T& x)
+}
+inline GMATH_CONSTEXPR double ccos(const double x)
+{
+#if defined(GMATH_CONSTANT_EVALUATED)
+	if (!GMATH_CONSTANT_EVALUATED())
 	{
-		this->x -= x;
-		this->y -= x;
+		return ::cos(x);
 	}
-	inline void operator*=(const tvec2<T>& v)
+#else
+	return ::cos(x);
+#endif
+	int quadrant = 0;
+	double r = cquadrant(x, quadrant);
+	switch (quadrant)
 	{
-		this->x *= v.x;
-		this->y *= v.y;
+	case 0:
+		return ccosr(r);
+	case 1:
+		return -csinr(r);
+	case 2:
+		return -ccosr(r);
+	default:
+		return csinr(r);
 	}
-	inline void operator*=(const T& x)
+}
+inline GMATH_CONSTEXPR double ctan(const double x)
+{
+#if defined(GMATH_CONSTANT_EVALUATED)
+	if (!GMATH_CONSTANT_EVALUATED())
 	{
-		this->x *= x;
-		this->y *= x;
+		return ::tan(x);
 	}
-	inline void operator/=(const tvec2<T>& v)
-	{
-#if 0
-		this->x = v.x != (T)0 ? this->x / v.x : (T)0;
-		this->y = v.y != (T)0 ? this->y / v.y : (T)0;
 #else
-		this->x /= v.x;
-		this->y /= v.y;
+	return ::tan(x);
 #endif
-	}
-	inline void operator/=(const T& x)
-	{
-#if 0
-		this->x = x != (T)0 ? this->x / x : (T)0;
-		this->y = y != (T)0 ? this->y / x : (T)0;
-#else
-		this->x /= x;
-		this->y /= x;
+	return csin(x) / ccos(x);
+}
 #endif
-	}
-	inline void operator%=(const tvec2<T>& v)
-	{
-		return tvec2<T>(module(this->x, v.x), module(this->y, v.y));
-	}
-	inline void operator%=(const T& x)
-	{
-		return tvec2<T>(module(this->x, x), module(this->y, x));
-	}
-	inline bool operator==(const tvec2<T>& v) const
-	{
-		return (this->x == v.x) && (this->y == v.y);
-	}
-	inline bool operator!=(const tvec2<T>& v) const
-	{
-		return (this->x != v.x) && (this->y != v.y);
-	}
-	inline bool operator>(const tvec2<T>& v) const
-	{
-		return (this->x > v.x) && (this->y > v.y);
-	}
-	inline bool operator<(const tvec2<T>& v) const
-	{
-		return (this->x < v.x) && (this->y < v.y);
-	}
-	inline bool operator>=(const tvec2<T>& v) const
-	{
-		return (this->x >= v.x) && (this->y >= v.y);
-	}
-	inline bool operator<=(const tvec2<T>& v) const
+
+#if !(defined(tvec2) || defined(tvec3) || defined(tvec4) || defined(vec2) || defined(vec3) || defined(vec4) || defined(ivec2) || defined(ivec3) || defined(ivec4))
+template <int N, typename T> struct tvec;
+template <typename T> using tvec2 = tvec<2, T>;
+template <typename T> using tvec3 = tvec<3, T>;
+template <typename T> using tvec4 = tvec<4, T>;
+
+// Calls f(0) .. f(N - 1) as straight code, the lane loops of the small widths are not unrolled at -O2.
+template <int N> struct tlanes
+{
+	template <typename F> static inline void each(const F& f)
 	{
-		return (this->x <= v.x) && (this->y <= v.y);
+		tlanes<N - 1>::each(f);
+		f(N - 1);
 	}
-	inline tvec2<T> operator&&(const tvec2<T>& v) const
+};
+template <> struct tlanes<0>
+{
+	template <typename F> static inline void each(const F&) {}
+};
+
+// Empty base that raises the alignment of the wide tvec, MSVC only takes a literal in __declspec(align).
+template <int A> struct tvecalign {};
+template <> struct GMATH_ALIGN(8) tvecalign<8> {};
+template <> struct GMATH_ALIGN(16) tvecalign<16> {};
+template <> struct GMATH_ALIGN(32) tvecalign<32> {};
+template <> struct GMATH_ALIGN(64) tvecalign<64> {};
+
+// Storage of tvec. Widths 2, 3 and 4 keep their named components, the others are a plain array
+// aligned to its size when that is a power of two up to a cache line, whatever the ISA flags are.
+// Before C++17 new and std::vector ignore that alignment, so the wide loads stay unaligned ones.
+template <int N, typename T> struct tvecdata : tvecalign<((N & (N - 1)) == 0) && (N * sizeof(T) <= 64) ? (int)(N * sizeof(T)) : 0>
+{
+
+	inline GMATH_CONSTEXPR tvecdata() : _data() {}
+	inline tvecdata(const T x)
 	{
-		return tvec2<T>(min(this->x, v.x), min(this->y, v.y));
+		tlanes<N>::each([&](const int i) { this->_data[i] = x; });
 	}
-	inline tvec2<T> operator||(const tvec2<T>& v) const
+	inline tvecdata(const T* p)
 	{
-		return tvec2<T>(max(this->x, v.x), max(this->y, v.y));
+		tlanes<N>::each([&](const int i) { this->_data[i] = p[i]; });
 	}
-	inline T& operator[](const int index)
+
+	template <typename U> inline tvecdata(const tvec<N, U>& v)
 	{
-		return ((T*)this)[index % this->length()];
+		tlanes<N>::each([&](const int i) { this->_data[i] = (T)v[i]; });
 	}
 
+	T _data[N];
+
+};
+
+template <typename T> struct tvecdata<2, T>
+{
+
+	inline GMATH_CONSTEXPR tvecdata() : x((T)0), y((T)0) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x) : x(x), y(x) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x, const T y) : x(x), y(y) {}
+	inline GMATH_CONSTEXPR tvecdata(const tvec3<T>& v) : x(v.x), y(v.y) {}
+	inline GMATH_CONSTEXPR tvecdata(const tvec4<T>& v) : x(v.x), y(v.y) {}
+
+	template <typename U> inline GMATH_CONSTEXPR tvecdata(const tvec2<U>& v) : x((T)v.x), y((T)v.y) {}
+	template <typename U> inline GMATH_CONSTEXPR tvecdata(const tvec3<U>& v) : x((T)v.x), y((T)v.y) {}
+	template <typename U> inline GMATH_CONSTEXPR tvecdata(const tvec4<U>& v) : x((T)v.x), y((T)v.y) {}
+
 	union
 	{
 		T x, u, s, r;
@@ -225,148 +280,50 @@ template <typename T> struct tvec2
 
 };
 
-template <typename T> struct tvec3
+template <typename T> struct tvecdata<3, T>
 {
 
-	inline tvec3() : x((T)0), y((T)0), z((T)0) {}
-	inline tvec3(const T x) : x(x), y(x), z(x) {}
-	inline tvec3(const T x, const T y, const T z) : x(x), y(y), z(z) {}
-	inline tvec3(const tvec2<T>& v, const T z) : x(v.x), y(v.y), z(z) {}
-	inline tvec3(const T x, const tvec2<T>& v) : x(x), y(v.x), z(v.y) {}
-	inline tvec3(const tvec3<T>& v) : x(v.x), y(v.y), z(v.z) {}
-	inline tvec3(const tvec4<T>& v) : x(v.x), y(v.y), z(v.z) {}
-	inline ~tvec3() {}
+	inline GMATH_CONSTEXPR tvecdata() : x((T)0), y((T)0), z((T)0) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x) : x(x), y(x), z(x) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x, const T y, const T z) : x(x), y(y), z(z) {}
+	inline GMATH_CONSTEXPR tvecdata(const tvec2<T>& v, const T z) : x(v.x), y(v.y), z(z) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x, const tvec2<T>& v) : x(x), y(v.x), z(v.y) {}
+	inline GMATH_CONSTEXPR tvecdata(const tvec4<T>& v) : x(v.x), y(v.y), z(v.z) {}
 
-	template <typename U> inline tvec3(const tvec3<U>& v) : x((T)v.x), y((T)v.y), z((T)v.z) {}
-	template <typename U> inline tvec3(const tvec4<U>& v) : x((T)v.x), y((T)v.y), z((T)v.z) {}
+	template <typename U> inline GMATH_CONSTEXPR tvecdata(const tvec3<U>& v) : x((T)v.x), y((T)v.y), z((T)v.z) {}
+	template <typename U> inline GMATH_CONSTEXPR tvecdata(const tvec4<U>& v) : x((T)v.x), y((T)v.y), z((T)v.z) {}
 
-	inline const int length() const
+	union
 	{
-		return 3;
-	}
+		T x, u, s, r;
+	};
 
-	inline void operator=(const tvec3<T>& v)
-	{
-		this->x = v.x;
-		this->y = v.y;
-		this->z = v.z;
-	}
-	inline operator T*() const
-	{
-		return (T*)this;
-	}
-	inline tvec3<T> operator+() const
-	{
-		return tvec3<T>(+this->x, +this->y, +this->z);
-	}
-	inline tvec3<T> operator-() const
-	{
-		return tvec3<T>(-this->x, -this->y, -this->z);
-	}
-	inline void operator+=(const tvec3<T>& v)
-	{
-		this->x += v.x;
-		this->y += v.y;
-		this->z += v.z;
-	}
-	inline void operator+=(const T x)
-	{
-		this->x += x;
-		this->y += x;
-		this->z += x;
-	}
-	inline void operator-=(const tvec3<T>& v)
-	{
-		this->x -= v.x;
-		this->y -= v.y;
-		this->z -= v.z;
-	}
-	inline void operator-=(const T x)
-	{
-		this->x -= x;
-		this->y -= x;
-		this->z -= x;
-	}
-	inline void operator*=(const tvec3<T>& v)
-	{
-		this->x *= v.x;
-		this->y *= v.y;
-		this->z *= v.z;
-	}
-	inline void operator*=(const T x)
-	{
-		this->x *= x;
-		this->y *= x;
-		this->z *= x;
-	}
-	inline void operator/=(const tvec3<T>& v)
-	{
-#if 1
-		this->x = v.x != (T)0 ? this->x / v.x : (T)0;
-		this->y = v.y != (T)0 ? this->y / v.y : (T)0;
-		this->z = v.z != (T)0 ? this->z / v.z : (T)0;
-#else
-		this->x /= v.x;
-		this->y /= v.y;
-		this->z /= v.z;
-#endif
-	}
-	inline void operator/=(const T x)
-	{
-#if 0
-		this->x = x != (T)0 ? this->x / x : (T)0;
-		this->y = x != (T)0 ? this->y / x : (T)0;
-		this->z = x != (T)0 ? this->z / x : (T)0;
-#else
-		this->x /= x;
-		this->y /= x;
-		this->z /= x;
-#endif
-	}
-	inline void operator%=(const tvec3<T>& v)
-	{
-		return tvec3<T>(module(this->x, v.x), module(this->y, v.y), module(this->z, v.z));
-	}
-	inline void operator%=(const T& x)
-	{
-		return tvec3<T>(module(this->x, x), module(this->y, x), module(this->z, x));
-	}
-	inline bool operator==(const tvec3<T>& v) const
-	{
-		return (this->x == v.x) && (this->y == v.y) && (this->z == v.z);
-	}
-	inline bool operator!=(const tvec3<T>& v) const
-	{
-		return (this->x != v.x) && (this->y != v.y) && (this->z != v.z);
-	}
-	inline bool operator>(const tvec3<T>& v) const
-	{
-		return (this->x > v.x) && (this->y > v.y) && (this->z > v.z);
-	}
-	inline bool operator<(const tvec3<T>& v) const
-	{
-		return (this->x < v.x) && (this->y < v.y) && (this->z < v.z);
-	}
-	inline bool operator>=(const tvec3<T>& v) const
-	{
-		return (this->x >= v.x) && (this->y >= v.y) && (this->z >= v.z);
-	}
-	inline bool operator<=(const tvec3<T>& v) const
-	{
-		return (this->x <= v.x) && (this->y <= v.y) && (this->z <= v.z);
-	}
-	inline tvec3<T> operator&&(const tvec3<T>& v) const
-	{
-		return tvec3<T>(min(this->x, v.x), min(this->y, v.y), min(this->z, v.z));
-	}
-	inline tvec3<T> operator||(const tvec3<T>& v) const
+	union
 	{
-		return tvec3<T>(max(this->x, v.x), max(this->y, v.y), max(this->z, v.z));
-	}
-	inline T& operator[](const int index)
+		T y, v, t, g;
+	};
+
+	union
 	{
-		return ((T*)this)[index % this->length()];
-	}
+		T z, p, b;
+	};
+
+};
+
+template <typename T> struct tvecdata<4, T>
+{
+
+	inline GMATH_CONSTEXPR tvecdata() : x((T)0), y((T)0), z((T)0), w((T)0) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x) : x(x), y(x), z(x), w(x) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x, const T y, const T z, const T w) : x(x), y(y), z(z), w(w) {}
+	inline GMATH_CONSTEXPR tvecdata(const tvec2<T>& v, const T z, const T w) : x(v.x), y(v.y), z(z), w(w) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x, const tvec2<T>& v, const T w) : x(x), y(v.x), z(v.y), w(w) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x, const T y, const tvec2<T>& v) : x(x), y(y), z(v.x), w(v.y) {}
+	inline GMATH_CONSTEXPR tvecdata(const tvec2<T>& v0, const tvec2<T>& v1) : x(v0.x), y(v0.y), z(v1.x), w(v1.y) {}
+	inline GMATH_CONSTEXPR tvecdata(const tvec3<T>& v, const T w) : x(v.x), y(v.y), z(v.z), w(w) {}
+	inline GMATH_CONSTEXPR tvecdata(const T x, const tvec3<T>& v) : x(x), y(v.x), z(v.y), w(v.z) {}
+
+	template <typename U> inline GMATH_CONSTEXPR tvecdata(const tvec4<U>& v) : x((T)v.x), y((T)v.y), z((T)v.z), w((T)v.w) {}
 
 	union
 	{
@@ -383,478 +340,555 @@ template <typename T> struct tvec3
 		T z, p, b;
 	};
 
+	union
+	{
+		T w, q, a;
+	};
+
 };
 
-template <typename T> struct tvec4
+template <int N, typename T> struct tvec : tvecdata<N, T>
 {
 
-	inline tvec4() : x((T)0), y((T)0), z((T)0), w((T)0) {}
-	inline tvec4(const T x) : x(x), y(x), z(x), w(x) {}
-	inline tvec4(const T x, const T y, const T z, const T w) : x(x), y(y), z(z), w(w) {}
-	inline tvec4(const tvec2<T>& v, const T z, const T w) : x(v.x), y(v.y), z(z), w(w) {}
-	inline tvec4(const T x, const tvec2<T>& v, const T w) : x(x), y(v.x), z(v.y), w(w) {}
-	inline tvec4(const T x, const T y, const tvec2<T>& v) : x(x), y(y), z(v.x), w(v.y) {}
-	inline tvec4(const tvec2<T>& v0, const tvec2<T>& v1) : x(v0.x), y(v0.y), z(v1.x), w(v1.y) {}
-	inline tvec4(const tvec3<T>& v, const T w) : x(v.x), y(v.y), z(v.z), w(w) {}
-	inline tvec4(const T x, const tvec3<T>& v) : x(x), y(v.x), z(v.y), w(v.z) {}
-	inline tvec4(const tvec4<T>& v) : x(v.x), y(v.y), z(v.z), w(v.w) {}
-	inline ~tvec4() {}
+	inline GMATH_CONSTEXPR tvec() : tvecdata<N, T>() {}
+	// every constructor of the storage of this width, without relying on inheriting constructors
+	template <typename... A, typename = typename std::enable_if<std::is_constructible<tvecdata<N, T>, const A&...>::value>::type> inline GMATH_CONSTEXPR tvec(const A&... a) : tvecdata<N, T>(a...) {}
 
-	template <typename U> inline tvec4(const tvec4<U>& v) : x((T)v.x), y((T)v.y), z((T)v.z), w((T)v.w) {}
-
-	inline const int length() const
+	inline GMATH_CONSTEXPR const int length() const
 	{
-		return 4;
+		return N;
 	}
 
-	inline void operator=(const tvec4<T>& v)
-	{
-		this->x = v.x;
-		this->y = v.y;
-		this->z = v.z;
-		this->w = v.w;
-	}
 	inline operator T*() const
 	{
 		return (T*)this;
 	}
-	inline tvec4<T> operator+() const
+	inline tvec<N, T> operator+() const
 	{
-		return tvec4<T>(+this->x, +this->y, +this->z, +this->w);
+		return *this;
 	}
-	inline tvec4<T> operator-() const
+	inline tvec<N, T> operator-() const
 	{
-		return tvec4<T>(-this->x, -this->y, -this->z, -this->w);
+		tvec<N, T> r;
+		tlanes<N>::each([&](const int i) { r[i] = -(*this)[i]; });
+		return r;
 	}
-	inline void operator+=(const tvec4<T>& v)
+	inline void operator+=(const tvec<N, T>& v)
 	{
-		this->x += v.x;
-		this->y += v.y;
-		this->z += v.z;
-		this->w += v.w;
+		tlanes<N>::each([&](const int i) { (*this)[i] += v[i]; });
 	}
 	inline void operator+=(const T x)
 	{
-		this->x += x;
-		this->y += x;
-		this->z += x;
-		this->w += x;
+		tlanes<N>::each([&](const int i) { (*this)[i] += x; });
 	}
-	inline void operator-=(const tvec4<T>& v)
+	inline void operator-=(const tvec<N, T>& v)
 	{
-		this->x -= v.x;
-		this->y -= v.y;
-		this->z -= v.z;
-		this->w -= v.w;
+		tlanes<N>::each([&](const int i) { (*this)[i] -= v[i]; });
 	}
 	inline void operator-=(const T x)
 	{
-		this->x -= x;
-		this->y -= x;
-		this->z -= x;
-		this->w -= x;
+		tlanes<N>::each([&](const int i) { (*this)[i] -= x; });
 	}
-	inline void operator*=(const tvec4<T>& v)
+	inline void operator*=(const tvec<N, T>& v)
 	{
-		this->x *= v.x;
-		this->y *= v.y;
-		this->z *= v.z;
-		this->w *= v.w;
+		tlanes<N>::each([&](const int i) { (*this)[i] *= v[i]; });
 	}
 	inline void operator*=(const T x)
 	{
-		this->x *= x;
-		this->y *= x;
-		this->z *= x;
-		this->w *= x;
+		tlanes<N>::each([&](const int i) { (*this)[i] *= x; });
 	}
-	inline void operator/=(const tvec4<T>& v)
+	inline void operator/=(const tvec<N, T>& v)
 	{
-#if 0
-		this->x = v.x != (T)0 ? this->x / v.x : (T)0;
-		this->y = v.y != (T)0 ? this->y / v.y : (T)0;
-		this->z = v.z != (T)0 ? this->z / v.z : (T)0;
-		this->w = v.w != (T)0 ? this->w / v.w : (T)0;
-#else
-		this->x /= v.x;
-		this->y /= v.y;
-		this->z /= v.z;
-		this->w /= v.w;
-#endif
+		// tvec3 has always given zero for a zero divisor here, the other widths divide as they are.
+		tlanes<N>::each([&](const int i) { (*this)[i] = (N == 3) && (v[i] == (T)0) ? (T)0 : (*this)[i] / v[i]; });
 	}
 	inline void operator/=(const T x)
 	{
-#if 0
-		this->x = x != (T)0 ? this->x / x : (T)0;
-		this->y = x != (T)0 ? this->y / x : (T)0;
-		this->z = x != (T)0 ? this->z / x : (T)0;
-		this->w = x != (T)0 ? this->w / x : (T)0;
-#else
-		this->x /= x;
-		this->y /= x;
-		this->z /= x;
-		this->w /= x;
-#endif
+		tlanes<N>::each([&](const int i) { (*this)[i] /= x; });
 	}
-	inline void operator%=(const tvec4<T>& v)
+	inline void operator%=(const tvec<N, T>& v)
 	{
-		return tvec4<T>(module(this->x, v.x), module(this->y, v.y), module(this->z, v.z), module(this->w, v.w));
+		tlanes<N>::each([&](const int i) { (*this)[i] = module((*this)[i], v[i]); });
 	}
 	inline void operator%=(const T& x)
 	{
-		return tvec4<T>(module(this->x, x), module(this->y, x), module(this->z, x), module(this->w, x));
+		tlanes<N>::each([&](const int i) { (*this)[i] = module((*this)[i], x); });
 	}
-	inline bool operator==(const tvec4<T>& v) const
+	inline bool operator==(const tvec<N, T>& v) const
 	{
-		return (this->x == v.x) && (this->y == v.y) && (this->z == v.z) && (this->w == v.w);
+		bool r = true;
+		tlanes<N>::each([&](const int i) { r = r && ((*this)[i] == v[i]); });
+		return r;
 	}
-	inline bool operator!=(const tvec4<T>& v) const
+	inline bool operator!=(const tvec<N, T>& v) const
 	{
-		return (this->x != v.x) && (this->y != v.y) && (this->z != v.z) && (this->w != v.w);
+		bool r = true;
+		tlanes<N>::each([&](const int i) { r = r && ((*this)[i] != v[i]); });
+		return r;
 	}
-	inline bool operator>(const tvec4<T>& v) const
+	inline bool operator>(const tvec<N, T>& v) const
 	{
-		return (this->x > v.x) && (this->y > v.y) && (this->z > v.z) && (this->w > v.w);
+		bool r = true;
+		tlanes<N>::each([&](const int i) { r = r && ((*this)[i] > v[i]); });
+		return r;
 	}
-	inline bool operator<(const tvec4<T>& v) const
+	inline bool operator<(const tvec<N, T>& v) const
 	{
-		return (this->x < v.x) && (this->y < v.y) && (this->z < v.z) && (this->w < v.w);
+		bool r = true;
+		tlanes<N>::each([&](const int i) { r = r && ((*this)[i] < v[i]); });
+		return r;
 	}
-	inline bool operator>=(const tvec4<T>& v) const
+	inline bool operator>=(const tvec<N, T>& v) const
 	{
-		return (this->x >= v.x) && (this->y >= v.y) && (this->z >= v.z) && (this->w >= v.w);
+		bool r = true;
+		tlanes<N>::each([&](const int i) { r = r && ((*this)[i] >= v[i]); });
+		return r;
 	}
-	inline bool operator<=(const tvec4<T>& v) const
+	inline bool operator<=(const tvec<N, T>& v) const
 	{
-		return (this->x <= v.x) && (this->y <= v.y) && (this->z <= v.z) && (this->w <= v.w);
+		bool r = true;
+		tlanes<N>::each([&](const int i) { r = r && ((*this)[i] <= v[i]); });
+		return r;
 	}
-	inline tvec4<T> operator&&(const tvec4<T>& v) const
+	inline tvec<N, T> operator&&(const tvec<N, T>& v) const
 	{
-		return tvec4<T>(min(this->x, v.x), min(this->y, v.y), min(this->z, v.z), min(this->w, v.w));
+		tvec<N, T> r;
+		tlanes<N>::each([&](const int i) { r[i] = min((*this)[i], v[i]); });
+		return r;
 	}
-	inline tvec4<T> operator||(const tvec4<T>& v) const
+	inline tvec<N, T> operator||(const tvec<N, T>& v) const
 	{
-		return tvec4<T>(max(this->x, v.x), max(this->y, v.y), max(this->z, v.z), max(this->w, v.w));
+		tvec<N, T> r;
+		tlanes<N>::each([&](const int i) { r[i] = max((*this)[i], v[i]); });
+		return r;
 	}
 	inline T& operator[](const int index)
 	{
-		return ((T*)this)[index % this->length()];
+		return ((T*)this)[index % N];
 	}
-
-	union
+	inline const T& operator[](const int index) const
 	{
-		T x, u, s, r;
-	};
-
-	union
-	{
-		T y, v, t, g;
-	};
-
-	union
-	{
-		T z, p, b;
-	};
-
-	union
-	{
-		T w, q, a;
-	};
+		return ((const T*)this)[index % N];
+	}
 
 };
 
-template <typename T> inline tvec2<T> operator+(const tvec2<T>& v0, const tvec2<T>& v1)
+template <int N, typename T> inline tvec<N, T> operator+(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec2<T>(v0.x + v1.x, v0.y + v1.y);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] + v1[i]; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator+(const tvec2<T>& v, const T x)
+template <int N, typename T> inline tvec<N, T> operator+(const tvec<N, T>& v, const T x)
 {
-	return tvec2<T>(v.x + x, v.y + x);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = v[i] + x; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator+(const T x, const tvec2<T>& v)
+template <int N, typename T> inline tvec<N, T> operator+(const T x, const tvec<N, T>& v)
 {
-	return tvec2<T>(x + v.x, x + v.y);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = x + v[i]; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator-(const tvec2<T>& v0, const tvec2<T>& v1)
+template <int N, typename T> inline tvec<N, T> operator-(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec2<T>(v0.x - v1.x, v0.y - v1.y);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] - v1[i]; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator-(const tvec2<T>& v, const T x)
+template <int N, typename T> inline tvec<N, T> operator-(const tvec<N, T>& v, const T x)
 {
-	return tvec2<T>(v.x - x, v.y - x);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = v[i] - x; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator-(const T x, const tvec2<T>& v)
+template <int N, typename T> inline tvec<N, T> operator-(const T x, const tvec<N, T>& v)
 {
-	return tvec2<T>(x - v.x, x - v.y);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = x - v[i]; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator*(const tvec2<T>& v0, const tvec2<T>& v1)
+template <int N, typename T> inline tvec<N, T> operator*(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec2<T>(v0.x * v1.x, v0.y * v1.y);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] * v1[i]; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator*(const tvec2<T>& v, const T x)
+template <int N, typename T> inline tvec<N, T> operator*(const tvec<N, T>& v, const T x)
 {
-	return tvec2<T>(v.x * x, v.y * x);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = v[i] * x; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator*(const T x, const tvec2<T>& v)
+template <int N, typename T> inline tvec<N, T> operator*(const T x, const tvec<N, T>& v)
 {
-	return tvec2<T>(x * v.x, x * v.y);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = x * v[i]; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator/(const tvec2<T>& v0, const tvec2<T>& v1)
+template <int N, typename T> inline tvec<N, T> operator/(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec2<T>(v0.x / v1.x, v0.y / v1.y);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] / v1[i]; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator/(const tvec2<T>& v, const T x)
+template <int N, typename T> inline tvec<N, T> operator/(const tvec<N, T>& v, const T x)
 {
-	return tvec2<T>(v.x / x, v.y / x);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = v[i] / x; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator/(const T x, const tvec2<T>& v)
+template <int N, typename T> inline tvec<N, T> operator/(const T x, const tvec<N, T>& v)
 {
-	return tvec2<T>(x / v.x, x / v.y);
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = x / v[i]; });
+	return r;
 }
-template <typename T> inline tvec2<T> operator%(const tvec2<T>& v0, const tvec2<T>& v1)
+template <int N, typename T> inline tvec<N, T> operator%(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec2<T>(module(v0.x, v1.x), module(v0.y, v1.y));
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = module(v0[i], v1[i]); });
+	return r;
 }
-template <typename T> inline tvec2<T> operator%(const tvec2<T>& v, const T x)
+template <int N, typename T> inline tvec<N, T> operator%(const tvec<N, T>& v, const T x)
 {
-	return tvec2<T>(module(v0.x, x), module(v0.y, x));
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = module(v[i], x); });
+	return r;
 }
 
-template <typename T> inline tvec3<T> operator+(const tvec3<T>& v0, const tvec3<T>& v1)
-{
-	return tvec3<T>(v0.x + v1.x, v0.y + v1.y, v0.z + v1.z);
-}
-template <typename T> inline tvec3<T> operator+(const tvec3<T>& v, const T x)
+template <int N, typename T> inline T dot(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec3<T>(v.x + x, v.y + x, v.z + x);
+	T r = v0[0] * v1[0];
+	tlanes<N - 1>::each([&](const int i) { r += v0[i + 1] * v1[i + 1]; });
+	return r;
 }
-template <typename T> inline tvec3<T> operator+(const T x, const tvec3<T>& v)
+template <int N, typename T> inline T magnitude(const tvec<N, T>& v)
 {
-	return tvec3<T>(x + v.x, x + v.y, x + v.z);
+	return (T)sqrt(dot(v, v));
 }
-template <typename T> inline tvec3<T> operator-(const tvec3<T>& v0, const tvec3<T>& v1)
+template <int N, typename T> inline T distance(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec3<T>(v0.x - v1.x, v0.y - v1.y, v0.z - v1.z);
-}
-template <typename T> inline tvec3<T> operator-(const tvec3<T>& v, const T x)
-{
-	return tvec3<T>(v.x - x, v.y - x, v.z - x);
-}
-template <typename T> inline tvec3<T> operator-(const T x, const tvec3<T>& v)
-{
-	return tvec3<T>(x - v.x, x - v.y, x - v.z);
-}
-template <typename T> inline tvec3<T> operator*(const tvec3<T>& v0, const tvec3<T>& v1)
-{
-	return tvec3<T>(v0.x * v1.x, v0.y * v1.y, v0.z * v1.z);
-}
-template <typename T> inline tvec3<T> operator*(const tvec3<T>& v, const T x)
-{
-	return tvec3<T>(v.x * x, v.y * x, v.z * x);
-}
-template <typename T> inline tvec3<T> operator*(const T x, const tvec3<T>& v)
-{
-	return tvec3<T>(x * v.x, x * v.y, x * v.z);
+	return magnitude(v0 - v1);
 }
-template <typename T> inline tvec3<T> operator/(const tvec3<T>& v0, const tvec3<T>& v1)
+template <int N, typename T> inline tvec<N, T> normalize(const tvec<N, T>& v)
 {
-	return tvec3<T>(v0.x / v1.x, v0.y / v1.y, v0.z / v1.z);
+	T m = magnitude(v);
+	return m == (T)0 ? tvec<N, T>() : v / m;
 }
-template <typename T> inline tvec3<T> operator/(const tvec3<T>& v, const T x)
+
+template <typename T> inline tvec4<T> homogenize(const tvec4<T>& v)
 {
-	return tvec3<T>(v.x / x, v.y / x, v.z / x);
+	return tvec4<T>(v.x / v.w, v.y / v.w, v.z / v.w, v.w / v.w);
 }
-template <typename T> inline tvec3<T> operator/(const T x, const tvec3<T>& v)
+
+template <typename T> inline T angle(const tvec3<T>& v0, const tvec3<T>& v1, const tvec3<T>& axis)
 {
-	return tvec3<T>(x / v.x, x / v.y, x / v.z);
+	tvec3<T> right = cross(v0, axis);
+	T theta = (T)std::acos(dot(v0, v1) / std::sqrt(magnitude(v0) * magnitude(v1)));
+	return dot(v1, right) < (T)0 ? theta + (T)PI : theta;
 }
-template <typename T> inline tvec3<T> operator%(const tvec3<T>& v0, const tvec3<T>& v1)
+
+template <typename T> inline tvec3<T> crossUnnormalized(const tvec3<T>& v0, const tvec3<T>& v1)
 {
-	return tvec3<T>(module(v0.x, v1.x), module(v0.y, v1.y), module(v0.z, v1.z));
+	return tvec3<T>((v0.y * v1.z) - (v0.z * v1.y), (v0.z * v1.x) - (v0.x * v1.z), (v0.x * v1.y) - (v0.y * v1.x));
 }
-template <typename T> inline tvec3<T> operator%(const tvec3<T>& v, const T x)
+template <typename T> inline tvec3<T> cross(const tvec3<T>& v0, const tvec3<T>& v1)
 {
-	return tvec3<T>(module(v0.x, x), module(v0.y, x), module(v0.z, x));
+	return normalize(crossUnnormalized(v0, v1));
 }
 
-template <typename T> inline tvec4<T> operator+(const tvec4<T>& v0, const tvec4<T>& v1)
+template <typename T> inline tvec3<T> reflect(const tvec3<T>& v, const tvec3<T>& n)
 {
-	return tvec4<T>(v0.x + v1.x, v0.y + v1.y, v0.z + v1.z, v0.w + v1.w);
+	return normalize((n * dot(n, v) * (T)2) - v);
 }
-template <typename T> inline tvec4<T> operator+(const tvec4<T>& v, const T x)
+
+template <typename T> inline tvec3<T> refract(const tvec3<T>& v, const tvec3<T>& n, const T theta)
 {
-	return tvec4<T>(v.x + x, v.y + x, v.z + x, v.w + x);
+	T d = dot(n, v);
+	T k = (T)1 - (theta * theta * ((T)1 - (d * d)));
+	if (k < (T)0)
+	{
+		return tvec3<T>((T)0);
+	}
+
+	return normalize((theta * v) - (theta * d + (T)sqrt(k)) * n);
 }
-template <typename T> inline tvec4<T> operator+(const T x, const tvec4<T>& v)
+
+template <int N, typename T> inline tvec<N, T> lerp(const tvec<N, T>& v0, const tvec<N, T>& v1, const T t)
 {
-	return tvec4<T>(x + v.x, x + v.y, x + v.z, x + v.w);
+	return v0 + ((v1 - v0) * truth(t));
 }
-template <typename T> inline tvec4<T> operator-(const tvec4<T>& v0, const tvec4<T>& v1)
+
+template <int N, typename T> inline tvec<N, T> slerp(const tvec<N, T>& v0, const tvec<N, T>& v1, const T t)
 {
-	return tvec4<T>(v0.x - v1.x, v0.y - v1.y, v0.z - v1.z, v0.w - v1.w);
+	return normalize((v0 * not(t)) + (v1 * truth(t)));
 }
-template <typename T> inline tvec4<T> operator-(const tvec4<T>& v, const T x)
+
+// Lanewise comparisons. The operators above answer for all lanes at once; these keep one bool per
+// lane so that select() can pick between two vectors without a branch per component.
+template <int N, typename T> inline tvec<N, bool> lessThan(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec4<T>(v.x - x, v.y - x, v.z - x, v.w - x);
+	tvec<N, bool> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] < v1[i]; });
+	return r;
 }
-template <typename T> inline tvec4<T> operator-(const T x, const tvec4<T>& v)
+template <int N, typename T> inline tvec<N, bool> lessThanEqual(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec4<T>(x - v.x, x - v.y, x - v.z, x - v.w);
+	tvec<N, bool> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] <= v1[i]; });
+	return r;
 }
-template <typename T> inline tvec4<T> operator*(const tvec4<T>& v0, const tvec4<T>& v1)
+template <int N, typename T> inline tvec<N, bool> greaterThan(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec4<T>(v0.x * v1.x, v0.y * v1.y, v0.z * v1.z, v0.w * v1.w);
+	tvec<N, bool> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] > v1[i]; });
+	return r;
 }
-template <typename T> inline tvec4<T> operator*(const tvec4<T>& v, const T x)
+template <int N, typename T> inline tvec<N, bool> greaterThanEqual(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec4<T>(v.x * x, v.y * x, v.z * x, v.w * x);
+	tvec<N, bool> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] >= v1[i]; });
+	return r;
 }
-template <typename T> inline tvec4<T> operator*(const T x, const tvec4<T>& v)
+template <int N, typename T> inline tvec<N, bool> equal(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec4<T>(x * v.x, x * v.y, x * v.z, x * v.w);
+	tvec<N, bool> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] == v1[i]; });
+	return r;
 }
-template <typename T> inline tvec4<T> operator/(const tvec4<T>& v0, const tvec4<T>& v1)
+template <int N, typename T> inline tvec<N, bool> notEqual(const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec4<T>(v0.x / v1.x, v0.y / v1.y, v0.z / v1.z, v0.w / v1.w);
+	tvec<N, bool> r;
+	tlanes<N>::each([&](const int i) { r[i] = v0[i] != v1[i]; });
+	return r;
 }
-template <typename T> inline tvec4<T> operator/(const tvec4<T>& v, const T x)
+
+template <int N> inline bool any(const tvec<N, bool>& m)
 {
-	return tvec4<T>(v.x / x, v.y / x, v.z / x, v.w / x);
+	bool r = false;
+	tlanes<N>::each([&](const int i) { r = r | m[i]; });
+	return r;
 }
-template <typename T> inline tvec4<T> operator/(const T x, const tvec4<T>& v)
+template <int N> inline bool all(const tvec<N, bool>& m)
 {
-	return tvec4<T>(x / v.x, x / v.y, x / v.z, x / v.w);
+	bool r = true;
+	tlanes<N>::each([&](const int i) { r = r & m[i]; });
+	return r;
 }
-template <typename T> inline tvec4<T> operator%(const tvec4<T>& v0, const tvec4<T>& v1)
+// Bit i is set when lane i is.
+template <int N> inline unsigned int bitmask(const tvec<N, bool>& m)
 {
-	return tvec4<T>(module(v0.x, v1.x), module(v0.y, v1.y), module(v0.z, v1.z), module(v0.w, v1.w));
+	unsigned int r = 0;
+	tlanes<N>::each([&](const int i) { r |= (unsigned int)m[i] << i; });
+	return r;
 }
-template <typename T> inline tvec4<T> operator%(const tvec4<T>& v, const T x)
+template <int N, typename T> inline tvec<N, T> select(const tvec<N, bool>& m, const tvec<N, T>& v0, const tvec<N, T>& v1)
 {
-	return tvec4<T>(module(v0.x, x), module(v0.y, x), module(v0.z, x), module(v0.w, x));
+	tvec<N, T> r;
+	tlanes<N>::each([&](const int i) { r[i] = m[i] ? v0[i] : v1[i]; });
+	return r;
 }
 
-template <typename T> inline T magnitude(const tvec2<T>& v)
+template <int N, typename T> inline tvec<N, T> clamp(const tvec<N, T>& v, const tvec<N, T>& min, const tvec<N, T>& max)
 {
-	return (T)sqrt((v.x * v.x) + (v.y * v.y));
+	return select(lessThan(v, min), min, select(greaterThan(v, max), max, v));
 }
-template <typename T> inline T magnitude(const tvec3<T>& v)
+template <int N, typename T> inline tvec<N, T> clamp(const tvec<N, T>& v, const T min, const T max)
 {
-	return (T)sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z));
+	return clamp(v, tvec<N, T>(min), tvec<N, T>(max));
 }
-template <typename T> inline T magnitude(const tvec4<T>& v)
+template <int N, typename T> inline tvec<N, T> sign(const tvec<N, T>& v)
 {
-	return (T)sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z) + (v.w * v.w));
+	return select(greaterThan(v, tvec<N, T>((T)0)), tvec<N, T>((T)1), tvec<N, T>((T)0));
 }
 
-template <typename T> inline T distance(const tvec2<T>& v0, const tvec2<T>& v1)
+typedef tvec2<float> vec2;
+typedef tvec2<int> ivec2;
+typedef tvec3<float> vec3;
+typedef tvec3<int> ivec3;
+typedef tvec4<float> vec4;
+typedef tvec4<int> ivec4;
+typedef tvec2<bool> bvec2;
+typedef tvec3<bool> bvec3;
+typedef tvec4<bool> bvec4;
+typedef tvec<8, float> vec8;
+typedef tvec<16, float> vec16;
+#endif
+
+#if !(defined(tquat) || defined(quat))
+template <typename T> struct tquat;
+template <typename T> struct tmat3x3;
+template <typename T> struct tmat4x4;
+
+template <typename T> struct tquat
 {
-	return magnitude(v0 - v1);
-}
-template <typename T> inline T distance(const tvec3<T>& v0, const tvec3<T>& v1)
+
+	inline GMATH_CONSTEXPR tquat() : x((T)0), y((T)0), z((T)0), w((T)1) {}
+	inline GMATH_CONSTEXPR tquat(const T x, const T y, const T z, const T w) : x(x), y(y), z(z), w(w) {}
+	inline GMATH_CONSTEXPR tquat(const tvec3<T>& v, const T w) : x(v.x), y(v.y), z(v.z), w(w) {}
+	inline tquat(const T theta, const tvec3<T>& axis)
+	{
+		T rad = radians<T>(theta) * (T)0.5;
+		T s = (T)sin(rad);
+		tvec3<T> axis_ = normalize(axis);
+		this->x = axis_.x * s;
+		this->y = axis_.y * s;
+		this->z = axis_.z * s;
+		this->w = (T)cos(rad);
+	}
+	inline tquat(const tvec3<T>& rotation)
+	{
+		T rx = radians<T>(rotation.x) * (T)0.5;
+		T ry = radians<T>(rotation.y) * (T)0.5;
+		T rz = radians<T>(rotation.z) * (T)0.5;
+		T cx = (T)cos(rx);
+		T sx = (T)sin(rx);
+		T cy = (T)cos(ry);
+		T sy = (T)sin(ry);
+		T cz = (T)cos(rz);
+		T sz = (T)sin(rz);
+
+		this->x = (cy * cz * sx) - (sy * sz * cx);
+		this->y = (sy * cz * cx) + (cy * sz * sx);
+		this->z = (cy * sz * cx) - (sy * cz * sx);
+		this->w = (cy * cz * cx) + (sy * sz * sx);
+	}
+	inline tquat(const tmat3x3<T>& m);
+	inline tquat(const tmat4x4<T>& m);
+
+	inline GMATH_CONSTEXPR const int length() const
+	{
+		return 4;
+	}
+
+	inline operator T*() const
+	{
+		return (T*)this;
+	}
+	inline tquat<T> operator-() const
+	{
+		return tquat<T>(-this->x, -this->y, -this->z, -this->w);
+	}
+	inline void operator*=(const tquat<T>& q)
+	{
+		*this = *this * q;
+	}
+	inline void operator*=(const T x)
+	{
+		this->x *= x;
+		this->y *= x;
+		this->z *= x;
+		this->w *= x;
+	}
+	inline bool operator==(const tquat<T>& q) const
+	{
+		return (this->x == q.x) && (this->y == q.y) && (this->z == q.z) && (this->w == q.w);
+	}
+	inline bool operator!=(const tquat<T>& q) const
+	{
+		return !(*this == q);
+	}
+	inline T& operator[](const int index)
+	{
+		return ((T*)this)[index % this->length()];
+	}
+
+	T x;
+	T y;
+	T z;
+	T w;
+
+};
+
+template <typename T> inline tquat<T> operator+(const tquat<T>& q0, const tquat<T>& q1)
 {
-	return magnitude(v0 - v1);
+	return tquat<T>(q0.x + q1.x, q0.y + q1.y, q0.z + q1.z, q0.w + q1.w);
 }
-template <typename T> inline T distance(const tvec4<T>& v0, const tvec4<T>& v1)
+template <typename T> inline tquat<T> operator-(const tquat<T>& q0, const tquat<T>& q1)
 {
-	return magnitude(v0 - v1);
+	return tquat<T>(q0.x - q1.x, q0.y - q1.y, q0.z - q1.z, q0.w - q1.w);
 }
-
-template <typename T> inline tvec2<T> normalize(const tvec2<T>& v)
+template <typename T> inline tquat<T> operator*(const tquat<T>& q0, const tquat<T>& q1)
 {
-	T m = magnitude(v);
-	return m == (T)0 ? tvec2<T>() : tvec2<T>(v.x / m, v.y / m);
+	return tquat<T>(
+		(q0.w * q1.x) + (q0.x * q1.w) + (q0.y * q1.z) - (q0.z * q1.y),
+		(q0.w * q1.y) + (q0.y * q1.w) + (q0.z * q1.x) - (q0.x * q1.z),
+		(q0.w * q1.z) + (q0.z * q1.w) + (q0.x * q1.y) - (q0.y * q1.x),
+		(q0.w * q1.w) - (q0.x * q1.x) - (q0.y * q1.y) - (q0.z * q1.z)
+		);
 }
-template <typename T> inline tvec3<T> normalize(const tvec3<T>& v)
+template <typename T> inline tvec3<T> operator*(const tquat<T>& q, const tvec3<T>& v)
 {
-	T m = magnitude(v);
-	return m == (T)0 ? tvec3<T>() : tvec3<T>(v.x / m, v.y / m, v.z / m);
+	tvec3<T> t(
+		((q.y * v.z) - (q.z * v.y)) * (T)2,
+		((q.z * v.x) - (q.x * v.z)) * (T)2,
+		((q.x * v.y) - (q.y * v.x)) * (T)2
+		);
+	return tvec3<T>(
+		v.x + (q.w * t.x) + ((q.y * t.z) - (q.z * t.y)),
+		v.y + (q.w * t.y) + ((q.z * t.x) - (q.x * t.z)),
+		v.z + (q.w * t.z) + ((q.x * t.y) - (q.y * t.x))
+		);
 }
-template <typename T> inline tvec4<T> normalize(const tvec4<T>& v)
+template <typename T> inline tquat<T> operator*(const tquat<T>& q, const T x)
 {
-	T m = magnitude(v);
-	return m == (T)0 ? tvec4<T>() : tvec4<T>(v.x / m, v.y / m, v.z / m, v.w / m);
+	return tquat<T>(q.x * x, q.y * x, q.z * x, q.w * x);
 }
-
-template <typename T> inline tvec4<T> homogenize(const tvec4<T>& v)
+template <typename T> inline tquat<T> operator*(const T x, const tquat<T>& q)
 {
-	return tvec4<T>(v.x / v.w, v.y / v.w, v.z / v.w, v.w / v.w);
+	return tquat<T>(x * q.x, x * q.y, x * q.z, x * q.w);
 }
 
-template <typename T> inline T dot(const tvec2<T>& v0, const tvec2<T>& v1)
+template <typename T> inline T dot(const tquat<T>& q0, const tquat<T>& q1)
 {
-	return (v0.x * v1.x) + (v0.y * v1.y);
+	return (q0.x * q1.x) + (q0.y * q1.y) + (q0.z * q1.z) + (q0.w * q1.w);
 }
-template <typename T> inline T dot(const tvec3<T>& v0, const tvec3<T>& v1)
+template <typename T> inline T magnitude(const tquat<T>& q)
 {
-	return (v0.x * v1.x) + (v0.y * v1.y) + (v0.z * v1.z);
+	return (T)sqrt(dot(q, q));
 }
-template <typename T> inline T dot(const tvec4<T>& v0, const tvec4<T>& v1)
+template <typename T> inline tquat<T> normalize(const tquat<T>& q)
 {
-	return (v0.x * v1.x) + (v0.y * v1.y) + (v0.z * v1.z) + (v0.w * v1.w);
+	T m = magnitude(q);
+	return m != (T)0 ? q * ((T)1 / m) : tquat<T>();
 }
-
-template <typename T> inline T angle(const tvec3<T>& v0, const tvec3<T>& v1, const tvec3<T>& axis)
+template <typename T> inline tquat<T> conjugate(const tquat<T>& q)
 {
-	tvec3<T> right = cross(v0, axis);
-	T theta = (T)std::acos(dot(v0, v1) / std::sqrt(magnitude(v0) * magnitude(v1)));
-	return dot(v1, right) < (T)0 ? theta + ((T)pi()) : theta;
+	return tquat<T>(-q.x, -q.y, -q.z, q.w);
 }
-
-template <typename T> inline tvec3<T> cross(const tvec3<T>& v0, const tvec3<T>& v1)
+template <typename T> inline tquat<T> inverse(const tquat<T>& q)
 {
-	return normalize(tvec3<T>((v0.y * v1.z) - (v0.z * v1.y), (v0.z * v1.x) - (v0.x * v1.z), (v0.x * v1.y) - (v0.y * v1.x)));
+	return conjugate(q) * ((T)1 / dot(q, q));
 }
 
-template <typename T> inline tvec3<T> reflect(const tvec3<T>& v, const tvec3<T>& n)
+template <typename T> inline tquat<T> nlerp(const tquat<T>& q0, const tquat<T>& q1, const T t)
 {
-	return normalize((n * dot(n, v) * (T)2) - v);
+	T s = dot(q0, q1) < (T)0 ? -t : t;
+	return normalize((q0 * ((T)1 - t)) + (q1 * s));
 }
-
-template <typename T> inline tvec3<T> refract(const tvec3<T>& v, const tvec3<T>& n, const T theta)
+template <typename T> inline tquat<T> slerp(const tquat<T>& q0, const tquat<T>& q1, const T t)
 {
-	T d = dot(n, v);
-	T k = (T)1 - (theta * theta * ((T)1 - (d * d)));
-	if (k < (T)0)
+	T c = dot(q0, q1);
+	T s = (T)1;
+	if (c < (T)0)
 	{
-		return tvec3<T>((T)0);
+		c = -c;
+		s = (T)-1;
 	}
 
-	return normalize((theta * v) - (theta * d + (T)sqrt(k)) * n);
-}
-
-template <typename T> inline tvec2<T> lerp(const tvec2<T>& v0, const tvec2<T>& v1, const T t)
-{
-	return (v1 - v0) * truth(t);
-}
-template <typename T> inline tvec3<T> lerp(const tvec3<T>& v0, const tvec3<T>& v1, const T t)
-{
-	return (v1 - v0) * truth(t);
-}
-template <typename T> inline tvec4<T> lerp(const tvec4<T>& v0, const tvec4<T>& v1, const T t)
-{
-	return (v1 - v0) * truth(t);
-}
+	if (c > (T)0.9995)
+	{
+		return normalize((q0 * ((T)1 - t)) + (q1 * (s * t)));
+	}
 
-template <typename T> inline tvec2<T> slerp(const tvec2<T>& v0, const tvec2<T>& v1, const T t)
-{
-	return normalize((v0 * not(t)) + (v1 * truth(t)));
-}
-template <typename T> inline tvec3<T> slerp(const tvec3<T>& v0, const tvec3<T>& v1, const T t)
-{
-	return normalize((v0 * not(t)) + (v1 * truth(t)));
-}
-template <typename T> inline tvec4<T> slerp(const tvec4<T>& v0, const tvec4<T>& v1, const T t)
-{
-	return normalize((v0 * not(t)) + (v1 * truth(t)));
+	T theta = (T)acos(c);
+	T d = (T)1 / (T)sin(theta);
+	return (q0 * ((T)sin(((T)1 - t) * theta) * d)) + (q1 * ((T)sin(t * theta) * d * s));
 }
 
-typedef tvec2<float> vec2;
-typedef tvec2<int> ivec2;
-typedef tvec3<float> vec3;
-typedef tvec3<int> ivec3;
-typedef tvec4<float> vec4;
-typedef tvec4<int> ivec4;
+typedef tquat<float> quat;
 #endif
 
 #if !(defined(tmat3) || defined(tmat4) || defined(mat3) || defined(mat4) || defined(imat3) || defined(imat4))
@@ -864,19 +898,19 @@ template <typename T> struct tmat4x4;
 template <typename T> struct tmat3x3
 {
 
-	inline tmat3x3()
+	inline GMATH_CONSTEXPR tmat3x3()
 	{
 		this->_columns[0] = tvec3<T>((T)1, (T)0, (T)0);
 		this->_columns[1] = tvec3<T>((T)0, (T)1, (T)0);
 		this->_columns[2] = tvec3<T>((T)0, (T)0, (T)1);
 	}
-	inline tmat3x3(const T x)
+	inline GMATH_CONSTEXPR tmat3x3(const T x)
 	{
 		this->_columns[0] = tvec3<T>(x, (T)0, (T)0);
 		this->_columns[1] = tvec3<T>((T)0, x, (T)0);
 		this->_columns[2] = tvec3<T>((T)0, (T)0, x);
 	}
-	inline tmat3x3(
+	inline GMATH_CONSTEXPR tmat3x3(
 		const T x0, const T y0, const T z0,
 		const T x1, const T y1, const T z1,
 		const T x2, const T y2, const T z2
@@ -886,7 +920,7 @@ template <typename T> struct tmat3x3
 		this->_columns[1] = tvec3<T>(y0, y1, y2);
 		this->_columns[2] = tvec3<T>(z0, z1, z2);
 	}
-	inline tmat3x3(
+	inline GMATH_CONSTEXPR tmat3x3(
 		const tvec3<T>& v0, const tvec3<T>& v1, const tvec3<T>& v2
 		)
 	{
@@ -894,35 +928,38 @@ template <typename T> struct tmat3x3
 		this->_columns[1] = v1;
 		this->_columns[2] = v2;
 	}
-	inline tmat3x3(const tmat3x3& m)
+	inline GMATH_CONSTEXPR tmat3x3(const tmat4x4<T>& m)
 	{
-		this->_columns[0] = m._columns[0];
-		this->_columns[1] = m._columns[1];
-		this->_columns[2] = m._columns[2];
+		this->_columns[0] = tvec3<T>(m._columns[0]);
+		this->_columns[1] = tvec3<T>(m._columns[1]);
+		this->_columns[2] = tvec3<T>(m._columns[2]);
 	}
-	inline tmat3x3(const tmat4x4<T>& m)
+	inline GMATH_CONSTEXPR tmat3x3(const tquat<T>& q)
 	{
-		this->_columns[0] = vec3(m._columns[0]);
-		this->_columns[1] = vec3(m._columns[1]);
-		this->_columns[2] = vec3(m._columns[2]);
+		T xx = q.x * q.x;
+		T yy = q.y * q.y;
+		T zz = q.z * q.z;
+		T xy = q.x * q.y;
+		T xz = q.x * q.z;
+		T yz = q.y * q.z;
+		T wx = q.w * q.x;
+		T wy = q.w * q.y;
+		T wz = q.w * q.z;
+
+		this->_columns[0] = tvec3<T>((T)1 - ((T)2 * (yy + zz)), (T)2 * (xy + wz), (T)2 * (xz - wy));
+		this->_columns[1] = tvec3<T>((T)2 * (xy - wz), (T)1 - ((T)2 * (xx + zz)), (T)2 * (yz + wx));
+		this->_columns[2] = tvec3<T>((T)2 * (xz + wy), (T)2 * (yz - wx), (T)1 - ((T)2 * (xx + yy)));
 	}
-	inline ~tmat3x3() {}
 
-	inline const int columns() const
+	inline GMATH_CONSTEXPR const int columns() const
 	{
 		return 3;
 	}
-	inline const int rows() const
+	inline GMATH_CONSTEXPR const int rows() const
 	{
 		return 3;
 	}
 
-	inline void operator=(const tmat3x3<T>& m)
-	{
-		this->_columns[0] = m._columns[0];
-		this->_columns[1] = m._columns[1];
-		this->_columns[2] = m._columns[2];
-	}
 	inline operator T*() const
 	{
 		return (T*)(this->_columns[0]);
@@ -983,21 +1020,21 @@ template <typename T> struct tmat3x3
 template <typename T> struct tmat4x4
 {
 
-	inline tmat4x4()
+	inline GMATH_CONSTEXPR tmat4x4()
 	{
 		this->_columns[0] = tvec4<T>((T)1, (T)0, (T)0, (T)0);
 		this->_columns[1] = tvec4<T>((T)0, (T)1, (T)0, (T)0);
 		this->_columns[2] = tvec4<T>((T)0, (T)0, (T)1, (T)0);
 		this->_columns[3] = tvec4<T>((T)0, (T)0, (T)0, (T)1);
 	}
-	inline tmat4x4(const T x)
+	inline GMATH_CONSTEXPR tmat4x4(const T x)
 	{
 		this->_columns[0] = tvec4<T>(x, (T)0, (T)0, (T)0);
 		this->_columns[1] = tvec4<T>((T)0, x, (T)0, (T)0);
 		this->_columns[2] = tvec4<T>((T)0, (T)0, x, (T)0);
 		this->_columns[3] = tvec4<T>((T)0, (T)0, (T)0, x);
 	}
-	inline tmat4x4(
+	inline GMATH_CONSTEXPR tmat4x4(
 		const T x0, const T y0, const T z0, const T w0,
 		const T x1, const T y1, const T z1, const T w1,
 		const T x2, const T y2, const T z2, const T w2,
@@ -1009,7 +1046,7 @@ template <typename T> struct tmat4x4
 		this->_columns[2] = tvec4<T>(z0, z1, z2, z3);
 		this->_columns[3] = tvec4<T>(w0, w1, w2, w3);
 	}
-	inline tmat4x4(
+	inline GMATH_CONSTEXPR tmat4x4(
 		const tvec4<T>& v0, const tvec4<T>& v1, const tvec4<T>& v2, const tvec4<T>& v3
 		)
 	{
@@ -1018,38 +1055,31 @@ template <typename T> struct tmat4x4
 		this->_columns[2] = v2;
 		this->_columns[3] = v3;
 	}
-	inline tmat4x4(const tmat3x3<T>& m)
+	inline GMATH_CONSTEXPR tmat4x4(const tmat3x3<T>& m)
 	{
 		this->_columns[0] = tvec4<T>(m._columns[0], (T)0);
 		this->_columns[1] = tvec4<T>(m._columns[1], (T)0);
 		this->_columns[2] = tvec4<T>(m._columns[2], (T)0);
 		this->_columns[3] = tvec4<T>((T)0, (T)0, (T)0, (T)1);
 	}
-	inline tmat4x4(const tmat4x4& m)
+	inline GMATH_CONSTEXPR tmat4x4(const tquat<T>& q)
 	{
-		this->_columns[0] = m._columns[0];
-		this->_columns[1] = m._columns[1];
-		this->_columns[2] = m._columns[2];
-		this->_columns[3] = m._columns[3];
+		tmat3x3<T> m(q);
+		this->_columns[0] = tvec4<T>(m._columns[0], (T)0);
+		this->_columns[1] = tvec4<T>(m._columns[1], (T)0);
+		this->_columns[2] = tvec4<T>(m._columns[2], (T)0);
+		this->_columns[3] = tvec4<T>((T)0, (T)0, (T)0, (T)1);
 	}
-	inline ~tmat4x4() {}
 
-	inline const int columns() const
+	inline GMATH_CONSTEXPR const int columns() const
 	{
 		return 4;
 	}
-	inline const int rows() const
+	inline GMATH_CONSTEXPR const int rows() const
 	{
 		return 4;
 	}
 
-	inline void operator=(const tmat4x4<T>& m)
-	{
-		this->_columns[0] = m._columns[0];
-		this->_columns[1] = m._columns[1];
-		this->_columns[2] = m._columns[2];
-		this->_columns[3] = m._columns[3];
-	}
 	inline operator T*() const
 	{
 		return (T*)(this->_columns[0]);
@@ -1154,7 +1184,7 @@ template <typename T> inline tmat3x3<T> inverse(const tmat3x3<T>& m)
 	inverse /= determinate(m);
 	return inverse;
 }
-template <typename T> inline tmat4x4<T> inverse(const tmat4x4<T>& m)
+template <typename T> inline tmat4x4<T> inverse(const tmat4x4<T>& m, T& determinant)
 {
 	T c00 = m._columns[2][2] * m._columns[3][3] - m._columns[3][2] * m._columns[2][3];
 	T c02 = m._columns[1][2] * m._columns[3][3] - m._columns[3][2] * m._columns[1][3];
@@ -1203,11 +1233,16 @@ template <typename T> inline tmat4x4<T> inverse(const tmat4x4<T>& m)
 	tmat4x4<T> inverse(i0, i1, i2, i3);
 	tvec4<T> row(inverse[0][0], inverse[1][0], inverse[2][0], inverse[3][0]);
 
-	T determinant = dot(m._columns[0], row);
+	determinant = dot(m._columns[0], row);
 
 	inverse /= determinant;
 	return inverse;
 }
+template <typename T> inline tmat4x4<T> inverse(const tmat4x4<T>& m)
+{
+	T determinant;
+	return inverse(m, determinant);
+}
 
 template <typename T> inline tmat3x3<T> transpose(const tmat4x4<T>& m)
 {
@@ -1227,7 +1262,7 @@ template <typename T> inline tmat3x3<T> transpose(const tmat3x3<T>& m)
 		);
 }
 
-template <typename T> inline tmat3x3<T> translate(const T x, const T y)
+template <typename T> inline GMATH_CONSTEXPR tmat3x3<T> translate(const T x, const T y)
 {
 	return tmat3x3<T>(
 		(T)1, (T)0, x,
@@ -1235,7 +1270,7 @@ template <typename T> inline tmat3x3<T> translate(const T x, const T y)
 		(T)0, (T)0, (T)1
 		);
 }
-template <typename T> inline tmat3x3<T> translate(const tvec2<T>& v)
+template <typename T> inline GMATH_CONSTEXPR tmat3x3<T> translate(const tvec2<T>& v)
 {
 	return translate(v.x, v.y);
 }
@@ -1251,7 +1286,7 @@ template <typename T> inline tmat3x3<T> translate(const tmat3x3<T>& m, const tve
 {
 	return translate(m, v.x, v.y);
 }
-template <typename T> inline tmat4x4<T> translate(const T x, const T y, const T z)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> translate(const T x, const T y, const T z)
 {
 	return tmat4x4<T>(
 		(T)1, (T)0, (T)0, x,
@@ -1260,7 +1295,7 @@ template <typename T> inline tmat4x4<T> translate(const T x, const T y, const T
 		(T)0, (T)0, (T)0, (T)1
 		);
 }
-template <typename T> inline tmat4x4<T> translate(const tvec3<T>& v)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> translate(const tvec3<T>& v)
 {
 	return translate(v.x, v.y, v.z);
 }
@@ -1278,11 +1313,11 @@ template <typename T> inline tmat4x4<T> translate(const tmat4x4<T>& m, const tve
 	return translate(m, v.x, v.y, v.z);
 }
 
-template <typename T> inline tmat3x3<T> rotate2d(const T theta)
+template <typename T> inline GMATH_CONSTEXPR tmat3x3<T> rotate2d(const T theta)
 {
 	T rad = radians<T>(theta);
-	T c = (T)cos(rad);
-	T s = (T)sin(rad);
+	T c = (T)ccos(rad);
+	T s = (T)csin(rad);
 
 	return tmat3x3<T>(
 		c, -s, (T)0,
@@ -1303,11 +1338,11 @@ template <typename T> inline tmat3x3<T> rotate2d(const tmat3x3<T>& m, const T th
 		);
 }
 
-template <typename T> inline tmat4x4<T> rotateX(const T theta)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> rotateX(const T theta)
 {
 	T rad = radians<T>(theta);
-	T c = (T)cos(rad);
-	T s = (T)sin(rad);
+	T c = (T)ccos(rad);
+	T s = (T)csin(rad);
 
 	return tmat4x4<T>(
 		(T)1, (T)0, (T)0, (T)0,
@@ -1330,11 +1365,11 @@ template <typename T> inline tmat4x4<T> rotateX(const tmat4x4<T>& m, const T the
 		);
 }
 
-template <typename T> inline tmat4x4<T> rotateY(const T theta)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> rotateY(const T theta)
 {
 	T rad = radians<T>(theta);
-	T c = (T)cos(rad);
-	T s = (T)sin(rad);
+	T c = (T)ccos(rad);
+	T s = (T)csin(rad);
 
 	return tmat4x4<T>(
 		c, (T)0, s, (T)0,
@@ -1357,11 +1392,11 @@ template <typename T> inline tmat4x4<T> rotateY(const tmat4x4<T>& m, const T the
 		);
 }
 
-template <typename T> inline tmat4x4<T> rotateZ(const T theta)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> rotateZ(const T theta)
 {
 	T rad = radians<T>(theta);
-	T c = (T)cos(rad);
-	T s = (T)sin(rad);
+	T c = (T)ccos(rad);
+	T s = (T)csin(rad);
 
 	return tmat4x4<T>(
 		c, -s, (T)0, (T)0,
@@ -1438,10 +1473,10 @@ template <typename T> inline tmat4x4<T> rotate(const tmat4x4<T>& m, const T thet
 }
 template <typename T> inline tmat4x4<T> rotate(const tmat4x4<T>& m, const tvec3<T>& rotation)
 {
-	return rotateX(rotateY(rotateZ(m, rotation.z), rotation.y), rotation.x);
+	return m * tmat4x4<T>(tquat<T>(rotation));
 }
 
-template <typename T> inline tmat3x3<T> scale(const T x, const T y)
+template <typename T> inline GMATH_CONSTEXPR tmat3x3<T> scale(const T x, const T y)
 {
 	return tmat3x3<T>(
 		x, (T)0, (T)0,
@@ -1449,7 +1484,7 @@ template <typename T> inline tmat3x3<T> scale(const T x, const T y)
 		(T)0, (T)0, (T)1
 		);
 }
-template <typename T> inline tmat3x3<T> scale(const tvec2<T>& v)
+template <typename T> inline GMATH_CONSTEXPR tmat3x3<T> scale(const tvec2<T>& v)
 {
 	return scale(v.x, v.y);
 }
@@ -1465,7 +1500,7 @@ template <typename T> inline tmat3x3<T> scale(const tmat3x3<T>& m, const tvec2<T
 {
 	return scale(m, v.x, v.y);
 }
-template <typename T> inline tmat4x4<T> scale(const T x, const T y, const T z)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> scale(const T x, const T y, const T z)
 {
 	return tmat4x4<T>(
 		x, (T)0, (T)0, (T)0,
@@ -1474,7 +1509,7 @@ template <typename T> inline tmat4x4<T> scale(const T x, const T y, const T z)
 		(T)0, (T)0, (T)0, (T)1
 		);
 }
-template <typename T> inline tmat4x4<T> scale(const tvec3<T>& v)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> scale(const tvec3<T>& v)
 {
 	return scale(v.x, v.y, v.z);
 }
@@ -1492,7 +1527,7 @@ template <typename T> inline tmat4x4<T> scale(const tmat4x4<T>& m, const tvec3<T
 	return scale(m, v.x, v.y, v.z);
 }
 
-template <typename T> inline tmat4x4<T> orthogonal(const T left, const T right, const T bottom, const T top, const T nearZ, const T farZ)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> orthogonal(const T left, const T right, const T bottom, const T top, const T nearZ, const T farZ)
 {
 	return tmat4x4<T>(
 		(T)2 / (right - left), (T)0, (T)0, (right + left) / (right - left),
@@ -1501,7 +1536,7 @@ template <typename T> inline tmat4x4<T> orthogonal(const T left, const T right,
 		(T)0, (T)0, (T)0, (T)1
 		);
 }
-template <typename T> inline tmat4x4<T> orthogonal(const T left, const T right, const T bottom, const T top)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> orthogonal(const T left, const T right, const T bottom, const T top)
 {
 	return tmat4x4<T>(
 		(T)2 / (right - left), (T)0, (T)0, (right + left) / (right - left),
@@ -1511,7 +1546,7 @@ template <typename T> inline tmat4x4<T> orthogonal(const T left, const T right,
 		);
 }
 
-template <typename T> inline tmat4x4<T> frustum(const T left, const T right, const T bottom, const T top, const T nearZ, const T farZ)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> frustum(const T left, const T right, const T bottom, const T top, const T nearZ, const T farZ)
 {
 	return tmat4x4<T>(
 		((T)2 * nearZ) / (right - left), (T)0, (right + left) / (right - left), (T)0,
@@ -1521,10 +1556,10 @@ template <typename T> inline tmat4x4<T> frustum(const T left, const T right, con
 		);
 }
 
-template <typename T> inline tmat4x4<T> perspective(const T fov, const T aspect, const T nearZ, const T farZ)
+template <typename T> inline GMATH_CONSTEXPR tmat4x4<T> perspective(const T fov, const T aspect, const T nearZ, const T farZ)
 {
 	T rad = radians<T>(fov);
-	T range = (T)tan(rad / (T)2);
+	T range = (T)ctan(rad / (T)2);
 	return tmat4x4<T>(
 		(T)1 / (aspect * range), (T)0, (T)0, (T)0,
 		(T)0, (T)1 / range, (T)0, (T)0,
@@ -1727,6 +1762,122 @@ template <typename T> inline tmat4x4<T> operator/(const T x, const tmat4x4<T>& m
 	return tmat4x4<T>(x / m._columns[0], x / m._columns[1], x / m._columns[2], x / m._columns[3]);
 }
 
+template <typename T> inline tquat<T>::tquat(const tmat3x3<T>& m)
+{
+	T trace = m._columns[0][0] + m._columns[1][1] + m._columns[2][2];
+	if (trace > (T)0)
+	{
+		T s = (T)sqrt(trace + (T)1) * (T)2;
+		this->x = (m._columns[1][2] - m._columns[2][1]) / s;
+		this->y = (m._columns[2][0] - m._columns[0][2]) / s;
+		this->z = (m._columns[0][1] - m._columns[1][0]) / s;
+		this->w = s * (T)0.25;
+	}
+	else if (m._columns[0][0] > m._columns[1][1] && m._columns[0][0] > m._columns[2][2])
+	{
+		T s = (T)sqrt((T)1 + m._columns[0][0] - m._columns[1][1] - m._columns[2][2]) * (T)2;
+		this->x = s * (T)0.25;
+		this->y = (m._columns[1][0] + m._columns[0][1]) / s;
+		this->z = (m._columns[2][0] + m._columns[0][2]) / s;
+		this->w = (m._columns[1][2] - m._columns[2][1]) / s;
+	}
+	else if (m._columns[1][1] > m._columns[2][2])
+	{
+		T s = (T)sqrt((T)1 + m._columns[1][1] - m._columns[0][0] - m._columns[2][2]) * (T)2;
+		this->x = (m._columns[1][0] + m._columns[0][1]) / s;
+		this->y = s * (T)0.25;
+		this->z = (m._columns[2][1] + m._columns[1][2]) / s;
+		this->w = (m._columns[2][0] - m._columns[0][2]) / s;
+	}
+	else
+	{
+		T s = (T)sqrt((T)1 + m._columns[2][2] - m._columns[0][0] - m._columns[1][1]) * (T)2;
+		this->x = (m._columns[2][0] + m._columns[0][2]) / s;
+		this->y = (m._columns[2][1] + m._columns[1][2]) / s;
+		this->z = s * (T)0.25;
+		this->w = (m._columns[0][1] - m._columns[1][0]) / s;
+	}
+}
+template <typename T> inline tquat<T>::tquat(const tmat4x4<T>& m)
+{
+	*this = tquat<T>(tmat3x3<T>(m));
+}
+
+template <typename T> inline tmat4x4<T> compose(const tvec3<T>& translation, const tquat<T>& rotation, const tvec3<T>& scale)
+{
+	tmat4x4<T> m = gmath::scale(tmat4x4<T>(rotation), scale);
+	m._columns[3] = tvec4<T>(translation, (T)1);
+	return m;
+}
+template <typename T> inline void decompose(const tmat4x4<T>& m, tvec3<T>& translation, tquat<T>& rotation, tvec3<T>& scale)
+{
+	// shear is not separated out, the rotation is taken from the normalized columns as they are
+	tvec3<T> c0(m._columns[0].x, m._columns[0].y, m._columns[0].z);
+	tvec3<T> c1(m._columns[1].x, m._columns[1].y, m._columns[1].z);
+	tvec3<T> c2(m._columns[2].x, m._columns[2].y, m._columns[2].z);
+	translation = tvec3<T>(m._columns[3].x, m._columns[3].y, m._columns[3].z);
+	scale = tvec3<T>(magnitude(c0), magnitude(c1), magnitude(c2));
+
+	// a mirrored basis is not a rotation, so the reflection goes into the x scale
+	if (dot(c0, crossUnnormalized(c1, c2)) < (T)0)
+	{
+		scale.x = -scale.x;
+	}
+
+	// an axis scaled to nothing has no direction of its own, so it is rebuilt from the others
+	// with cross products and the rotation stays orthonormal
+	tvec3<T> axes[3] = { c0, c1, c2 };
+	T s[3] = { scale.x, scale.y, scale.z };
+	T size[3] = { s[0] < (T)0 ? -s[0] : s[0], s[1], s[2] };
+	T largest = size[0] > size[1] ? size[0] : size[1];
+	largest = largest > size[2] ? largest : size[2];
+	int missing = 0;
+	int kept = 0;
+	bool valid[3];
+	for (int i = 0; i < 3; i++)
+	{
+		valid[i] = size[i] > largest * (T)FLT_EPSILON;
+		if (valid[i])
+		{
+			axes[i] = axes[i] / s[i];
+			kept = i;
+		}
+		else
+		{
+			missing++;
+		}
+	}
+	if (missing == 3)
+	{
+		axes[0] = tvec3<T>((T)1, (T)0, (T)0);
+		axes[1] = tvec3<T>((T)0, (T)1, (T)0);
+		axes[2] = tvec3<T>((T)0, (T)0, (T)1);
+	}
+	else if (missing == 2)
+	{
+		// any perpendicular pair will do, started from the world axis least aligned with the one left
+		const tvec3<T>& a = axes[kept];
+		T ax = a.x < (T)0 ? -a.x : a.x;
+		T ay = a.y < (T)0 ? -a.y : a.y;
+		T az = a.z < (T)0 ? -a.z : a.z;
+		tvec3<T> e = ax <= ay && ax <= az ? tvec3<T>((T)1, (T)0, (T)0) : (ay <= az ? tvec3<T>((T)0, (T)1, (T)0) : tvec3<T>((T)0, (T)0, (T)1));
+		axes[(kept + 1) % 3] = normalize(crossUnnormalized(a, e));
+		axes[(kept + 2) % 3] = crossUnnormalized(a, axes[(kept + 1) % 3]);
+	}
+	else if (missing == 1)
+	{
+		for (int i = 0; i < 3; i++)
+		{
+			if (!valid[i])
+			{
+				axes[i] = normalize(crossUnnormalized(axes[(i + 1) % 3], axes[(i + 2) % 3]));
+			}
+		}
+	}
+
+	rotation = tquat<T>(tmat3x3<T>(axes[0], axes[1], axes[2]));
+}
+
 typedef tmat3x3<float> mat3;
 typedef tmat3x3<int> imat3;
 typedef tmat4x4<float> mat4;
@@ -1734,4 +1885,7 @@ typedef tmat4x4<int> imat4;
 #endif
 
 }
+
+#include <simd.hpp>
+
 #endif
\ No newline at end of file
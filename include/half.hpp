@@ -0,0 +1,276 @@
+#ifndef HALF_H
+#define HALF_H
+
+#include <string.h>
+
+#include <gmath.hpp>
+#include <batch.hpp>
+
+namespace gmath
+{
+
+#if !(defined(half) || defined(hvec2) || defined(hvec3) || defined(hvec4))
+// IEEE 754 binary16, for storage only; arithmetic goes through float. Conversion rounds to nearest even
+// and gives the same bits as the F16C instructions, so scalar remainders match the bulk kernels.
+struct half
+{
+
+	inline half() : value(0) {}
+	inline explicit half(const float x) : value(half::encode(x)) {}
+
+	static inline half bits(const unsigned short x)
+	{
+		half r;
+		r.value = x;
+		return r;
+	}
+
+	static inline unsigned short encode(const float f)
+	{
+		unsigned int x;
+		memcpy(&x, &f, sizeof(x));
+		unsigned short sign = (unsigned short)((x >> 16) & 0x8000);
+		x &= 0x7FFFFFFF;
+
+		// 65536 and up overflows, NaNs keep the top of their payload and become quiet
+		if (x >= 0x47800000)
+		{
+			return sign | (x > 0x7F800000 ? (unsigned short)(0x7E00 | ((x >> 13) & 0x3FF)) : (unsigned short)0x7C00);
+		}
+
+		// below 2^-14 the result is subnormal, and at or below 2^-25 it rounds to zero
+		if (x < 0x38800000)
+		{
+			if (x <= 0x33000000)
+			{
+				return sign;
+			}
+
+			unsigned int shift = 126 - (x >> 23);
+			unsigned int m = (x & 0x7FFFFF) | 0x800000;
+			unsigned int r = m >> shift;
+			unsigned int rest = m & ((1u << shift) - 1);
+			unsigned int middle = 1u << (shift - 1);
+			r += (rest > middle || (rest == middle && (r & 1) != 0)) ? 1 : 0;
+			return sign | (unsigned short)r;
+		}
+
+		// rebias, then round the 13 dropped bits; a carry runs into the exponent and up to infinity
+		x += 0xC8000FFF + ((x >> 13) & 1);
+		return sign | (unsigned short)(x >> 13);
+	}
+	static inline float decode(const unsigned short h)
+	{
+		unsigned int e = (h >> 10) & 0x1F;
+		unsigned int m = h & 0x3FF;
+		unsigned int x;
+		if (e == 0x1F)
+		{
+			x = 0x7F800000 | (m << 13) | (m != 0 ? 0x400000 : 0);
+		}
+		else if (e != 0)
+		{
+			x = ((e + 112) << 23) | (m << 13);
+		}
+		else if (m != 0)
+		{
+			e = 113;
+			while ((m & 0x400) == 0)
+			{
+				m <<= 1;
+				e--;
+			}
+			x = (e << 23) | ((m & 0x3FF) << 13);
+		}
+		else
+		{
+			x = 0;
+		}
+
+		x |= (unsigned int)(h & 0x8000) << 16;
+		float f;
+		memcpy(&f, &x, sizeof(f));
+		return f;
+	}
+
+	inline operator float() const { return half::decode(this->value); }
+
+	unsigned short value;
+
+};
+
+// A float in [-1, 1] stored as round(x * 32767). Values outside the range clamp to it, and -32768 reads
+// back as -1 like the graphics APIs do.
+struct snorm16
+{
+
+	inline snorm16() : value(0) {}
+	inline explicit snorm16(const float x) : value(snorm16::encode(x)) {}
+
+	static inline snorm16 bits(const short x)
+	{
+		snorm16 r;
+		r.value = x;
+		return r;
+	}
+
+	// written as the max and min the SIMD kernels use, NaN included
+	static inline short encode(const float x)
+	{
+		float c = x > -1.0f ? x : -1.0f;
+		c = c < 1.0f ? c : 1.0f;
+		return (short)lrintf(c * 32767.0f);
+	}
+	static inline float decode(const short x)
+	{
+		float f = (float)x * (1.0f / 32767.0f);
+		return f > -1.0f ? f : -1.0f;
+	}
+
+	inline operator float() const { return snorm16::decode(this->value); }
+
+	short value;
+
+};
+
+// Bulk conversions between float arrays and the storage types, count is in scalars.
+inline void pack(const float* in, half* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_AVX512)
+	for (; i + 16 <= count; i += 16)
+	{
+		_mm256_storeu_si256((__m256i*)(out + i), _mm512_cvtps_ph(_mm512_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+	}
+#endif
+#if defined(GMATH_F16C)
+	for (; i + 8 <= count; i += 8)
+	{
+		_mm_storeu_si128((__m128i*)(out + i), _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = half(in[i]);
+	}
+}
+inline void unpack(const half* in, float* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_AVX512)
+	for (; i + 16 <= count; i += 16)
+	{
+		_mm512_storeu_ps(out + i, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(in + i))));
+	}
+#endif
+#if defined(GMATH_F16C)
+	for (; i + 8 <= count; i += 8)
+	{
+		_mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(in + i))));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = (float)in[i];
+	}
+}
+inline void pack(const float* in, snorm16* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_AVX)
+	const __m256 lo8 = _mm256_set1_ps(-1.0f);
+	const __m256 hi8 = _mm256_set1_ps(1.0f);
+	const __m256 scale8 = _mm256_set1_ps(32767.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 c = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i), lo8), hi8);
+		__m256i n = _mm256_cvtps_epi32(_mm256_mul_ps(c, scale8));
+		_mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(_mm256_castsi256_si128(n), _mm256_extractf128_si256(n, 1)));
+	}
+#endif
+#if defined(GMATH_SSE41)
+	const __m128 lo = _mm_set1_ps(-1.0f);
+	const __m128 hi = _mm_set1_ps(1.0f);
+	const __m128 scale = _mm_set1_ps(32767.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i n = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi), scale));
+		_mm_storel_epi64((__m128i*)(out + i), _mm_packs_epi32(n, n));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = snorm16(in[i]);
+	}
+}
+inline void unpack(const snorm16* in, float* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_AVX2)
+	const __m256 lo8 = _mm256_set1_ps(-1.0f);
+	const __m256 scale8 = _mm256_set1_ps(1.0f / 32767.0f);
+	for (; i + 8 <= count; i += 8)
+	{
+		__m256 f = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)(in + i))));
+		_mm256_storeu_ps(out + i, _mm256_max_ps(_mm256_mul_ps(f, scale8), lo8));
+	}
+#endif
+#if defined(GMATH_SSE41)
+	const __m128 lo = _mm_set1_ps(-1.0f);
+	const __m128 scale = _mm_set1_ps(1.0f / 32767.0f);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 f = _mm_cvtepi32_ps(_mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i*)(in + i))));
+		_mm_storeu_ps(out + i, _mm_max_ps(_mm_mul_ps(f, scale), lo));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		out[i] = (float)in[i];
+	}
+}
+
+// Vectors are tightly packed, so an array of them converts as one run of scalars.
+template <int N> inline void pack(const tvec<N, float>* in, tvec<N, half>* out, const size_t count)
+{
+	pack((const float*)in, (half*)out, count * N);
+}
+template <int N> inline void unpack(const tvec<N, half>* in, tvec<N, float>* out, const size_t count)
+{
+	unpack((const half*)in, (float*)out, count * N);
+}
+template <int N> inline void pack(const tvec<N, float>* in, tvec<N, snorm16>* out, const size_t count)
+{
+	pack((const float*)in, (snorm16*)out, count * N);
+}
+template <int N> inline void unpack(const tvec<N, snorm16>* in, tvec<N, float>* out, const size_t count)
+{
+	unpack((const snorm16*)in, (float*)out, count * N);
+}
+
+template <typename I, typename O> inline void pack(const I* in, O* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		pack(in + begin, out + begin, end - begin);
+	});
+}
+template <typename I, typename O> inline void unpack(const I* in, O* out, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		unpack(in + begin, out + begin, end - begin);
+	});
+}
+
+typedef tvec2<half> hvec2;
+typedef tvec3<half> hvec3;
+typedef tvec4<half> hvec4;
+typedef tvec2<snorm16> snvec2;
+typedef tvec3<snorm16> snvec3;
+typedef tvec4<snorm16> snvec4;
+#endif
+
+}
+
+#endif
\ No newline at end of file
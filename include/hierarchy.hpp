@@ -0,0 +1,245 @@
+#ifndef HIERARCHY_H
+#define HIERARCHY_H
+
+#include <gmath.hpp>
+#include <batch.hpp>
+#include <array.hpp>
+
+namespace gmath
+{
+
+#if !(defined(thierarchy) || defined(hierarchy))
+template <typename T> class thierarchy
+{
+public:
+
+	thierarchy() : _height(0) {}
+	~thierarchy() {}
+
+	const int add(const int parent)
+	{
+		return this->add(parent, tvec3<T>(), tquat<T>(), tvec3<T>((T)1, (T)1, (T)1));
+	}
+	// Returns the new node, or -1 if parent is neither -1 (a root) nor an existing node.
+	const int add(const int parent, const tvec3<T>& position, const tquat<T>& rotation, const tvec3<T>& scale)
+	{
+		// parents always precede their children, so the arrays stay sorted by parent
+		int index = this->_parents.count();
+		if (parent < -1 || parent >= index)
+		{
+			return -1;
+		}
+
+		int p = parent;
+		int depth = p < 0 ? 0 : ((int*)this->_depths)[p] + 1;
+		this->_parents.add(p);
+		this->_depths.add(depth);
+		this->_children.add(-1);
+		this->_siblings.add(p < 0 ? -1 : ((int*)this->_children)[p]);
+		if (p >= 0)
+		{
+			((int*)this->_children)[p] = index;
+		}
+
+		this->_positions.add(position);
+		this->_rotations.add(rotation);
+		this->_scales.add(scale);
+		this->_worlds.add(tmat4x4<T>());
+		this->_dirty.add(0);
+		this->_height = depth + 1 > this->_height ? depth + 1 : this->_height;
+
+		this->reserve();
+		this->invalidate(index);
+		return index;
+	}
+
+	void setPosition(const int index, const tvec3<T>& position)
+	{
+		((tvec3<T>*)this->_positions)[index] = position;
+		this->invalidate(index);
+	}
+	void setRotation(const int index, const tquat<T>& rotation)
+	{
+		((tquat<T>*)this->_rotations)[index] = rotation;
+		this->invalidate(index);
+	}
+	void setScale(const int index, const tvec3<T>& scale)
+	{
+		((tvec3<T>*)this->_scales)[index] = scale;
+		this->invalidate(index);
+	}
+	void setLocal(const int index, const tvec3<T>& position, const tquat<T>& rotation, const tvec3<T>& scale)
+	{
+		((tvec3<T>*)this->_positions)[index] = position;
+		((tquat<T>*)this->_rotations)[index] = rotation;
+		((tvec3<T>*)this->_scales)[index] = scale;
+		this->invalidate(index);
+	}
+
+	const int size() const
+	{
+		return this->_parents.count();
+	}
+	const int parent(const int index) const
+	{
+		return ((int*)this->_parents)[index];
+	}
+	const int depth(const int index) const
+	{
+		return ((int*)this->_depths)[index];
+	}
+	const tvec3<T>& position(const int index) const
+	{
+		return ((tvec3<T>*)this->_positions)[index];
+	}
+	const tquat<T>& rotation(const int index) const
+	{
+		return ((tquat<T>*)this->_rotations)[index];
+	}
+	const tvec3<T>& scale(const int index) const
+	{
+		return ((tvec3<T>*)this->_scales)[index];
+	}
+	tmat4x4<T> local(const int index) const
+	{
+		return compose(this->position(index), this->rotation(index), this->scale(index));
+	}
+	const tmat4x4<T>& world(const int index) const
+	{
+		return ((tmat4x4<T>*)this->_worlds)[index];
+	}
+	const tmat4x4<T>* worlds() const
+	{
+		return (tmat4x4<T>*)this->_worlds;
+	}
+	bool dirty(const int index) const
+	{
+		return ((unsigned char*)this->_dirty)[index] != 0;
+	}
+
+	// Recomputes the world matrix of every node whose local transform changed since the last
+	// update, and of everything below it. Each level only depends on the one above, so the nodes
+	// of a level are split across threads.
+	const int update(const unsigned int threads = 1)
+	{
+		const int* parents = (int*)this->_parents;
+		const int* depths = (int*)this->_depths;
+		const int* children = (int*)this->_children;
+		const int* siblings = (int*)this->_siblings;
+		const int* pending = (int*)this->_pending;
+		unsigned char* dirty = (unsigned char*)this->_dirty;
+		int* queue = (int*)this->_queue;
+		int* order = (int*)this->_order;
+		int* levels = (int*)this->_levels;
+
+		int count = 0;
+		for (int i = 0; i < this->_pending.count(); i++)
+		{
+			int root = pending[i];
+			if (dirty[root] == 2)
+			{
+				continue;
+			}
+
+			int first = count;
+			queue[count++] = root;
+			dirty[root] = 2;
+			for (int k = first; k < count; k++)
+			{
+				for (int c = children[queue[k]]; c >= 0; c = siblings[c])
+				{
+					if (dirty[c] != 2)
+					{
+						dirty[c] = 2;
+						queue[count++] = c;
+					}
+				}
+			}
+		}
+		this->_pending.reset();
+
+		memset(levels, 0, sizeof(int) * (this->_height + 1));
+		for (int i = 0; i < count; i++)
+		{
+			levels[depths[queue[i]] + 1]++;
+		}
+		for (int d = 0; d < this->_height; d++)
+		{
+			levels[d + 1] += levels[d];
+		}
+		for (int i = 0; i < count; i++)
+		{
+			order[levels[depths[queue[i]]]++] = queue[i];
+		}
+
+		tmat4x4<T>* worlds = (tmat4x4<T>*)this->_worlds;
+		int begin = 0;
+		for (int d = 0; d < this->_height && begin < count; d++)
+		{
+			const int* level = order + begin;
+			int end = levels[d];
+			parallel((size_t)(end - begin), threads, [&](const size_t first, const size_t last)
+			{
+				for (size_t i = first; i < last; i++)
+				{
+					int node = level[i];
+					int p = parents[node];
+					worlds[node] = p < 0 ? this->local(node) : worlds[p] * this->local(node);
+					dirty[node] = 0;
+				}
+			});
+			begin = end;
+		}
+
+		return count;
+	}
+
+private:
+
+	void invalidate(const int index)
+	{
+		unsigned char* dirty = (unsigned char*)this->_dirty;
+		if (dirty[index] == 0)
+		{
+			dirty[index] = 1;
+			this->_pending.add(index);
+		}
+	}
+	void reserve()
+	{
+		int capacity = this->_parents.capacity();
+		if (this->_queue.capacity() < capacity)
+		{
+			this->_queue.resize(capacity);
+			this->_order.resize(capacity);
+		}
+		if (this->_levels.capacity() < this->_height + 1)
+		{
+			this->_levels.resize((this->_height + 1) * 2);
+		}
+	}
+
+	Array<int> _parents;
+	Array<int> _depths;
+	Array<int> _children;
+	Array<int> _siblings;
+	Array<tvec3<T> > _positions;
+	Array<tquat<T> > _rotations;
+	Array<tvec3<T> > _scales;
+	Array<tmat4x4<T> > _worlds;
+	Array<unsigned char> _dirty;
+
+	Array<int> _pending;
+	Array<int> _queue;
+	Array<int> _order;
+	Array<int> _levels;
+	int _height;
+
+};
+
+typedef thierarchy<float> hierarchy;
+#endif
+
+}
+
+#endif
\ No newline at end of file
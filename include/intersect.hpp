@@ -0,0 +1,513 @@
+#ifndef INTERSECT_H
+#define INTERSECT_H
+
+#include <float.h>
+
+#include <gmath.hpp>
+#include <batch.hpp>
+
+namespace gmath
+{
+
+#if !(defined(thit) || defined(hit))
+// Where a ray meets a triangle: the distance along the ray in units of its direction, and the weights
+// of the second and third vertex; the first one gets 1 - u - v. Misses have a distance of FLT_MAX.
+template <typename T> struct thit
+{
+
+	inline thit() : distance((T)FLT_MAX), u((T)0), v((T)0) {}
+	inline thit(const T distance, const T u, const T v) : distance(distance), u(u), v(v) {}
+
+	T distance;
+	T u;
+	T v;
+
+};
+
+typedef thit<float> hit;
+#endif
+
+namespace simd
+{
+
+// e[0] to e[2] hold the origins, e[3] to e[5] the directions and e[6] the lengths of L::width rays
+template <typename L, typename T> inline void gather(const tray<T>* r, L* e)
+{
+	T x[L::width];
+	for (int k = 0; k < 7; k++)
+	{
+		for (int j = 0; j < L::width; j++)
+		{
+			x[j] = k == 6 ? r[j].length : ((const T*)(k < 3 ? &r[j].origin : &r[j].direction))[k % 3];
+		}
+
+		e[k] = L::load(x);
+	}
+}
+template <typename L, typename T> inline void broadcast(const tray<T>& r, L* e)
+{
+	e[0] = L(r.origin.x);
+	e[1] = L(r.origin.y);
+	e[2] = L(r.origin.z);
+	e[3] = L(r.direction.x);
+	e[4] = L(r.direction.y);
+	e[5] = L(r.direction.z);
+	e[6] = L(r.length);
+}
+
+#if defined(GMATH_SSE41)
+// A float ray is seven consecutive floats, so two unaligned loads per ray and two transposes do it.
+inline void gather(const tray<float>* r, f32x4* e)
+{
+	__m128 o0 = _mm_loadu_ps(&r[0].origin.x);
+	__m128 o1 = _mm_loadu_ps(&r[1].origin.x);
+	__m128 o2 = _mm_loadu_ps(&r[2].origin.x);
+	__m128 o3 = _mm_loadu_ps(&r[3].origin.x);
+	__m128 d0 = _mm_loadu_ps(&r[0].direction.x);
+	__m128 d1 = _mm_loadu_ps(&r[1].direction.x);
+	__m128 d2 = _mm_loadu_ps(&r[2].direction.x);
+	__m128 d3 = _mm_loadu_ps(&r[3].direction.x);
+	_MM_TRANSPOSE4_PS(o0, o1, o2, o3);
+	_MM_TRANSPOSE4_PS(d0, d1, d2, d3);
+	e[0] = o0;
+	e[1] = o1;
+	e[2] = o2;
+	e[3] = d0;
+	e[4] = d1;
+	e[5] = d2;
+	e[6] = d3;
+}
+#endif
+#if defined(GMATH_AVX)
+inline void gather(const tray<float>* r, f32x8* e)
+{
+	f32x4 lo[7];
+	f32x4 hi[7];
+	gather(r, lo);
+	gather(r + 4, hi);
+	for (int k = 0; k < 7; k++)
+	{
+		e[k] = _mm256_insertf128_ps(_mm256_castps128_ps256(lo[k].value), hi[k].value, 1);
+	}
+}
+#endif
+
+}
+
+namespace batch
+{
+
+template <typename L> inline L dot3(const L* a, const L* b)
+{
+	return madd(a[2], b[2], madd(a[1], b[1], a[0] * b[0]));
+}
+template <typename L> inline void cross3(const L* a, const L* b, L* r)
+{
+	r[0] = (a[1] * b[2]) - (a[2] * b[1]);
+	r[1] = (a[2] * b[0]) - (a[0] * b[2]);
+	r[2] = (a[0] * b[1]) - (a[1] * b[0]);
+}
+
+// The kernels take rays laid out as simd::gather leaves them and hit from either side. A lane hits
+// when the distance falls between 0 and the ray length.
+template <typename L> inline typename L::mask triangle(const L* r, const L* p0, const L* p1, const L* p2, L& t, L& u, L& v)
+{
+	// Moller-Trumbore: solve origin + t * direction = p0 + u * e1 + v * e2 with Cramer's rule
+	typedef typename L::type T;
+	const L zero((T)0);
+	const L one((T)1);
+	L e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+	L e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+	L s[3] = { r[0] - p0[0], r[1] - p0[1], r[2] - p0[2] };
+	L p[3];
+	L q[3];
+	cross3(r + 3, e2, p);
+	cross3(s, e1, q);
+
+	L det = dot3(e1, p);
+	L inv = one / det;
+	u = dot3(s, p) * inv;
+	v = dot3(r + 3, q) * inv;
+	t = dot3(e2, q) * inv;
+	return (det != zero) & (u >= zero) & (v >= zero) & ((u + v) <= one) & (t >= zero) & (t <= r[6]);
+}
+// s holds center and radius; from inside the sphere the exit is returned.
+template <typename L> inline typename L::mask sphere(const L* r, const L* s, L& t)
+{
+	typedef typename L::type T;
+	const L zero((T)0);
+	L oc[3] = { r[0] - s[0], r[1] - s[1], r[2] - s[2] };
+	L a = dot3(r + 3, r + 3);
+	L b = dot3(oc, r + 3);
+	L c = dot3(oc, oc) - (s[3] * s[3]);
+	L d = (b * b) - (a * c);
+	L root = sqrt(max(d, zero));
+	L inv = L((T)1) / a;
+	L t0 = (-b - root) * inv;
+	t = select(t0 >= zero, t0, (root - b) * inv);
+	return (d >= zero) & (t >= zero) & (t <= r[6]);
+}
+// p holds the plane as normal and offset, dot(normal, x) + offset = 0, as tviewfrustum keeps them.
+template <typename L> inline typename L::mask plane(const L* r, const L* p, L& t)
+{
+	typedef typename L::type T;
+	const L zero((T)0);
+	L d = dot3(p, r + 3);
+	t = -(dot3(p, r) + p[3]) / d;
+	return (d != zero) & (t >= zero) & (t <= r[6]);
+}
+// Narrows [t0, t1] to where the ray is between the two planes of one slab, front being the one it
+// meets first. A ray lying in a plane gives 0 * inf = NaN there; as the first operand of max and min
+// that leaves the interval as it is, in the scalar lanes and the SIMD ones alike, so the ray counts as
+// inside the slab. Every box test goes through here so they all agree on it.
+template <typename L> inline void slab(const L& origin, const L& inverse, const L& front, const L& back, L& t0, L& t1)
+{
+	t0 = max((front - origin) * inverse, t0);
+	t1 = min((back - origin) * inverse, t1);
+}
+// Slab test against the box between b0 and b1; inv is one over the ray direction. From inside the
+// box the distance is 0.
+template <typename L> inline typename L::mask box(const L* r, const L* inv, const L* b0, const L* b1, L& t)
+{
+	typedef typename L::type T;
+	const L zero((T)0);
+	L t0 = zero;
+	L t1 = r[6];
+	for (int k = 0; k < 3; k++)
+	{
+		typename L::mask negative = inv[k] < zero;
+		slab(r[k], inv[k], select(negative, b1[k], b0[k]), select(negative, b0[k], b1[k]), t0, t1);
+	}
+
+	t = t0;
+	return t0 <= t1;
+}
+
+template <typename L, typename T> inline void scatter(const typename L::mask& m, const L& t, const L& u, const L& v, thit<T>* hits)
+{
+	T d[L::width];
+	T a[L::width];
+	T b[L::width];
+	select(m, t, L((T)FLT_MAX)).store(d);
+	u.store(a);
+	v.store(b);
+	for (int j = 0; j < L::width; j++)
+	{
+		hits[j] = thit<T>(d[j], a[j], b[j]);
+	}
+}
+template <typename L, typename T> inline void scatter(const typename L::mask& m, const L& t, T* distances)
+{
+	select(m, t, L((T)FLT_MAX)).store(distances);
+}
+
+// Keeps the nearest of the lanes set in mask, lane j being primitive i + j.
+template <typename T> inline void closest(int mask, const thit<T>* hits, const size_t i, size_t& n, T& d)
+{
+	for (int j = 0; mask != 0; j++, mask >>= 1)
+	{
+		if ((mask & 1) != 0 && hits[j].distance < d)
+		{
+			d = hits[j].distance;
+			n = i + j;
+		}
+	}
+}
+template <typename T> inline void closest(int mask, const T* distances, const size_t i, size_t& n, T& d)
+{
+	for (int j = 0; mask != 0; j++, mask >>= 1)
+	{
+		if ((mask & 1) != 0 && distances[j] < d)
+		{
+			d = distances[j];
+			n = i + j;
+		}
+	}
+}
+
+// One ray against L::width primitives per step, tracking the nearest hit in n and d, or L::width rays
+// against one primitive. Each returns where it stopped so a narrower lane can finish the rest.
+template <typename L, typename T> inline size_t triangles(size_t i, const tray<T>& ray, const tvec3<T>* v0, const tvec3<T>* v1, const tvec3<T>* v2, thit<T>* hits, const size_t count, size_t& n, T& d)
+{
+	L r[7];
+	simd::broadcast(ray, r);
+	for (; i + L::width <= count; i += L::width)
+	{
+		L p0[3];
+		L p1[3];
+		L p2[3];
+		simd::gather(v0 + i, p0);
+		simd::gather(v1 + i, p1);
+		simd::gather(v2 + i, p2);
+
+		L t;
+		L u;
+		L v;
+		typename L::mask m = triangle(r, p0, p1, p2, t, u, v);
+		scatter(m, t, u, v, hits + i);
+		closest(simd::bits(m), hits + i, i, n, d);
+	}
+
+	return i;
+}
+template <typename L, typename T> inline size_t triangles(size_t i, const tray<T>* rays, const tvec3<T>& v0, const tvec3<T>& v1, const tvec3<T>& v2, thit<T>* hits, const size_t count)
+{
+	const L p0[3] = { L(v0.x), L(v0.y), L(v0.z) };
+	const L p1[3] = { L(v1.x), L(v1.y), L(v1.z) };
+	const L p2[3] = { L(v2.x), L(v2.y), L(v2.z) };
+	for (; i + L::width <= count; i += L::width)
+	{
+		L r[7];
+		simd::gather(rays + i, r);
+
+		L t;
+		L u;
+		L v;
+		typename L::mask m = triangle(r, p0, p1, p2, t, u, v);
+		scatter(m, t, u, v, hits + i);
+	}
+
+	return i;
+}
+template <typename L, typename T> inline size_t spheres(size_t i, const tray<T>& ray, const tvec4<T>* spheres, T* distances, const size_t count, size_t& n, T& d)
+{
+	L r[7];
+	simd::broadcast(ray, r);
+	for (; i + L::width <= count; i += L::width)
+	{
+		L s[4];
+		simd::gather(spheres + i, s);
+
+		L t;
+		typename L::mask m = sphere(r, s, t);
+		scatter(m, t, distances + i);
+		closest(simd::bits(m), distances + i, i, n, d);
+	}
+
+	return i;
+}
+template <typename L, typename T> inline size_t spheres(size_t i, const tray<T>* rays, const tvec4<T>& sphere, T* distances, const size_t count)
+{
+	const L s[4] = { L(sphere.x), L(sphere.y), L(sphere.z), L(sphere.w) };
+	for (; i + L::width <= count; i += L::width)
+	{
+		L r[7];
+		simd::gather(rays + i, r);
+
+		L t;
+		typename L::mask m = batch::sphere(r, s, t);
+		scatter(m, t, distances + i);
+	}
+
+	return i;
+}
+template <typename L, typename T> inline size_t planes(size_t i, const tray<T>& ray, const tvec4<T>* planes, T* distances, const size_t count, size_t& n, T& d)
+{
+	L r[7];
+	simd::broadcast(ray, r);
+	for (; i + L::width <= count; i += L::width)
+	{
+		L p[4];
+		simd::gather(planes + i, p);
+
+		L t;
+		typename L::mask m = plane(r, p, t);
+		scatter(m, t, distances + i);
+		closest(simd::bits(m), distances + i, i, n, d);
+	}
+
+	return i;
+}
+template <typename L, typename T> inline size_t planes(size_t i, const tray<T>* rays, const tvec4<T>& plane, T* distances, const size_t count)
+{
+	const L p[4] = { L(plane.x), L(plane.y), L(plane.z), L(plane.w) };
+	for (; i + L::width <= count; i += L::width)
+	{
+		L r[7];
+		simd::gather(rays + i, r);
+
+		L t;
+		typename L::mask m = batch::plane(r, p, t);
+		scatter(m, t, distances + i);
+	}
+
+	return i;
+}
+template <typename L, typename T> inline size_t boxes(size_t i, const tray<T>& ray, const tvec3<T>* min, const tvec3<T>* max, T* distances, const size_t count, size_t& n, T& d)
+{
+	L r[7];
+	simd::broadcast(ray, r);
+	const L inv[3] = { L((T)1 / ray.direction.x), L((T)1 / ray.direction.y), L((T)1 / ray.direction.z) };
+	for (; i + L::width <= count; i += L::width)
+	{
+		L b0[3];
+		L b1[3];
+		simd::gather(min + i, b0);
+		simd::gather(max + i, b1);
+
+		L t;
+		typename L::mask m = box(r, inv, b0, b1, t);
+		scatter(m, t, distances + i);
+		closest(simd::bits(m), distances + i, i, n, d);
+	}
+
+	return i;
+}
+template <typename L, typename T> inline size_t boxes(size_t i, const tray<T>* rays, const tvec3<T>& min, const tvec3<T>& max, T* distances, const size_t count)
+{
+	typedef typename L::type S;
+	const L b0[3] = { L(min.x), L(min.y), L(min.z) };
+	const L b1[3] = { L(max.x), L(max.y), L(max.z) };
+	const L one((S)1);
+	for (; i + L::width <= count; i += L::width)
+	{
+		L r[7];
+		simd::gather(rays + i, r);
+		L inv[3] = { one / r[3], one / r[4], one / r[5] };
+
+		L t;
+		typename L::mask m = box(r, inv, b0, b1, t);
+		scatter(m, t, distances + i);
+	}
+
+	return i;
+}
+
+}
+
+// Single tests; the result is only written on a hit, so a loop can keep the nearest one by
+// shortening the ray length as it goes.
+template <typename T> inline bool intersectTriangle(const tray<T>& ray, const tvec3<T>& v0, const tvec3<T>& v1, const tvec3<T>& v2, thit<T>& hit)
+{
+	thit<T> h;
+	size_t n = 1;
+	T d = (T)FLT_MAX;
+	batch::triangles<simd::lane<T> >(0, ray, &v0, &v1, &v2, &h, 1, n, d);
+	hit = n == 0 ? h : hit;
+	return n == 0;
+}
+template <typename T> inline bool intersectSphere(const tray<T>& ray, const tvec4<T>& sphere, T& distance)
+{
+	T t;
+	size_t n = 1;
+	T d = (T)FLT_MAX;
+	batch::spheres<simd::lane<T> >(0, ray, &sphere, &t, 1, n, d);
+	distance = n == 0 ? t : distance;
+	return n == 0;
+}
+template <typename T> inline bool intersectPlane(const tray<T>& ray, const tvec4<T>& plane, T& distance)
+{
+	T t;
+	size_t n = 1;
+	T d = (T)FLT_MAX;
+	batch::planes<simd::lane<T> >(0, ray, &plane, &t, 1, n, d);
+	distance = n == 0 ? t : distance;
+	return n == 0;
+}
+template <typename T> inline bool intersectBox(const tray<T>& ray, const tvec3<T>& min, const tvec3<T>& max, T& distance)
+{
+	T t;
+	size_t n = 1;
+	T d = (T)FLT_MAX;
+	batch::boxes<simd::lane<T> >(0, ray, &min, &max, &t, 1, n, d);
+	distance = n == 0 ? t : distance;
+	return n == 0;
+}
+
+// One ray against many primitives, a SIMD register of them at a time. Every primitive gets its
+// result, misses FLT_MAX, and the index of the nearest hit is returned, or count when nothing is hit.
+template <typename T> inline size_t intersectTriangles(const tray<T>& ray, const tvec3<T>* v0, const tvec3<T>* v1, const tvec3<T>* v2, thit<T>* hits, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	size_t n = count;
+	T d = (T)FLT_MAX;
+	size_t i = batch::triangles<L>(0, ray, v0, v1, v2, hits, count, n, d);
+	batch::triangles<simd::lane<T> >(i, ray, v0, v1, v2, hits, count, n, d);
+	return n;
+}
+template <typename T> inline size_t intersectSpheres(const tray<T>& ray, const tvec4<T>* spheres, T* distances, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	size_t n = count;
+	T d = (T)FLT_MAX;
+	size_t i = batch::spheres<L>(0, ray, spheres, distances, count, n, d);
+	batch::spheres<simd::lane<T> >(i, ray, spheres, distances, count, n, d);
+	return n;
+}
+template <typename T> inline size_t intersectPlanes(const tray<T>& ray, const tvec4<T>* planes, T* distances, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	size_t n = count;
+	T d = (T)FLT_MAX;
+	size_t i = batch::planes<L>(0, ray, planes, distances, count, n, d);
+	batch::planes<simd::lane<T> >(i, ray, planes, distances, count, n, d);
+	return n;
+}
+template <typename T> inline size_t intersectBoxes(const tray<T>& ray, const tvec3<T>* min, const tvec3<T>* max, T* distances, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	size_t n = count;
+	T d = (T)FLT_MAX;
+	size_t i = batch::boxes<L>(0, ray, min, max, distances, count, n, d);
+	batch::boxes<simd::lane<T> >(i, ray, min, max, distances, count, n, d);
+	return n;
+}
+
+// Many rays against one primitive, a SIMD register of rays at a time, misses FLT_MAX.
+template <typename T> inline void intersectTriangle(const tray<T>* rays, const tvec3<T>& v0, const tvec3<T>& v1, const tvec3<T>& v2, thit<T>* hits, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	size_t i = batch::triangles<L>(0, rays, v0, v1, v2, hits, count);
+	batch::triangles<simd::lane<T> >(i, rays, v0, v1, v2, hits, count);
+}
+template <typename T> inline void intersectSphere(const tray<T>* rays, const tvec4<T>& sphere, T* distances, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	size_t i = batch::spheres<L>(0, rays, sphere, distances, count);
+	batch::spheres<simd::lane<T> >(i, rays, sphere, distances, count);
+}
+template <typename T> inline void intersectPlane(const tray<T>* rays, const tvec4<T>& plane, T* distances, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	size_t i = batch::planes<L>(0, rays, plane, distances, count);
+	batch::planes<simd::lane<T> >(i, rays, plane, distances, count);
+}
+template <typename T> inline void intersectBox(const tray<T>* rays, const tvec3<T>& min, const tvec3<T>& max, T* distances, const size_t count)
+{
+	typedef typename simd::widest<T>::type L;
+	size_t i = batch::boxes<L>(0, rays, min, max, distances, count);
+	batch::boxes<simd::lane<T> >(i, rays, min, max, distances, count);
+}
+
+template <typename T> inline void intersectTriangle(const tray<T>* rays, const tvec3<T>& v0, const tvec3<T>& v1, const tvec3<T>& v2, thit<T>* hits, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		intersectTriangle(rays + begin, v0, v1, v2, hits + begin, end - begin);
+	});
+}
+template <typename T> inline void intersectSphere(const tray<T>* rays, const tvec4<T>& sphere, T* distances, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		intersectSphere(rays + begin, sphere, distances + begin, end - begin);
+	});
+}
+template <typename T> inline void intersectPlane(const tray<T>* rays, const tvec4<T>& plane, T* distances, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		intersectPlane(rays + begin, plane, distances + begin, end - begin);
+	});
+}
+template <typename T> inline void intersectBox(const tray<T>* rays, const tvec3<T>& min, const tvec3<T>& max, T* distances, const size_t count, const unsigned int threads)
+{
+	parallel(count, threads, [&](const size_t begin, const size_t end)
+	{
+		intersectBox(rays + begin, min, max, distances + begin, end - begin);
+	});
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,641 @@
+// The float batch kernels, written once for every instruction set. batch.hpp includes this file
+// inside gmath::native for the instruction set the translation unit is built for, and dispatch.hpp
+// includes it again inside each level's namespace with the compiler targeting that level, so there
+// is no include guard. GMATH_KERNEL_SSE41, GMATH_KERNEL_AVX and GMATH_KERNEL_AVX512 are cumulative
+// and GMATH_KERNEL_FMA turns the multiply adds into fused ones; with none of them defined the
+// kernels are plain C++.
+
+#if defined(GMATH_KERNEL_SSE41)
+inline __m128 madd(const __m128 a, const __m128 b, const __m128 c)
+{
+#if defined(GMATH_KERNEL_FMA)
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+inline __m128 column(const tmat4x4<float>& m, const int index)
+{
+	return _mm_loadu_ps((const float*)&m._columns[index]);
+}
+// x and y go through a 64-bit integer load, which may alias and need not be aligned
+inline __m128 load3(const tvec3<float>& v)
+{
+	return _mm_movelh_ps(_mm_castsi128_ps(_mm_loadl_epi64((const __m128i*)&v)), _mm_load_ss(&v.z));
+}
+inline void store3(tvec3<float>& v, const __m128 x)
+{
+	_mm_storel_epi64((__m128i*)&v, _mm_castps_si128(x));
+	_mm_store_ss(&v.z, _mm_movehl_ps(x, x));
+}
+
+inline __m128 add(const __m128 a, const __m128 b) { return _mm_add_ps(a, b); }
+inline __m128 sub(const __m128 a, const __m128 b) { return _mm_sub_ps(a, b); }
+inline __m128 mul(const __m128 a, const __m128 b) { return _mm_mul_ps(a, b); }
+inline __m128 div(const __m128 a, const __m128 b) { return _mm_div_ps(a, b); }
+inline __m128 magnitude(const __m128 a) { return _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF))); }
+inline __m128 lessEqual(const __m128 a, const __m128 b) { return _mm_cmple_ps(a, b); }
+inline __m128 select(const __m128 m, const __m128 a, const __m128 b) { return _mm_blendv_ps(b, a, m); }
+inline int bits(const __m128 m) { return _mm_movemask_ps(m); }
+inline void fill(__m128& x, const float v) { x = _mm_set1_ps(v); }
+
+// e[(column * 4) + row] holds that element of four consecutive matrices, one matrix per lane
+inline void gather(const tmat4x4<float>* m, __m128* e)
+{
+	for (int c = 0; c < 4; c++)
+	{
+		__m128 r0 = column(m[0], c);
+		__m128 r1 = column(m[1], c);
+		__m128 r2 = column(m[2], c);
+		__m128 r3 = column(m[3], c);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		e[(c * 4) + 0] = r0;
+		e[(c * 4) + 1] = r1;
+		e[(c * 4) + 2] = r2;
+		e[(c * 4) + 3] = r3;
+	}
+}
+inline void scatter(const __m128* e, tmat4x4<float>* m)
+{
+	for (int c = 0; c < 4; c++)
+	{
+		__m128 r0 = e[(c * 4) + 0];
+		__m128 r1 = e[(c * 4) + 1];
+		__m128 r2 = e[(c * 4) + 2];
+		__m128 r3 = e[(c * 4) + 3];
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_storeu_ps((float*)&m[0]._columns[c], r0);
+		_mm_storeu_ps((float*)&m[1]._columns[c], r1);
+		_mm_storeu_ps((float*)&m[2]._columns[c], r2);
+		_mm_storeu_ps((float*)&m[3]._columns[c], r3);
+	}
+}
+#endif
+
+#if defined(GMATH_KERNEL_AVX)
+inline __m256 madd(const __m256 a, const __m256 b, const __m256 c)
+{
+#if defined(GMATH_KERNEL_FMA)
+	return _mm256_fmadd_ps(a, b, c);
+#else
+	return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+inline __m256 broadcast(const tvec4<float>& v)
+{
+	return _mm256_broadcast_ps((const __m128*)&v);
+}
+inline __m256 load3x2(const tvec3<float>* v)
+{
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(load3(v[0])), load3(v[1]), 1);
+}
+inline void store3x2(tvec3<float>* v, const __m256 x)
+{
+	store3(v[0], _mm256_castps256_ps128(x));
+	store3(v[1], _mm256_extractf128_ps(x, 1));
+}
+
+inline __m256 add(const __m256 a, const __m256 b) { return _mm256_add_ps(a, b); }
+inline __m256 sub(const __m256 a, const __m256 b) { return _mm256_sub_ps(a, b); }
+inline __m256 mul(const __m256 a, const __m256 b) { return _mm256_mul_ps(a, b); }
+inline __m256 div(const __m256 a, const __m256 b) { return _mm256_div_ps(a, b); }
+inline __m256 magnitude(const __m256 a) { return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF))); }
+inline __m256 lessEqual(const __m256 a, const __m256 b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+inline __m256 select(const __m256 m, const __m256 a, const __m256 b) { return _mm256_blendv_ps(b, a, m); }
+inline int bits(const __m256 m) { return _mm256_movemask_ps(m); }
+inline void fill(__m256& x, const float v) { x = _mm256_set1_ps(v); }
+
+inline void transpose(__m256& r0, __m256& r1, __m256& r2, __m256& r3)
+{
+	__m256 t0 = _mm256_unpacklo_ps(r0, r1);
+	__m256 t1 = _mm256_unpacklo_ps(r2, r3);
+	__m256 t2 = _mm256_unpackhi_ps(r0, r1);
+	__m256 t3 = _mm256_unpackhi_ps(r2, r3);
+	r0 = _mm256_shuffle_ps(t0, t1, 0x44);
+	r1 = _mm256_shuffle_ps(t0, t1, 0xEE);
+	r2 = _mm256_shuffle_ps(t2, t3, 0x44);
+	r3 = _mm256_shuffle_ps(t2, t3, 0xEE);
+}
+// column c of m[0] and m[4], one per half
+inline __m256 column2(const tmat4x4<float>* m, const int c)
+{
+	return _mm256_insertf128_ps(_mm256_castps128_ps256(column(m[0], c)), column(m[4], c), 1);
+}
+inline void gather(const tmat4x4<float>* m, __m256* e)
+{
+	for (int c = 0; c < 4; c++)
+	{
+		__m256 r0 = column2(m, c);
+		__m256 r1 = column2(m + 1, c);
+		__m256 r2 = column2(m + 2, c);
+		__m256 r3 = column2(m + 3, c);
+		transpose(r0, r1, r2, r3);
+		e[(c * 4) + 0] = r0;
+		e[(c * 4) + 1] = r1;
+		e[(c * 4) + 2] = r2;
+		e[(c * 4) + 3] = r3;
+	}
+}
+inline void scatter(const __m256* e, tmat4x4<float>* m)
+{
+	for (int c = 0; c < 4; c++)
+	{
+		__m256 r0 = e[(c * 4) + 0];
+		__m256 r1 = e[(c * 4) + 1];
+		__m256 r2 = e[(c * 4) + 2];
+		__m256 r3 = e[(c * 4) + 3];
+		transpose(r0, r1, r2, r3);
+		_mm_storeu_ps((float*)&m[0]._columns[c], _mm256_castps256_ps128(r0));
+		_mm_storeu_ps((float*)&m[1]._columns[c], _mm256_castps256_ps128(r1));
+		_mm_storeu_ps((float*)&m[2]._columns[c], _mm256_castps256_ps128(r2));
+		_mm_storeu_ps((float*)&m[3]._columns[c], _mm256_castps256_ps128(r3));
+		_mm_storeu_ps((float*)&m[4]._columns[c], _mm256_extractf128_ps(r0, 1));
+		_mm_storeu_ps((float*)&m[5]._columns[c], _mm256_extractf128_ps(r1, 1));
+		_mm_storeu_ps((float*)&m[6]._columns[c], _mm256_extractf128_ps(r2, 1));
+		_mm_storeu_ps((float*)&m[7]._columns[c], _mm256_extractf128_ps(r3, 1));
+	}
+}
+#endif
+
+#if defined(GMATH_KERNEL_AVX512)
+// AVX-512 intrinsics with an all ones zero mask where the plain form exists too: GCC implements the
+// plain forms with an undefined pass through register and -Wall then warns about it.
+
+// Sixteen tvec3 are three registers of interleaved xyz, two permutes pull each component out.
+inline void load3x16(const tvec3<float>* v, __m512& x, __m512& y, __m512& z)
+{
+	const float* p = (const float*)v;
+	__m512 a = _mm512_loadu_ps(p);
+	__m512 b = _mm512_loadu_ps(p + 16);
+	__m512 c = _mm512_loadu_ps(p + 32);
+	x = _mm512_permutex2var_ps(a, _mm512_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21, 24, 27, 30, 1, 4, 7, 10, 13), b);
+	y = _mm512_permutex2var_ps(a, _mm512_setr_epi32(1, 4, 7, 10, 13, 16, 19, 22, 25, 28, 31, 2, 5, 8, 11, 14), b);
+	z = _mm512_permutex2var_ps(a, _mm512_setr_epi32(2, 5, 8, 11, 14, 17, 20, 23, 26, 29, 0, 3, 6, 9, 12, 15), b);
+	x = _mm512_permutex2var_ps(x, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 17, 20, 23, 26, 29), c);
+	y = _mm512_permutex2var_ps(y, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 18, 21, 24, 27, 30), c);
+	z = _mm512_permutex2var_ps(z, _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 16, 19, 22, 25, 28, 31), c);
+}
+inline void store3x16(tvec3<float>* v, const __m512 x, const __m512 y, const __m512 z)
+{
+	float* p = (float*)v;
+	__m512 a = _mm512_permutex2var_ps(x, _mm512_setr_epi32(0, 16, 0, 1, 17, 1, 2, 18, 2, 3, 19, 3, 4, 20, 4, 5), y);
+	__m512 b = _mm512_permutex2var_ps(x, _mm512_setr_epi32(21, 5, 6, 22, 6, 7, 23, 7, 8, 24, 8, 9, 25, 9, 10, 26), y);
+	__m512 c = _mm512_permutex2var_ps(x, _mm512_setr_epi32(10, 11, 27, 11, 12, 28, 12, 13, 29, 13, 14, 30, 14, 15, 31, 15), y);
+	_mm512_storeu_ps(p, _mm512_permutex2var_ps(a, _mm512_setr_epi32(0, 1, 16, 3, 4, 17, 6, 7, 18, 9, 10, 19, 12, 13, 20, 15), z));
+	_mm512_storeu_ps(p + 16, _mm512_permutex2var_ps(b, _mm512_setr_epi32(0, 21, 2, 3, 22, 5, 6, 23, 8, 9, 24, 11, 12, 25, 14, 15), z));
+	_mm512_storeu_ps(p + 32, _mm512_permutex2var_ps(c, _mm512_setr_epi32(26, 1, 2, 27, 4, 5, 28, 7, 8, 29, 10, 11, 30, 13, 14, 31), z));
+}
+
+inline __m512 add(const __m512 a, const __m512 b) { return _mm512_add_ps(a, b); }
+inline __m512 sub(const __m512 a, const __m512 b) { return _mm512_sub_ps(a, b); }
+inline __m512 mul(const __m512 a, const __m512 b) { return _mm512_mul_ps(a, b); }
+inline __m512 div(const __m512 a, const __m512 b) { return _mm512_div_ps(a, b); }
+inline __m512 magnitude(const __m512 a) { return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(0x7FFFFFFF))); }
+inline __mmask16 lessEqual(const __m512 a, const __m512 b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+inline __m512 select(const __mmask16 m, const __m512 a, const __m512 b) { return _mm512_mask_blend_ps(m, b, a); }
+inline int bits(const __mmask16 m) { return m; }
+inline void fill(__m512& x, const float v) { x = _mm512_set1_ps(v); }
+
+// Two eight wide gathers, the second eight matrices go to the upper half.
+inline void gather(const tmat4x4<float>* m, __m512* e)
+{
+	__m256 lo[16];
+	__m256 hi[16];
+	gather(m, lo);
+	gather(m + 8, hi);
+	for (int k = 0; k < 16; k++)
+	{
+		e[k] = _mm512_castpd_ps(_mm512_maskz_insertf64x4(0xFF, _mm512_castpd256_pd512(_mm256_castps_pd(lo[k])), _mm256_castps_pd(hi[k]), 1));
+	}
+}
+inline void scatter(const __m512* e, tmat4x4<float>* m)
+{
+	__m256 lo[16];
+	__m256 hi[16];
+	for (int k = 0; k < 16; k++)
+	{
+		lo[k] = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(e[k]), 0));
+		hi[k] = _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, _mm512_castps_pd(e[k]), 1));
+	}
+	scatter(lo, m);
+	scatter(hi, m + 8);
+}
+#endif
+
+#if defined(GMATH_KERNEL_SSE41)
+// Inverts one matrix per lane with cofactors, the same arithmetic on 4, 8 and 16 wide registers.
+// Matrices whose determinant magnitude is at or below threshold come back as identity.
+template <typename V, typename T> inline int inverseLanes(const tmat4x4<T>* in, tmat4x4<T>* out, const V threshold)
+{
+	V zero;
+	V one;
+	fill(zero, (T)0);
+	fill(one, (T)1);
+
+	V a[16];
+	gather(in, a);
+
+	V s0 = sub(mul(a[0], a[5]), mul(a[4], a[1]));
+	V s1 = sub(mul(a[0], a[6]), mul(a[4], a[2]));
+	V s2 = sub(mul(a[0], a[7]), mul(a[4], a[3]));
+	V s3 = sub(mul(a[1], a[6]), mul(a[5], a[2]));
+	V s4 = sub(mul(a[1], a[7]), mul(a[5], a[3]));
+	V s5 = sub(mul(a[2], a[7]), mul(a[6], a[3]));
+	V c5 = sub(mul(a[10], a[15]), mul(a[14], a[11]));
+	V c4 = sub(mul(a[9], a[15]), mul(a[13], a[11]));
+	V c3 = sub(mul(a[9], a[14]), mul(a[13], a[10]));
+	V c2 = sub(mul(a[8], a[15]), mul(a[12], a[11]));
+	V c1 = sub(mul(a[8], a[14]), mul(a[12], a[10]));
+	V c0 = sub(mul(a[8], a[13]), mul(a[12], a[9]));
+
+	V determinant = add(sub(add(sub(mul(s0, c5), mul(s1, c4)), add(mul(s2, c3), mul(s3, c2))), mul(s4, c1)), mul(s5, c0));
+	const decltype(lessEqual(determinant, threshold)) degenerate = lessEqual(magnitude(determinant), threshold);
+	V r = div(one, select(degenerate, one, determinant));
+
+	V b[16];
+	b[0] = select(degenerate, one, mul(add(sub(mul(a[5], c5), mul(a[6], c4)), mul(a[7], c3)), r));
+	b[1] = select(degenerate, zero, mul(sub(sub(mul(a[2], c4), mul(a[1], c5)), mul(a[3], c3)), r));
+	b[2] = select(degenerate, zero, mul(add(sub(mul(a[13], s5), mul(a[14], s4)), mul(a[15], s3)), r));
+	b[3] = select(degenerate, zero, mul(sub(sub(mul(a[10], s4), mul(a[9], s5)), mul(a[11], s3)), r));
+	b[4] = select(degenerate, zero, mul(sub(sub(mul(a[6], c2), mul(a[4], c5)), mul(a[7], c1)), r));
+	b[5] = select(degenerate, one, mul(add(sub(mul(a[0], c5), mul(a[2], c2)), mul(a[3], c1)), r));
+	b[6] = select(degenerate, zero, mul(sub(sub(mul(a[14], s2), mul(a[12], s5)), mul(a[15], s1)), r));
+	b[7] = select(degenerate, zero, mul(add(sub(mul(a[8], s5), mul(a[10], s2)), mul(a[11], s1)), r));
+	b[8] = select(degenerate, zero, mul(add(sub(mul(a[4], c4), mul(a[5], c2)), mul(a[7], c0)), r));
+	b[9] = select(degenerate, zero, mul(sub(sub(mul(a[1], c2), mul(a[0], c4)), mul(a[3], c0)), r));
+	b[10] = select(degenerate, one, mul(add(sub(mul(a[12], s4), mul(a[13], s2)), mul(a[15], s0)), r));
+	b[11] = select(degenerate, zero, mul(sub(sub(mul(a[9], s2), mul(a[8], s4)), mul(a[11], s0)), r));
+	b[12] = select(degenerate, zero, mul(sub(sub(mul(a[5], c1), mul(a[4], c3)), mul(a[6], c0)), r));
+	b[13] = select(degenerate, zero, mul(add(sub(mul(a[0], c3), mul(a[1], c1)), mul(a[2], c0)), r));
+	b[14] = select(degenerate, zero, mul(sub(sub(mul(a[13], s1), mul(a[12], s3)), mul(a[14], s0)), r));
+	b[15] = select(degenerate, one, mul(add(sub(mul(a[8], s3), mul(a[9], s1)), mul(a[10], s0)), r));
+	scatter(b, out);
+
+	return bits(degenerate);
+}
+#endif
+
+inline void transformPoints(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_KERNEL_AVX512)
+	const __m512 e[12] =
+	{
+		_mm512_set1_ps(m._columns[0].x), _mm512_set1_ps(m._columns[0].y), _mm512_set1_ps(m._columns[0].z),
+		_mm512_set1_ps(m._columns[1].x), _mm512_set1_ps(m._columns[1].y), _mm512_set1_ps(m._columns[1].z),
+		_mm512_set1_ps(m._columns[2].x), _mm512_set1_ps(m._columns[2].y), _mm512_set1_ps(m._columns[2].z),
+		_mm512_set1_ps(m._columns[3].x), _mm512_set1_ps(m._columns[3].y), _mm512_set1_ps(m._columns[3].z)
+	};
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 x, y, z;
+		load3x16(in + i, x, y, z);
+		__m512 rx = _mm512_fmadd_ps(e[6], z, _mm512_fmadd_ps(e[3], y, _mm512_fmadd_ps(e[0], x, e[9])));
+		__m512 ry = _mm512_fmadd_ps(e[7], z, _mm512_fmadd_ps(e[4], y, _mm512_fmadd_ps(e[1], x, e[10])));
+		__m512 rz = _mm512_fmadd_ps(e[8], z, _mm512_fmadd_ps(e[5], y, _mm512_fmadd_ps(e[2], x, e[11])));
+		store3x16(out + i, rx, ry, rz);
+	}
+#endif
+#if defined(GMATH_KERNEL_AVX)
+	const __m256 w0 = broadcast(m._columns[0]);
+	const __m256 w1 = broadcast(m._columns[1]);
+	const __m256 w2 = broadcast(m._columns[2]);
+	const __m256 w3 = broadcast(m._columns[3]);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m256 v = load3x2(in + i);
+		__m256 r = madd(w0, _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)), w3);
+		r = madd(w1, _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = madd(w2, _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		store3x2(out + i, r);
+	}
+#endif
+#if defined(GMATH_KERNEL_SSE41)
+	const __m128 c0 = column(m, 0);
+	const __m128 c1 = column(m, 1);
+	const __m128 c2 = column(m, 2);
+	const __m128 c3 = column(m, 3);
+	for (; i < count; i++)
+	{
+		__m128 v = load3(in[i]);
+		__m128 r = madd(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), c3);
+		r = madd(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = madd(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		store3(out[i], r);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		const tvec3<float> v = in[i];
+		out[i] = tvec3<float>(
+			(m._columns[0].x * v.x) + (m._columns[1].x * v.y) + (m._columns[2].x * v.z) + m._columns[3].x,
+			(m._columns[0].y * v.x) + (m._columns[1].y * v.y) + (m._columns[2].y * v.z) + m._columns[3].y,
+			(m._columns[0].z * v.x) + (m._columns[1].z * v.y) + (m._columns[2].z * v.z) + m._columns[3].z
+			);
+	}
+}
+inline void transformVectors(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_KERNEL_AVX512)
+	const __m512 e[9] =
+	{
+		_mm512_set1_ps(m._columns[0].x), _mm512_set1_ps(m._columns[0].y), _mm512_set1_ps(m._columns[0].z),
+		_mm512_set1_ps(m._columns[1].x), _mm512_set1_ps(m._columns[1].y), _mm512_set1_ps(m._columns[1].z),
+		_mm512_set1_ps(m._columns[2].x), _mm512_set1_ps(m._columns[2].y), _mm512_set1_ps(m._columns[2].z)
+	};
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 x, y, z;
+		load3x16(in + i, x, y, z);
+		__m512 rx = _mm512_fmadd_ps(e[6], z, _mm512_fmadd_ps(e[3], y, _mm512_mul_ps(e[0], x)));
+		__m512 ry = _mm512_fmadd_ps(e[7], z, _mm512_fmadd_ps(e[4], y, _mm512_mul_ps(e[1], x)));
+		__m512 rz = _mm512_fmadd_ps(e[8], z, _mm512_fmadd_ps(e[5], y, _mm512_mul_ps(e[2], x)));
+		store3x16(out + i, rx, ry, rz);
+	}
+#endif
+#if defined(GMATH_KERNEL_AVX)
+	const __m256 w0 = broadcast(m._columns[0]);
+	const __m256 w1 = broadcast(m._columns[1]);
+	const __m256 w2 = broadcast(m._columns[2]);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m256 v = load3x2(in + i);
+		__m256 r = _mm256_mul_ps(w0, _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = madd(w1, _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = madd(w2, _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		store3x2(out + i, r);
+	}
+#endif
+#if defined(GMATH_KERNEL_SSE41)
+	const __m128 c0 = column(m, 0);
+	const __m128 c1 = column(m, 1);
+	const __m128 c2 = column(m, 2);
+	for (; i < count; i++)
+	{
+		__m128 v = load3(in[i]);
+		__m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = madd(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = madd(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		store3(out[i], r);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		const tvec3<float> v = in[i];
+		out[i] = tvec3<float>(
+			(m._columns[0].x * v.x) + (m._columns[1].x * v.y) + (m._columns[2].x * v.z),
+			(m._columns[0].y * v.x) + (m._columns[1].y * v.y) + (m._columns[2].y * v.z),
+			(m._columns[0].z * v.x) + (m._columns[1].z * v.y) + (m._columns[2].z * v.z)
+			);
+	}
+}
+
+inline void transformProjected(const tmat4x4<float>& m, const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_KERNEL_AVX)
+	const __m256 w0 = broadcast(m._columns[0]);
+	const __m256 w1 = broadcast(m._columns[1]);
+	const __m256 w2 = broadcast(m._columns[2]);
+	const __m256 w3 = broadcast(m._columns[3]);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m256 v = load3x2(in + i);
+		__m256 r = madd(w0, _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)), w3);
+		r = madd(w1, _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = madd(w2, _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		store3x2(out + i, _mm256_div_ps(r, _mm256_permute_ps(r, _MM_SHUFFLE(3, 3, 3, 3))));
+	}
+#endif
+#if defined(GMATH_KERNEL_SSE41)
+	const __m128 c0 = column(m, 0);
+	const __m128 c1 = column(m, 1);
+	const __m128 c2 = column(m, 2);
+	const __m128 c3 = column(m, 3);
+	for (; i < count; i++)
+	{
+		__m128 v = load3(in[i]);
+		__m128 r = madd(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), c3);
+		r = madd(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = madd(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		store3(out[i], _mm_div_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3))));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		const tvec3<float> v = in[i];
+		const float w = (m._columns[0].w * v.x) + (m._columns[1].w * v.y) + (m._columns[2].w * v.z) + m._columns[3].w;
+		out[i] = tvec3<float>(
+			((m._columns[0].x * v.x) + (m._columns[1].x * v.y) + (m._columns[2].x * v.z) + m._columns[3].x) / w,
+			((m._columns[0].y * v.x) + (m._columns[1].y * v.y) + (m._columns[2].y * v.z) + m._columns[3].y) / w,
+			((m._columns[0].z * v.x) + (m._columns[1].z * v.y) + (m._columns[2].z * v.z) + m._columns[3].z) / w
+			);
+	}
+}
+inline void transform4(const tmat4x4<float>& m, const tvec4<float>* in, tvec4<float>* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_KERNEL_AVX)
+	const __m256 w0 = broadcast(m._columns[0]);
+	const __m256 w1 = broadcast(m._columns[1]);
+	const __m256 w2 = broadcast(m._columns[2]);
+	const __m256 w3 = broadcast(m._columns[3]);
+	for (; i + 2 <= count; i += 2)
+	{
+		__m256 v = _mm256_loadu_ps((const float*)(in + i));
+		__m256 r = _mm256_mul_ps(w0, _mm256_permute_ps(v, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = madd(w1, _mm256_permute_ps(v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = madd(w2, _mm256_permute_ps(v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		r = madd(w3, _mm256_permute_ps(v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+		_mm256_storeu_ps((float*)(out + i), r);
+	}
+#endif
+#if defined(GMATH_KERNEL_SSE41)
+	const __m128 c0 = column(m, 0);
+	const __m128 c1 = column(m, 1);
+	const __m128 c2 = column(m, 2);
+	const __m128 c3 = column(m, 3);
+	for (; i < count; i++)
+	{
+		__m128 v = _mm_loadu_ps((const float*)(in + i));
+		__m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = madd(c1, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = madd(c2, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		r = madd(c3, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+		_mm_storeu_ps((float*)(out + i), r);
+	}
+#endif
+	for (; i < count; i++)
+	{
+		const tvec4<float> v = in[i];
+		out[i] = tvec4<float>(
+			(m._columns[0].x * v.x) + (m._columns[1].x * v.y) + (m._columns[2].x * v.z) + (m._columns[3].x * v.w),
+			(m._columns[0].y * v.x) + (m._columns[1].y * v.y) + (m._columns[2].y * v.z) + (m._columns[3].y * v.w),
+			(m._columns[0].z * v.x) + (m._columns[1].z * v.y) + (m._columns[2].z * v.z) + (m._columns[3].z * v.w),
+			(m._columns[0].w * v.x) + (m._columns[1].w * v.y) + (m._columns[2].w * v.z) + (m._columns[3].w * v.w)
+			);
+	}
+}
+
+// Zero length vectors come back as zero, as with gmath::normalize.
+inline void normalize(const tvec3<float>* in, tvec3<float>* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_KERNEL_AVX512)
+	for (; i + 16 <= count; i += 16)
+	{
+		__m512 x, y, z;
+		load3x16(in + i, x, y, z);
+		__m512 m = _mm512_maskz_sqrt_ps(0xFFFF, _mm512_fmadd_ps(z, z, _mm512_fmadd_ps(y, y, _mm512_mul_ps(x, x))));
+		__mmask16 valid = _mm512_cmp_ps_mask(m, _mm512_setzero_ps(), _CMP_NEQ_UQ);
+		store3x16(out + i, _mm512_maskz_div_ps(valid, x, m), _mm512_maskz_div_ps(valid, y, m), _mm512_maskz_div_ps(valid, z, m));
+	}
+#endif
+#if defined(GMATH_KERNEL_AVX)
+	for (; i + 2 <= count; i += 2)
+	{
+		__m256 v = load3x2(in + i);
+		__m256 m = _mm256_sqrt_ps(_mm256_dp_ps(v, v, 0x7F));
+		__m256 zero = _mm256_cmp_ps(m, _mm256_setzero_ps(), _CMP_EQ_OQ);
+		store3x2(out + i, _mm256_andnot_ps(zero, _mm256_div_ps(v, m)));
+	}
+#endif
+#if defined(GMATH_KERNEL_SSE41)
+	for (; i < count; i++)
+	{
+		__m128 v = load3(in[i]);
+		__m128 m = _mm_sqrt_ps(_mm_dp_ps(v, v, 0x7F));
+		__m128 zero = _mm_cmpeq_ps(m, _mm_setzero_ps());
+		store3(out[i], _mm_andnot_ps(zero, _mm_div_ps(v, m)));
+	}
+#endif
+	for (; i < count; i++)
+	{
+		const tvec3<float> v = in[i];
+		float m = (float)::sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z));
+		out[i] = m == 0.0f ? tvec3<float>() : tvec3<float>(v.x / m, v.y / m, v.z / m);
+	}
+}
+
+inline void multiplyBatch(const tmat4x4<float>* m0, const tmat4x4<float>* m1, tmat4x4<float>* out, const size_t count)
+{
+	size_t i = 0;
+#if defined(GMATH_KERNEL_AVX512)
+	for (; i < count; i++)
+	{
+		__m512 c0 = _mm512_maskz_broadcast_f32x4(0xFFFF, column(m0[i], 0));
+		__m512 c1 = _mm512_maskz_broadcast_f32x4(0xFFFF, column(m0[i], 1));
+		__m512 c2 = _mm512_maskz_broadcast_f32x4(0xFFFF, column(m0[i], 2));
+		__m512 c3 = _mm512_maskz_broadcast_f32x4(0xFFFF, column(m0[i], 3));
+		__m512 x = _mm512_loadu_ps((const float*)(m1 + i));
+		__m512 r = _mm512_mul_ps(c0, _mm512_maskz_permute_ps(0xFFFF, x, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm512_fmadd_ps(c1, _mm512_maskz_permute_ps(0xFFFF, x, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = _mm512_fmadd_ps(c2, _mm512_maskz_permute_ps(0xFFFF, x, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		r = _mm512_fmadd_ps(c3, _mm512_maskz_permute_ps(0xFFFF, x, _MM_SHUFFLE(3, 3, 3, 3)), r);
+		_mm512_storeu_ps((float*)(out + i), r);
+	}
+#elif defined(GMATH_KERNEL_AVX)
+	for (; i < count; i++)
+	{
+		__m256 c0 = broadcast(m0[i]._columns[0]);
+		__m256 c1 = broadcast(m0[i]._columns[1]);
+		__m256 c2 = broadcast(m0[i]._columns[2]);
+		__m256 c3 = broadcast(m0[i]._columns[3]);
+		for (int k = 0; k < 4; k += 2)
+		{
+			__m256 x = _mm256_loadu_ps((const float*)&m1[i]._columns[k]);
+			__m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(x, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = madd(c1, _mm256_permute_ps(x, _MM_SHUFFLE(1, 1, 1, 1)), r);
+			r = madd(c2, _mm256_permute_ps(x, _MM_SHUFFLE(2, 2, 2, 2)), r);
+			r = madd(c3, _mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3)), r);
+			_mm256_storeu_ps((float*)&out[i]._columns[k], r);
+		}
+	}
+#elif defined(GMATH_KERNEL_SSE41)
+	for (; i < count; i++)
+	{
+		__m128 c0 = column(m0[i], 0);
+		__m128 c1 = column(m0[i], 1);
+		__m128 c2 = column(m0[i], 2);
+		__m128 c3 = column(m0[i], 3);
+		for (int k = 0; k < 4; k++)
+		{
+			__m128 x = column(m1[i], k);
+			__m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 0)));
+			r = madd(c1, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1)), r);
+			r = madd(c2, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 2, 2)), r);
+			r = madd(c3, _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3)), r);
+			_mm_storeu_ps((float*)&out[i]._columns[k], r);
+		}
+	}
+#endif
+	for (; i < count; i++)
+	{
+		const float* a = (const float*)(m0 + i);
+		const float* b = (const float*)(m1 + i);
+		float r[16];
+		for (int c = 0; c < 4; c++)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				r[(c * 4) + k] = (a[k] * b[c * 4]) + (a[4 + k] * b[(c * 4) + 1]) + (a[8 + k] * b[(c * 4) + 2]) + (a[12 + k] * b[(c * 4) + 3]);
+			}
+		}
+		memcpy(out + i, r, sizeof(r));
+	}
+}
+
+// Same contract as gmath::inverseBatch: matrices whose determinant magnitude is at or below
+// epsilon come back as identity and, when singular is not null, are flagged with 1.
+inline void inverseBatch(const tmat4x4<float>* in, tmat4x4<float>* out, unsigned char* singular, const size_t count, const float epsilon)
+{
+	size_t i = 0;
+#if defined(GMATH_KERNEL_AVX512)
+	__m512 threshold16;
+	fill(threshold16, epsilon);
+	for (; i + 16 <= count; i += 16)
+	{
+		int flags = inverseLanes(in + i, out + i, threshold16);
+		for (int k = 0; singular != 0 && k < 16; k++)
+		{
+			singular[i + k] = (unsigned char)((flags >> k) & 1);
+		}
+	}
+#endif
+#if defined(GMATH_KERNEL_AVX)
+	__m256 threshold8;
+	fill(threshold8, epsilon);
+	for (; i + 8 <= count; i += 8)
+	{
+		int flags = inverseLanes(in + i, out + i, threshold8);
+		for (int k = 0; singular != 0 && k < 8; k++)
+		{
+			singular[i + k] = (unsigned char)((flags >> k) & 1);
+		}
+	}
+#endif
+#if defined(GMATH_KERNEL_SSE41)
+	__m128 threshold4;
+	fill(threshold4, epsilon);
+	for (; i + 4 <= count; i += 4)
+	{
+		int flags = inverseLanes(in + i, out + i, threshold4);
+		for (int k = 0; singular != 0 && k < 4; k++)
+		{
+			singular[i + k] = (unsigned char)((flags >> k) & 1);
+		}
+	}
+#endif
+	for (; i < count; i++)
+	{
+		float determinant;
+		tmat4x4<float> m = gmath::inverse(in[i], determinant);
+		bool degenerate = (determinant < 0.0f ? -determinant : determinant) <= epsilon;
+		out[i] = degenerate ? tmat4x4<float>() : m;
+		if (singular != 0)
+		{
+			singular[i] = degenerate ? 1 : 0;
+		}
+	}
+}
\ No newline at end of file
@@ -134,11 +134,32 @@ public:
 		memset(this->_data, 0, this->_bytes);
 	}
 
+	const int width() const
+	{
+		return this->_width;
+	}
+	const int height() const
+	{
+		return this->_height;
+	}
+	const int depth() const
+	{
+		return this->_depth;
+	}
+	const int size() const
+	{
+		return this->_size;
+	}
+
 	void operator=(const Map<T>& m)
 	{
 		this->resize(m._width, m._height, m._depth);
 		memcpy(this->_data, m._data, this->_bytes);
 	}
+	operator T*() const
+	{
+		return this->_data;
+	}
 	T& operator[](const int index)
 	{
 		return this->_data[index % this->_size];
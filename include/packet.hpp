@@ -0,0 +1,160 @@
+#ifndef PACKET_H
+#define PACKET_H
+
+#include <float.h>
+
+#include <gmath.hpp>
+#include <batch.hpp>
+#include <intersect.hpp>
+
+namespace gmath
+{
+
+#if !(defined(traypacket) || defined(raypacket4) || defined(raypacket8))
+// L::width rays side by side, one register per component. The reciprocal direction and its signs are
+// cached so the slab test against every box of a traversal is a subtract and a multiply per plane.
+// Lanes hit only between tmin and tmax; tmax starts as the ray length and clip() shortens it.
+template <typename L> struct traypacket
+{
+
+	typedef typename L::type T;
+	enum { width = L::width };
+
+	inline traypacket() {}
+	inline traypacket(const tray<T>* rays)
+	{
+		this->set(rays);
+	}
+	// Primary rays through normalized device coordinates x and y in [-1, 1], from the near plane to the
+	// far one, for the inverse of a projection * view built with perspective() and look(). Directions
+	// come out unit length so distances are in world units.
+	inline traypacket(const tmat4x4<T>& inverseViewProjection, const L& x, const L& y)
+	{
+		const tmat4x4<T>& m = inverseViewProjection;
+		const L one((T)1);
+		L p0[4];
+		L p1[4];
+		for (int k = 0; k < 4; k++)
+		{
+			L c = madd(L(m._columns[1][k]), y, madd(L(m._columns[0][k]), x, L(m._columns[3][k])));
+			p0[k] = c - L(m._columns[2][k]);
+			p1[k] = c + L(m._columns[2][k]);
+		}
+
+		L w0 = one / p0[3];
+		L w1 = one / p1[3];
+		for (int k = 0; k < 3; k++)
+		{
+			this->origin[k] = p0[k] * w0;
+			this->direction[k] = (p1[k] * w1) - this->origin[k];
+		}
+
+		L length = sqrt(batch::dot3(this->direction, this->direction));
+		L inv = one / length;
+		for (int k = 0; k < 3; k++)
+		{
+			this->direction[k] = this->direction[k] * inv;
+		}
+
+		this->tmin = L((T)0);
+		this->tmax = length;
+		this->update();
+	}
+
+	inline void set(const tray<T>* rays)
+	{
+		L r[7];
+		simd::gather(rays, r);
+		for (int k = 0; k < 3; k++)
+		{
+			this->origin[k] = r[k];
+			this->direction[k] = r[3 + k];
+		}
+
+		this->tmin = L((T)0);
+		this->tmax = r[6];
+		this->update();
+	}
+	// Call after changing a direction. The signs come from the reciprocal so that -0 counts as negative.
+	inline void update()
+	{
+		const L zero((T)0);
+		const L one((T)1);
+		for (int k = 0; k < 3; k++)
+		{
+			this->inverse[k] = one / this->direction[k];
+			this->sign[k] = simd::bits(this->inverse[k] < zero);
+		}
+	}
+
+	// True when every lane points into the same octant, the usual case for a tile of primary rays.
+	inline bool coherent() const
+	{
+		const int all = (1 << L::width) - 1;
+		return (this->sign[0] == 0 || this->sign[0] == all) && (this->sign[1] == 0 || this->sign[1] == all) && (this->sign[2] == 0 || this->sign[2] == all);
+	}
+
+	// Lanes whose interval overlaps the box; t is where they enter it, or tmin when they start inside.
+	inline typename L::mask intersect(const tvec3<T>& min, const tvec3<T>& max, L& t) const
+	{
+		const int all = (1 << L::width) - 1;
+		const L zero((T)0);
+		L t0 = this->tmin;
+		L t1 = this->tmax;
+		for (int k = 0; k < 3; k++)
+		{
+			const L b0(((const T*)&min)[k]);
+			const L b1(((const T*)&max)[k]);
+			if (this->sign[k] == 0 || this->sign[k] == all)
+			{
+				// the whole packet meets the same plane first, so the front and back planes are picked once
+				const bool negative = this->sign[k] != 0;
+				batch::slab(this->origin[k], this->inverse[k], negative ? b1 : b0, negative ? b0 : b1, t0, t1);
+			}
+			else
+			{
+				typename L::mask negative = this->inverse[k] < zero;
+				batch::slab(this->origin[k], this->inverse[k], select(negative, b1, b0), select(negative, b0, b1), t0, t1);
+			}
+		}
+
+		t = t0;
+		return t0 <= t1;
+	}
+	// Lanes that hit the triangle between tmin and tmax, with the distance and barycentrics as in thit.
+	inline typename L::mask intersect(const tvec3<T>& v0, const tvec3<T>& v1, const tvec3<T>& v2, L& t, L& u, L& v) const
+	{
+		L r[7] = { this->origin[0], this->origin[1], this->origin[2], this->direction[0], this->direction[1], this->direction[2], this->tmax };
+		L p0[3] = { L(v0.x), L(v0.y), L(v0.z) };
+		L p1[3] = { L(v1.x), L(v1.y), L(v1.z) };
+		L p2[3] = { L(v2.x), L(v2.y), L(v2.z) };
+		typename L::mask m = batch::triangle(r, p0, p1, p2, t, u, v);
+		return m & (t >= this->tmin);
+	}
+
+	// Shortens the lanes in m to end at t, so later tests only report nearer hits.
+	inline void clip(const typename L::mask& m, const L& t)
+	{
+		this->tmax = select(m, t, this->tmax);
+	}
+
+	L origin[3];
+	L direction[3];
+	L inverse[3];
+	L tmin;
+	L tmax;
+	int sign[3];
+
+};
+
+#if defined(GMATH_SSE41)
+typedef traypacket<simd::f32x4> raypacket4;
+#endif
+#if defined(GMATH_AVX)
+typedef traypacket<simd::f32x8> raypacket8;
+#endif
+#endif
+
+}
+
+#endif
\ No newline at end of file
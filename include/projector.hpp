@@ -0,0 +1,160 @@
+#ifndef PROJECTOR_H
+#define PROJECTOR_H
+
+#include <gmath.hpp>
+#include <batch.hpp>
+#include <map.hpp>
+
+namespace gmath
+{
+
+#if !(defined(tprojector) || defined(projector))
+template <typename T> class tprojector
+{
+public:
+
+	tprojector() : _dirty(true) {}
+	tprojector(const tmat4x4<T>& model, const tmat4x4<T>& proj) : _model(model), _proj(proj), _dirty(true) {}
+	~tprojector() {}
+
+	void setModel(const tmat4x4<T>& model)
+	{
+		this->_model = model;
+		this->_dirty = true;
+	}
+	void setProjection(const tmat4x4<T>& proj)
+	{
+		this->_proj = proj;
+		this->_dirty = true;
+	}
+
+	const tmat4x4<T>& model() const
+	{
+		return this->_model;
+	}
+	const tmat4x4<T>& projection() const
+	{
+		return this->_proj;
+	}
+	const tmat4x4<T>& combined()
+	{
+		this->update();
+		return this->_combined;
+	}
+	const tmat4x4<T>& inverse()
+	{
+		this->update();
+		return this->_inverse;
+	}
+
+	tvec3<T> project(const tvec3<T>& v)
+	{
+		tvec3<T> r;
+		this->project(&v, &r, 1);
+		return r;
+	}
+	tvec3<T> unproject(const tvec3<T>& v)
+	{
+		tvec3<T> r;
+		this->unproject(&v, &r, 1);
+		return r;
+	}
+
+	void project(const tvec3<T>* in, tvec3<T>* out, const size_t count, const unsigned int threads = 1)
+	{
+		this->update();
+		transformProjected(this->_window, in, out, count, threads);
+	}
+	void unproject(const tvec3<T>* in, tvec3<T>* out, const size_t count, const unsigned int threads = 1)
+	{
+		this->update();
+		transformProjected(this->_unwindow, in, out, count, threads);
+	}
+	void project(const tvec3<T>* in, Map<tvec3<T> >& out, const unsigned int threads = 1)
+	{
+		this->project(in, (tvec3<T>*)out, out.size(), threads);
+	}
+	void unproject(const tvec3<T>* in, Map<tvec3<T> >& out, const unsigned int threads = 1)
+	{
+		this->unproject(in, (tvec3<T>*)out, out.size(), threads);
+	}
+	void unproject(Map<T>& depth, Map<tvec3<T> >& out, const unsigned int threads = 1)
+	{
+		this->update();
+		const int width = depth.width();
+		const int height = depth.height();
+		if (out.width() != width || out.height() != height)
+		{
+			out.resize(width, height);
+		}
+
+		const T* d = (T*)depth;
+		tvec3<T>* o = (tvec3<T>*)out;
+		const tvec4<T> c0 = this->_unwindow._columns[0] / (T)width;
+		const tvec4<T> c1 = this->_unwindow._columns[1] / (T)height;
+		const tvec4<T> c2 = this->_unwindow._columns[2];
+		const tvec4<T> c3 = this->_unwindow._columns[3] + ((c0 + c1) * (T)0.5);
+		parallel((size_t)height, threads, [&](const size_t begin, const size_t end)
+		{
+			for (size_t y = begin; y < end; y++)
+			{
+				const tvec4<T> row = (c1 * (T)y) + c3;
+				const T* line = d + (y * width);
+				tvec3<T>* target = o + (y * width);
+				for (int x = 0; x < width; x++)
+				{
+					const T z = line[x];
+					const T w = (c0.w * (T)x) + (c2.w * z) + row.w;
+					target[x].x = ((c0.x * (T)x) + (c2.x * z) + row.x) / w;
+					target[x].y = ((c0.y * (T)x) + (c2.y * z) + row.y) / w;
+					target[x].z = ((c0.z * (T)x) + (c2.z * z) + row.z) / w;
+				}
+			}
+		});
+	}
+
+private:
+
+	void update()
+	{
+		if (!this->_dirty)
+		{
+			return;
+		}
+
+		static const tmat4x4<T> remap(
+			(T)0.5, (T)0, (T)0, (T)0.5,
+			(T)0, (T)0.5, (T)0, (T)0.5,
+			(T)0, (T)0, (T)0.5, (T)0.5,
+			(T)0, (T)0, (T)0, (T)1
+			);
+		static const tmat4x4<T> unmap(
+			(T)2, (T)0, (T)0, (T)-1,
+			(T)0, (T)2, (T)0, (T)-1,
+			(T)0, (T)0, (T)2, (T)-1,
+			(T)0, (T)0, (T)0, (T)1
+			);
+
+		this->_combined = this->_proj * this->_model;
+		this->_inverse = gmath::inverse(this->_combined);
+		this->_window = remap * this->_combined;
+		this->_unwindow = this->_inverse * unmap;
+		this->_dirty = false;
+	}
+
+	tmat4x4<T> _model;
+	tmat4x4<T> _proj;
+	tmat4x4<T> _combined;
+	tmat4x4<T> _inverse;
+	tmat4x4<T> _window;
+	tmat4x4<T> _unwindow;
+	bool _dirty;
+
+};
+
+typedef tprojector<float> projector;
+#endif
+
+}
+
+#endif
\ No newline at end of file
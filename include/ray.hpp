@@ -1,6 +1,8 @@
 #ifndef RAY_H
 #define RAY_H
 
+#include <float.h>
+
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
 
@@ -18,6 +20,7 @@ template <typename T> struct tray
 	{
 		this->origin = r.origin;
 		this->direction = r.direction;
+		this->length = r.length;
 	}
 	inline void operator+=(const tray<T>& r)
 	{
@@ -57,11 +60,11 @@ template <typename T> struct tray
 	}
 	inline bool operator==(const tray<T>& r)
 	{
-		return this->origin == r.origin && this->direction == r.direction;
+		return this->origin == r.origin && this->direction == r.direction && this->length == r.length;
 	}
 	inline bool operator!=(const tray<T>& r)
 	{
-		return this->origin != r.origin && this->direction != r.direction;
+		return this->origin != r.origin || this->direction != r.direction || this->length != r.length;
 	}
 
 	glm::tvec3<T> origin;
@@ -0,0 +1,1038 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <gmath.hpp>
+
+#if !defined(GMATH_NO_SIMD)
+#if defined(__AVX512F__)
+#define GMATH_AVX512
+#endif
+#if defined(__AVX2__)
+#define GMATH_AVX2
+#endif
+#if defined(__FMA__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define GMATH_FMA
+#endif
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#define GMATH_F16C
+#endif
+#if defined(__AVX__)
+#define GMATH_AVX
+#endif
+#if defined(__SSE4_1__) || defined(__AVX__)
+#define GMATH_SSE41
+#endif
+#endif
+
+#if defined(GMATH_AVX)
+#include <immintrin.h>
+#elif defined(GMATH_SSE41)
+#include <smmintrin.h>
+#endif
+
+namespace gmath
+{
+
+namespace simd
+{
+
+template <typename T> struct lane
+{
+
+	typedef T type;
+	typedef bool mask;
+	enum { width = 1 };
+
+	inline lane() : value((T)0) {}
+	inline lane(const T x) : value(x) {}
+
+	static inline lane<T> load(const T* p)
+	{
+		return lane<T>(*p);
+	}
+	static inline bool expand(const int bits)
+	{
+		return (bits & 1) != 0;
+	}
+	inline void store(T* p) const
+	{
+		*p = this->value;
+	}
+
+	T value;
+
+};
+
+template <typename T> inline lane<T> operator+(const lane<T>& a, const lane<T>& b) { return lane<T>(a.value + b.value); }
+template <typename T> inline lane<T> operator-(const lane<T>& a, const lane<T>& b) { return lane<T>(a.value - b.value); }
+template <typename T> inline lane<T> operator*(const lane<T>& a, const lane<T>& b) { return lane<T>(a.value * b.value); }
+template <typename T> inline lane<T> operator/(const lane<T>& a, const lane<T>& b) { return lane<T>(a.value / b.value); }
+template <typename T> inline lane<T> operator-(const lane<T>& a) { return lane<T>(-a.value); }
+template <typename T> inline bool operator<(const lane<T>& a, const lane<T>& b) { return a.value < b.value; }
+template <typename T> inline bool operator>(const lane<T>& a, const lane<T>& b) { return a.value > b.value; }
+template <typename T> inline bool operator<=(const lane<T>& a, const lane<T>& b) { return a.value <= b.value; }
+template <typename T> inline bool operator>=(const lane<T>& a, const lane<T>& b) { return a.value >= b.value; }
+template <typename T> inline bool operator==(const lane<T>& a, const lane<T>& b) { return a.value == b.value; }
+template <typename T> inline bool operator!=(const lane<T>& a, const lane<T>& b) { return a.value != b.value; }
+template <typename T> inline lane<T> madd(const lane<T>& a, const lane<T>& b, const lane<T>& c) { return lane<T>((a.value * b.value) + c.value); }
+template <typename T> inline lane<T> sqrt(const lane<T>& a) { return lane<T>((T)::sqrt(a.value)); }
+template <typename T> inline lane<T> min(const lane<T>& a, const lane<T>& b) { return lane<T>(a.value < b.value ? a.value : b.value); }
+template <typename T> inline lane<T> max(const lane<T>& a, const lane<T>& b) { return lane<T>(a.value > b.value ? a.value : b.value); }
+template <typename T> inline lane<T> select(const bool m, const lane<T>& a, const lane<T>& b) { return m ? a : b; }
+inline int bits(const bool m) { return m ? 1 : 0; }
+inline bool any(const bool m) { return m; }
+inline bool all(const bool m) { return m; }
+
+#if defined(GMATH_SSE41)
+struct f32x4
+{
+
+	typedef float type;
+	typedef f32x4 mask;
+	enum { width = 4 };
+
+	inline f32x4() : value(_mm_setzero_ps()) {}
+	inline f32x4(const float x) : value(_mm_set1_ps(x)) {}
+	inline f32x4(const __m128 x) : value(x) {}
+
+	static inline f32x4 load(const float* p)
+	{
+		return _mm_loadu_ps(p);
+	}
+	// lane i is set when bit i is
+	static inline f32x4 expand(const int bits)
+	{
+		__m128i b = _mm_setr_epi32(1, 2, 4, 8);
+		return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(bits), b), b));
+	}
+	inline void store(float* p) const
+	{
+		_mm_storeu_ps(p, this->value);
+	}
+
+	__m128 value;
+
+};
+
+inline f32x4 operator+(const f32x4& a, const f32x4& b) { return _mm_add_ps(a.value, b.value); }
+inline f32x4 operator-(const f32x4& a, const f32x4& b) { return _mm_sub_ps(a.value, b.value); }
+inline f32x4 operator*(const f32x4& a, const f32x4& b) { return _mm_mul_ps(a.value, b.value); }
+inline f32x4 operator/(const f32x4& a, const f32x4& b) { return _mm_div_ps(a.value, b.value); }
+inline f32x4 operator-(const f32x4& a) { return _mm_xor_ps(a.value, _mm_set1_ps(-0.0f)); }
+inline f32x4 operator<(const f32x4& a, const f32x4& b) { return _mm_cmplt_ps(a.value, b.value); }
+inline f32x4 operator>(const f32x4& a, const f32x4& b) { return _mm_cmpgt_ps(a.value, b.value); }
+inline f32x4 operator<=(const f32x4& a, const f32x4& b) { return _mm_cmple_ps(a.value, b.value); }
+inline f32x4 operator>=(const f32x4& a, const f32x4& b) { return _mm_cmpge_ps(a.value, b.value); }
+inline f32x4 operator==(const f32x4& a, const f32x4& b) { return _mm_cmpeq_ps(a.value, b.value); }
+inline f32x4 operator!=(const f32x4& a, const f32x4& b) { return _mm_cmpneq_ps(a.value, b.value); }
+inline f32x4 sqrt(const f32x4& a) { return _mm_sqrt_ps(a.value); }
+inline f32x4 min(const f32x4& a, const f32x4& b) { return _mm_min_ps(a.value, b.value); }
+inline f32x4 max(const f32x4& a, const f32x4& b) { return _mm_max_ps(a.value, b.value); }
+inline f32x4 select(const f32x4& m, const f32x4& a, const f32x4& b) { return _mm_blendv_ps(b.value, a.value, m.value); }
+inline f32x4 operator&(const f32x4& a, const f32x4& b) { return _mm_and_ps(a.value, b.value); }
+inline f32x4 operator|(const f32x4& a, const f32x4& b) { return _mm_or_ps(a.value, b.value); }
+inline int bits(const f32x4& m) { return _mm_movemask_ps(m.value); }
+inline bool any(const f32x4& m) { return _mm_movemask_ps(m.value) != 0; }
+inline bool all(const f32x4& m) { return _mm_movemask_ps(m.value) == 0xF; }
+inline f32x4 madd(const f32x4& a, const f32x4& b, const f32x4& c)
+{
+#if defined(GMATH_FMA)
+	return _mm_fmadd_ps(a.value, b.value, c.value);
+#else
+	return _mm_add_ps(_mm_mul_ps(a.value, b.value), c.value);
+#endif
+}
+#endif
+
+#if defined(GMATH_AVX)
+struct f32x8
+{
+
+	typedef float type;
+	typedef f32x8 mask;
+	enum { width = 8 };
+
+	inline f32x8() : value(_mm256_setzero_ps()) {}
+	inline f32x8(const float x) : value(_mm256_set1_ps(x)) {}
+	inline f32x8(const __m256 x) : value(x) {}
+
+	static inline f32x8 load(const float* p)
+	{
+		return _mm256_loadu_ps(p);
+	}
+	static inline f32x8 expand(const int bits)
+	{
+		// without AVX2 the integer test has to be done a half at a time
+		__m128i b0 = _mm_setr_epi32(1, 2, 4, 8);
+		__m128i b1 = _mm_setr_epi32(16, 32, 64, 128);
+		__m128i x = _mm_set1_epi32(bits);
+		__m128 lo = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(x, b0), b0));
+		__m128 hi = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(x, b1), b1));
+		return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+	}
+	inline void store(float* p) const
+	{
+		_mm256_storeu_ps(p, this->value);
+	}
+
+	__m256 value;
+
+};
+
+inline f32x8 operator+(const f32x8& a, const f32x8& b) { return _mm256_add_ps(a.value, b.value); }
+inline f32x8 operator-(const f32x8& a, const f32x8& b) { return _mm256_sub_ps(a.value, b.value); }
+inline f32x8 operator*(const f32x8& a, const f32x8& b) { return _mm256_mul_ps(a.value, b.value); }
+inline f32x8 operator/(const f32x8& a, const f32x8& b) { return _mm256_div_ps(a.value, b.value); }
+inline f32x8 operator-(const f32x8& a) { return _mm256_xor_ps(a.value, _mm256_set1_ps(-0.0f)); }
+inline f32x8 operator<(const f32x8& a, const f32x8& b) { return _mm256_cmp_ps(a.value, b.value, _CMP_LT_OQ); }
+inline f32x8 operator>(const f32x8& a, const f32x8& b) { return _mm256_cmp_ps(a.value, b.value, _CMP_GT_OQ); }
+inline f32x8 operator<=(const f32x8& a, const f32x8& b) { return _mm256_cmp_ps(a.value, b.value, _CMP_LE_OQ); }
+inline f32x8 operator>=(const f32x8& a, const f32x8& b) { return _mm256_cmp_ps(a.value, b.value, _CMP_GE_OQ); }
+inline f32x8 operator==(const f32x8& a, const f32x8& b) { return _mm256_cmp_ps(a.value, b.value, _CMP_EQ_OQ); }
+inline f32x8 operator!=(const f32x8& a, const f32x8& b) { return _mm256_cmp_ps(a.value, b.value, _CMP_NEQ_UQ); }
+inline f32x8 sqrt(const f32x8& a) { return _mm256_sqrt_ps(a.value); }
+inline f32x8 min(const f32x8& a, const f32x8& b) { return _mm256_min_ps(a.value, b.value); }
+inline f32x8 max(const f32x8& a, const f32x8& b) { return _mm256_max_ps(a.value, b.value); }
+inline f32x8 select(const f32x8& m, const f32x8& a, const f32x8& b) { return _mm256_blendv_ps(b.value, a.value, m.value); }
+inline f32x8 operator&(const f32x8& a, const f32x8& b) { return _mm256_and_ps(a.value, b.value); }
+inline f32x8 operator|(const f32x8& a, const f32x8& b) { return _mm256_or_ps(a.value, b.value); }
+inline int bits(const f32x8& m) { return _mm256_movemask_ps(m.value); }
+inline bool any(const f32x8& m) { return _mm256_movemask_ps(m.value) != 0; }
+inline bool all(const f32x8& m) { return _mm256_movemask_ps(m.value) == 0xFF; }
+inline f32x8 madd(const f32x8& a, const f32x8& b, const f32x8& c)
+{
+#if defined(GMATH_FMA)
+	return _mm256_fmadd_ps(a.value, b.value, c.value);
+#else
+	return _mm256_add_ps(_mm256_mul_ps(a.value, b.value), c.value);
+#endif
+}
+#endif
+
+#if defined(GMATH_AVX)
+struct f64x4
+{
+
+	typedef double type;
+	typedef f64x4 mask;
+	enum { width = 4 };
+
+	inline f64x4() : value(_mm256_setzero_pd()) {}
+	inline f64x4(const double x) : value(_mm256_set1_pd(x)) {}
+	inline f64x4(const __m256d x) : value(x) {}
+
+	static inline f64x4 load(const double* p)
+	{
+		return _mm256_loadu_pd(p);
+	}
+	static inline f64x4 expand(const int bits)
+	{
+		__m128i b0 = _mm_setr_epi32(1, 1, 2, 2);
+		__m128i b1 = _mm_setr_epi32(4, 4, 8, 8);
+		__m128i x = _mm_set1_epi32(bits);
+		__m128d lo = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(x, b0), b0));
+		__m128d hi = _mm_castsi128_pd(_mm_cmpeq_epi32(_mm_and_si128(x, b1), b1));
+		return _mm256_insertf128_pd(_mm256_castpd128_pd256(lo), hi, 1);
+	}
+	inline void store(double* p) const
+	{
+		_mm256_storeu_pd(p, this->value);
+	}
+
+	__m256d value;
+
+};
+
+inline f64x4 operator+(const f64x4& a, const f64x4& b) { return _mm256_add_pd(a.value, b.value); }
+inline f64x4 operator-(const f64x4& a, const f64x4& b) { return _mm256_sub_pd(a.value, b.value); }
+inline f64x4 operator*(const f64x4& a, const f64x4& b) { return _mm256_mul_pd(a.value, b.value); }
+inline f64x4 operator/(const f64x4& a, const f64x4& b) { return _mm256_div_pd(a.value, b.value); }
+inline f64x4 operator-(const f64x4& a) { return _mm256_xor_pd(a.value, _mm256_set1_pd(-0.0)); }
+inline f64x4 operator<(const f64x4& a, const f64x4& b) { return _mm256_cmp_pd(a.value, b.value, _CMP_LT_OQ); }
+inline f64x4 operator>(const f64x4& a, const f64x4& b) { return _mm256_cmp_pd(a.value, b.value, _CMP_GT_OQ); }
+inline f64x4 operator<=(const f64x4& a, const f64x4& b) { return _mm256_cmp_pd(a.value, b.value, _CMP_LE_OQ); }
+inline f64x4 operator>=(const f64x4& a, const f64x4& b) { return _mm256_cmp_pd(a.value, b.value, _CMP_GE_OQ); }
+inline f64x4 operator==(const f64x4& a, const f64x4& b) { return _mm256_cmp_pd(a.value, b.value, _CMP_EQ_OQ); }
+inline f64x4 operator!=(const f64x4& a, const f64x4& b) { return _mm256_cmp_pd(a.value, b.value, _CMP_NEQ_UQ); }
+inline f64x4 sqrt(const f64x4& a) { return _mm256_sqrt_pd(a.value); }
+inline f64x4 min(const f64x4& a, const f64x4& b) { return _mm256_min_pd(a.value, b.value); }
+inline f64x4 max(const f64x4& a, const f64x4& b) { return _mm256_max_pd(a.value, b.value); }
+inline f64x4 select(const f64x4& m, const f64x4& a, const f64x4& b) { return _mm256_blendv_pd(b.value, a.value, m.value); }
+inline f64x4 operator&(const f64x4& a, const f64x4& b) { return _mm256_and_pd(a.value, b.value); }
+inline f64x4 operator|(const f64x4& a, const f64x4& b) { return _mm256_or_pd(a.value, b.value); }
+inline int bits(const f64x4& m) { return _mm256_movemask_pd(m.value); }
+inline bool any(const f64x4& m) { return _mm256_movemask_pd(m.value) != 0; }
+inline bool all(const f64x4& m) { return _mm256_movemask_pd(m.value) == 0xF; }
+inline f64x4 madd(const f64x4& a, const f64x4& b, const f64x4& c)
+{
+#if defined(GMATH_FMA)
+	return _mm256_fmadd_pd(a.value, b.value, c.value);
+#else
+	return _mm256_add_pd(_mm256_mul_pd(a.value, b.value), c.value);
+#endif
+}
+#endif
+
+template <typename T> struct widest
+{
+	typedef lane<T> type;
+};
+#if defined(GMATH_AVX)
+template <> struct widest<float>
+{
+	typedef f32x8 type;
+};
+#elif defined(GMATH_SSE41)
+template <> struct widest<float>
+{
+	typedef f32x4 type;
+};
+#endif
+#if defined(GMATH_AVX)
+template <> struct widest<double>
+{
+	typedef f64x4 type;
+};
+#endif
+
+}
+
+#if defined(GMATH_SSE41)
+namespace simd
+{
+
+inline __m128 load(const tvec4<float>& v)
+{
+	return _mm_loadu_ps((const float*)&v);
+}
+inline tvec4<float> store(const __m128 x)
+{
+	tvec4<float> v;
+	_mm_storeu_ps((float*)&v, x);
+	return v;
+}
+inline __m128 madd(const __m128 a, const __m128 b, const __m128 c)
+{
+#if defined(GMATH_FMA)
+	return _mm_fmadd_ps(a, b, c);
+#else
+	return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+// Masks travel as one bool per lane; these widen them to full lane masks and back.
+inline __m128 loadMask(const tvec4<bool>& m)
+{
+	int x;
+	memcpy(&x, &m, sizeof(x));
+	return _mm_castsi128_ps(_mm_cmpgt_epi32(_mm_cvtepu8_epi32(_mm_cvtsi32_si128(x)), _mm_setzero_si128()));
+}
+inline tvec4<bool> storeMask(const __m128 m)
+{
+	int b = _mm_movemask_ps(m);
+	return tvec4<bool>((b & 1) != 0, (b & 2) != 0, (b & 4) != 0, (b & 8) != 0);
+}
+inline __m128 column(const tmat4x4<float>& m, const int index)
+{
+	return _mm_loadu_ps((const float*)&m._columns[index]);
+}
+inline __m128 transform(const tmat4x4<float>& m, const __m128 v)
+{
+	__m128 r = _mm_mul_ps(column(m, 0), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+	r = madd(column(m, 1), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), r);
+	r = madd(column(m, 2), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), r);
+	return madd(column(m, 3), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), r);
+}
+
+}
+
+inline tvec4<float> operator+(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::store(_mm_add_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<float> operator+(const tvec4<float>& v, const float x)
+{
+	return simd::store(_mm_add_ps(simd::load(v), _mm_set1_ps(x)));
+}
+inline tvec4<float> operator+(const float x, const tvec4<float>& v)
+{
+	return simd::store(_mm_add_ps(_mm_set1_ps(x), simd::load(v)));
+}
+inline tvec4<float> operator-(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::store(_mm_sub_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<float> operator-(const tvec4<float>& v, const float x)
+{
+	return simd::store(_mm_sub_ps(simd::load(v), _mm_set1_ps(x)));
+}
+inline tvec4<float> operator-(const float x, const tvec4<float>& v)
+{
+	return simd::store(_mm_sub_ps(_mm_set1_ps(x), simd::load(v)));
+}
+inline tvec4<float> operator*(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::store(_mm_mul_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<float> operator*(const tvec4<float>& v, const float x)
+{
+	return simd::store(_mm_mul_ps(simd::load(v), _mm_set1_ps(x)));
+}
+inline tvec4<float> operator*(const float x, const tvec4<float>& v)
+{
+	return simd::store(_mm_mul_ps(_mm_set1_ps(x), simd::load(v)));
+}
+inline tvec4<float> operator/(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::store(_mm_div_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<float> operator/(const tvec4<float>& v, const float x)
+{
+	return simd::store(_mm_div_ps(simd::load(v), _mm_set1_ps(x)));
+}
+inline tvec4<float> operator/(const float x, const tvec4<float>& v)
+{
+	return simd::store(_mm_div_ps(_mm_set1_ps(x), simd::load(v)));
+}
+
+inline tvec4<bool> lessThan(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::storeMask(_mm_cmplt_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<bool> lessThanEqual(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::storeMask(_mm_cmple_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<bool> greaterThan(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::storeMask(_mm_cmpgt_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<bool> greaterThanEqual(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::storeMask(_mm_cmpge_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<bool> equal(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::storeMask(_mm_cmpeq_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<bool> notEqual(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::storeMask(_mm_cmpneq_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<float> select(const tvec4<bool>& m, const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return simd::store(_mm_blendv_ps(simd::load(v1), simd::load(v0), simd::loadMask(m)));
+}
+inline tvec4<float> clamp(const tvec4<float>& v, const tvec4<float>& min, const tvec4<float>& max)
+{
+	__m128 x = simd::load(v);
+	__m128 lo = simd::load(min);
+	return simd::store(_mm_blendv_ps(_mm_min_ps(simd::load(max), x), lo, _mm_cmplt_ps(x, lo)));
+}
+inline tvec4<float> sign(const tvec4<float>& v)
+{
+	return simd::store(_mm_and_ps(_mm_cmpgt_ps(simd::load(v), _mm_setzero_ps()), _mm_set1_ps(1.0f)));
+}
+
+template <> inline void tvec4<float>::operator+=(const tvec4<float>& v)
+{
+	_mm_storeu_ps((float*)this, _mm_add_ps(_mm_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec4<float>::operator+=(const float x)
+{
+	_mm_storeu_ps((float*)this, _mm_add_ps(_mm_loadu_ps((const float*)this), _mm_set1_ps(x)));
+}
+template <> inline void tvec4<float>::operator-=(const tvec4<float>& v)
+{
+	_mm_storeu_ps((float*)this, _mm_sub_ps(_mm_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec4<float>::operator-=(const float x)
+{
+	_mm_storeu_ps((float*)this, _mm_sub_ps(_mm_loadu_ps((const float*)this), _mm_set1_ps(x)));
+}
+template <> inline void tvec4<float>::operator*=(const tvec4<float>& v)
+{
+	_mm_storeu_ps((float*)this, _mm_mul_ps(_mm_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec4<float>::operator*=(const float x)
+{
+	_mm_storeu_ps((float*)this, _mm_mul_ps(_mm_loadu_ps((const float*)this), _mm_set1_ps(x)));
+}
+template <> inline void tvec4<float>::operator/=(const tvec4<float>& v)
+{
+	_mm_storeu_ps((float*)this, _mm_div_ps(_mm_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec4<float>::operator/=(const float x)
+{
+	_mm_storeu_ps((float*)this, _mm_div_ps(_mm_loadu_ps((const float*)this), _mm_set1_ps(x)));
+}
+
+inline float dot(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	return _mm_cvtss_f32(_mm_dp_ps(simd::load(v0), simd::load(v1), 0xF1));
+}
+inline float magnitude(const tvec4<float>& v)
+{
+	__m128 x = simd::load(v);
+	return _mm_cvtss_f32(_mm_sqrt_ss(_mm_dp_ps(x, x, 0xF1)));
+}
+inline float distance(const tvec4<float>& v0, const tvec4<float>& v1)
+{
+	__m128 x = _mm_sub_ps(simd::load(v0), simd::load(v1));
+	return _mm_cvtss_f32(_mm_sqrt_ss(_mm_dp_ps(x, x, 0xF1)));
+}
+inline tvec4<float> normalize(const tvec4<float>& v)
+{
+	__m128 x = simd::load(v);
+	__m128 m = _mm_sqrt_ps(_mm_dp_ps(x, x, 0xFF));
+	__m128 zero = _mm_cmpeq_ps(m, _mm_setzero_ps());
+	return simd::store(_mm_andnot_ps(zero, _mm_div_ps(x, m)));
+}
+
+inline tvec4<float> operator*(const tmat4x4<float>& m, const tvec4<float>& v)
+{
+	return simd::store(simd::transform(m, simd::load(v)));
+}
+inline tvec4<float> operator*(const tvec4<float>& v, const tmat4x4<float>& m)
+{
+	__m128 c0 = simd::column(m, 0);
+	__m128 c1 = simd::column(m, 1);
+	__m128 c2 = simd::column(m, 2);
+	__m128 c3 = simd::column(m, 3);
+	_MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+	__m128 x = simd::load(v);
+	__m128 r = _mm_mul_ps(c0, _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 0)));
+	r = simd::madd(c1, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1)), r);
+	r = simd::madd(c2, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 2, 2)), r);
+	return simd::store(simd::madd(c3, _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3)), r));
+}
+inline tmat4x4<float> operator*(const tmat4x4<float>& m0, const tmat4x4<float>& m1)
+{
+	tmat4x4<float> m;
+#if defined(GMATH_AVX)
+	__m256 c0 = _mm256_broadcast_ps((const __m128*)&m0._columns[0]);
+	__m256 c1 = _mm256_broadcast_ps((const __m128*)&m0._columns[1]);
+	__m256 c2 = _mm256_broadcast_ps((const __m128*)&m0._columns[2]);
+	__m256 c3 = _mm256_broadcast_ps((const __m128*)&m0._columns[3]);
+	for (int i = 0; i < 4; i += 2)
+	{
+		__m256 x = _mm256_loadu_ps((const float*)&m1._columns[i]);
+#if defined(GMATH_FMA)
+		__m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(x, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm256_fmadd_ps(c1, _mm256_permute_ps(x, _MM_SHUFFLE(1, 1, 1, 1)), r);
+		r = _mm256_fmadd_ps(c2, _mm256_permute_ps(x, _MM_SHUFFLE(2, 2, 2, 2)), r);
+		r = _mm256_fmadd_ps(c3, _mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3)), r);
+#else
+		__m256 r = _mm256_mul_ps(c0, _mm256_permute_ps(x, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm256_add_ps(_mm256_mul_ps(c1, _mm256_permute_ps(x, _MM_SHUFFLE(1, 1, 1, 1))), r);
+		r = _mm256_add_ps(_mm256_mul_ps(c2, _mm256_permute_ps(x, _MM_SHUFFLE(2, 2, 2, 2))), r);
+		r = _mm256_add_ps(_mm256_mul_ps(c3, _mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3))), r);
+#endif
+		_mm256_storeu_ps((float*)&m._columns[i], r);
+	}
+#else
+	for (int i = 0; i < 4; i++)
+	{
+		_mm_storeu_ps((float*)&m._columns[i], simd::transform(m0, simd::column(m1, i)));
+	}
+#endif
+	return m;
+}
+#endif
+
+#if defined(GMATH_AVX)
+namespace simd
+{
+
+inline __m256d load(const tvec4<double>& v)
+{
+	return _mm256_loadu_pd((const double*)&v);
+}
+inline tvec4<double> store(const __m256d x)
+{
+	tvec4<double> v;
+	_mm256_storeu_pd((double*)&v, x);
+	return v;
+}
+inline __m256d madd(const __m256d a, const __m256d b, const __m256d c)
+{
+#if defined(GMATH_FMA)
+	return _mm256_fmadd_pd(a, b, c);
+#else
+	return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+}
+inline __m256d column(const tmat4x4<double>& m, const int index)
+{
+	return _mm256_loadu_pd((const double*)&m._columns[index]);
+}
+// v points at (at least) the three or four components to multiply the columns by
+inline __m256d transform(const tmat4x4<double>& m, const double* v)
+{
+	__m256d r = _mm256_mul_pd(column(m, 0), _mm256_broadcast_sd(v));
+	r = madd(column(m, 1), _mm256_broadcast_sd(v + 1), r);
+	r = madd(column(m, 2), _mm256_broadcast_sd(v + 2), r);
+	return madd(column(m, 3), _mm256_broadcast_sd(v + 3), r);
+}
+inline double sum(const __m256d x)
+{
+	__m128d s = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+	return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+}
+
+inline tvec4<double> operator+(const tvec4<double>& v0, const tvec4<double>& v1)
+{
+	return simd::store(_mm256_add_pd(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<double> operator+(const tvec4<double>& v, const double x)
+{
+	return simd::store(_mm256_add_pd(simd::load(v), _mm256_set1_pd(x)));
+}
+inline tvec4<double> operator+(const double x, const tvec4<double>& v)
+{
+	return simd::store(_mm256_add_pd(_mm256_set1_pd(x), simd::load(v)));
+}
+inline tvec4<double> operator-(const tvec4<double>& v0, const tvec4<double>& v1)
+{
+	return simd::store(_mm256_sub_pd(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<double> operator-(const tvec4<double>& v, const double x)
+{
+	return simd::store(_mm256_sub_pd(simd::load(v), _mm256_set1_pd(x)));
+}
+inline tvec4<double> operator-(const double x, const tvec4<double>& v)
+{
+	return simd::store(_mm256_sub_pd(_mm256_set1_pd(x), simd::load(v)));
+}
+inline tvec4<double> operator*(const tvec4<double>& v0, const tvec4<double>& v1)
+{
+	return simd::store(_mm256_mul_pd(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<double> operator*(const tvec4<double>& v, const double x)
+{
+	return simd::store(_mm256_mul_pd(simd::load(v), _mm256_set1_pd(x)));
+}
+inline tvec4<double> operator*(const double x, const tvec4<double>& v)
+{
+	return simd::store(_mm256_mul_pd(_mm256_set1_pd(x), simd::load(v)));
+}
+inline tvec4<double> operator/(const tvec4<double>& v0, const tvec4<double>& v1)
+{
+	return simd::store(_mm256_div_pd(simd::load(v0), simd::load(v1)));
+}
+inline tvec4<double> operator/(const tvec4<double>& v, const double x)
+{
+	return simd::store(_mm256_div_pd(simd::load(v), _mm256_set1_pd(x)));
+}
+inline tvec4<double> operator/(const double x, const tvec4<double>& v)
+{
+	return simd::store(_mm256_div_pd(_mm256_set1_pd(x), simd::load(v)));
+}
+
+template <> inline void tvec4<double>::operator+=(const tvec4<double>& v)
+{
+	_mm256_storeu_pd((double*)this, _mm256_add_pd(_mm256_loadu_pd((const double*)this), simd::load(v)));
+}
+template <> inline void tvec4<double>::operator+=(const double x)
+{
+	_mm256_storeu_pd((double*)this, _mm256_add_pd(_mm256_loadu_pd((const double*)this), _mm256_set1_pd(x)));
+}
+template <> inline void tvec4<double>::operator-=(const tvec4<double>& v)
+{
+	_mm256_storeu_pd((double*)this, _mm256_sub_pd(_mm256_loadu_pd((const double*)this), simd::load(v)));
+}
+template <> inline void tvec4<double>::operator-=(const double x)
+{
+	_mm256_storeu_pd((double*)this, _mm256_sub_pd(_mm256_loadu_pd((const double*)this), _mm256_set1_pd(x)));
+}
+template <> inline void tvec4<double>::operator*=(const tvec4<double>& v)
+{
+	_mm256_storeu_pd((double*)this, _mm256_mul_pd(_mm256_loadu_pd((const double*)this), simd::load(v)));
+}
+template <> inline void tvec4<double>::operator*=(const double x)
+{
+	_mm256_storeu_pd((double*)this, _mm256_mul_pd(_mm256_loadu_pd((const double*)this), _mm256_set1_pd(x)));
+}
+template <> inline void tvec4<double>::operator/=(const tvec4<double>& v)
+{
+	_mm256_storeu_pd((double*)this, _mm256_div_pd(_mm256_loadu_pd((const double*)this), simd::load(v)));
+}
+template <> inline void tvec4<double>::operator/=(const double x)
+{
+	_mm256_storeu_pd((double*)this, _mm256_div_pd(_mm256_loadu_pd((const double*)this), _mm256_set1_pd(x)));
+}
+
+inline double dot(const tvec4<double>& v0, const tvec4<double>& v1)
+{
+	return simd::sum(_mm256_mul_pd(simd::load(v0), simd::load(v1)));
+}
+inline double magnitude(const tvec4<double>& v)
+{
+	return ::sqrt(dot(v, v));
+}
+inline double distance(const tvec4<double>& v0, const tvec4<double>& v1)
+{
+	__m256d x = _mm256_sub_pd(simd::load(v0), simd::load(v1));
+	return ::sqrt(simd::sum(_mm256_mul_pd(x, x)));
+}
+inline tvec4<double> normalize(const tvec4<double>& v)
+{
+	__m256d x = simd::load(v);
+	__m256d m = _mm256_set1_pd(::sqrt(simd::sum(_mm256_mul_pd(x, x))));
+	__m256d zero = _mm256_cmp_pd(m, _mm256_setzero_pd(), _CMP_EQ_OQ);
+	return simd::store(_mm256_andnot_pd(zero, _mm256_div_pd(x, m)));
+}
+
+inline tvec4<double> operator*(const tmat4x4<double>& m, const tvec4<double>& v)
+{
+	return simd::store(simd::transform(m, (const double*)&v));
+}
+inline tvec4<double> operator*(const tvec4<double>& v, const tmat4x4<double>& m)
+{
+	__m256d x = simd::load(v);
+	__m256d h01 = _mm256_hadd_pd(_mm256_mul_pd(x, simd::column(m, 0)), _mm256_mul_pd(x, simd::column(m, 1)));
+	__m256d h23 = _mm256_hadd_pd(_mm256_mul_pd(x, simd::column(m, 2)), _mm256_mul_pd(x, simd::column(m, 3)));
+	return simd::store(_mm256_add_pd(_mm256_permute2f128_pd(h01, h23, 0x20), _mm256_permute2f128_pd(h01, h23, 0x31)));
+}
+inline tmat4x4<double> operator*(const tmat4x4<double>& m0, const tmat4x4<double>& m1)
+{
+	tmat4x4<double> m;
+	for (int i = 0; i < 4; i++)
+	{
+		_mm256_storeu_pd((double*)&m._columns[i], simd::transform(m0, (const double*)&m1._columns[i]));
+	}
+
+	return m;
+}
+
+#if defined(GMATH_AVX2)
+namespace simd
+{
+
+template <int S> inline __m256d splat(const __m256d x)
+{
+	return _mm256_permute4x64_pd(x, _MM_SHUFFLE(S, S, S, S));
+}
+
+}
+
+// The scalar cofactor expansion, one column of coefficients per register.
+inline tmat4x4<double> inverse(const tmat4x4<double>& m, double& determinant)
+{
+	__m256d m0 = simd::column(m, 0);
+	__m256d m1 = simd::column(m, 1);
+	__m256d m2 = simd::column(m, 2);
+	__m256d m3 = simd::column(m, 3);
+
+	// a = (m2, m2, m1, m1) and b = (m3, m3, m3, m2), both taken at one row
+	__m256d ax = _mm256_blend_pd(simd::splat<0>(m2), simd::splat<0>(m1), 0xC);
+	__m256d ay = _mm256_blend_pd(simd::splat<1>(m2), simd::splat<1>(m1), 0xC);
+	__m256d az = _mm256_blend_pd(simd::splat<2>(m2), simd::splat<2>(m1), 0xC);
+	__m256d aw = _mm256_blend_pd(simd::splat<3>(m2), simd::splat<3>(m1), 0xC);
+	__m256d bx = _mm256_blend_pd(simd::splat<0>(m3), simd::splat<0>(m2), 0x8);
+	__m256d by = _mm256_blend_pd(simd::splat<1>(m3), simd::splat<1>(m2), 0x8);
+	__m256d bz = _mm256_blend_pd(simd::splat<2>(m3), simd::splat<2>(m2), 0x8);
+	__m256d bw = _mm256_blend_pd(simd::splat<3>(m3), simd::splat<3>(m2), 0x8);
+
+	__m256d f0 = _mm256_sub_pd(_mm256_mul_pd(az, bw), _mm256_mul_pd(bz, aw));
+	__m256d f1 = _mm256_sub_pd(_mm256_mul_pd(ay, bw), _mm256_mul_pd(by, aw));
+	__m256d f2 = _mm256_sub_pd(_mm256_mul_pd(ay, bz), _mm256_mul_pd(by, az));
+	__m256d f3 = _mm256_sub_pd(_mm256_mul_pd(ax, bw), _mm256_mul_pd(bx, aw));
+	__m256d f4 = _mm256_sub_pd(_mm256_mul_pd(ax, bz), _mm256_mul_pd(bx, az));
+	__m256d f5 = _mm256_sub_pd(_mm256_mul_pd(ax, by), _mm256_mul_pd(bx, ay));
+
+	// (m1, m0, m0, m0) at each row
+	__m256d v0 = _mm256_blend_pd(simd::splat<0>(m0), simd::splat<0>(m1), 0x1);
+	__m256d v1 = _mm256_blend_pd(simd::splat<1>(m0), simd::splat<1>(m1), 0x1);
+	__m256d v2 = _mm256_blend_pd(simd::splat<2>(m0), simd::splat<2>(m1), 0x1);
+	__m256d v3 = _mm256_blend_pd(simd::splat<3>(m0), simd::splat<3>(m1), 0x1);
+
+	const __m256d sign1 = _mm256_setr_pd(+1.0, -1.0, +1.0, -1.0);
+	const __m256d sign2 = _mm256_setr_pd(-1.0, +1.0, -1.0, +1.0);
+	__m256d i0 = _mm256_mul_pd(sign1, _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(v1, f0), _mm256_mul_pd(v2, f1)), _mm256_mul_pd(v3, f2)));
+	__m256d i1 = _mm256_mul_pd(sign2, _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(v0, f0), _mm256_mul_pd(v2, f3)), _mm256_mul_pd(v3, f4)));
+	__m256d i2 = _mm256_mul_pd(sign1, _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(v0, f1), _mm256_mul_pd(v1, f3)), _mm256_mul_pd(v3, f5)));
+	__m256d i3 = _mm256_mul_pd(sign2, _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(v0, f2), _mm256_mul_pd(v1, f4)), _mm256_mul_pd(v2, f5)));
+
+	__m256d row = _mm256_permute2f128_pd(_mm256_unpacklo_pd(i0, i1), _mm256_unpacklo_pd(i2, i3), 0x20);
+	determinant = simd::sum(_mm256_mul_pd(m0, row));
+
+	__m256d r = _mm256_set1_pd(determinant);
+	tmat4x4<double> inverse;
+	_mm256_storeu_pd((double*)&inverse._columns[0], _mm256_div_pd(i0, r));
+	_mm256_storeu_pd((double*)&inverse._columns[1], _mm256_div_pd(i1, r));
+	_mm256_storeu_pd((double*)&inverse._columns[2], _mm256_div_pd(i2, r));
+	_mm256_storeu_pd((double*)&inverse._columns[3], _mm256_div_pd(i3, r));
+	return inverse;
+}
+inline tmat4x4<double> inverse(const tmat4x4<double>& m)
+{
+	double determinant;
+	return inverse(m, determinant);
+}
+#endif
+#endif
+
+#if defined(GMATH_AVX)
+namespace simd
+{
+
+inline __m256 load(const tvec<8, float>& v)
+{
+	return _mm256_loadu_ps((const float*)&v);
+}
+inline tvec<8, float> store(const __m256 x)
+{
+	tvec<8, float> v;
+	_mm256_storeu_ps((float*)&v, x);
+	return v;
+}
+
+}
+
+inline tvec<8, float> operator+(const tvec<8, float>& v0, const tvec<8, float>& v1)
+{
+	return simd::store(_mm256_add_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec<8, float> operator+(const tvec<8, float>& v, const float x)
+{
+	return simd::store(_mm256_add_ps(simd::load(v), _mm256_set1_ps(x)));
+}
+inline tvec<8, float> operator+(const float x, const tvec<8, float>& v)
+{
+	return simd::store(_mm256_add_ps(_mm256_set1_ps(x), simd::load(v)));
+}
+inline tvec<8, float> operator-(const tvec<8, float>& v0, const tvec<8, float>& v1)
+{
+	return simd::store(_mm256_sub_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec<8, float> operator-(const tvec<8, float>& v, const float x)
+{
+	return simd::store(_mm256_sub_ps(simd::load(v), _mm256_set1_ps(x)));
+}
+inline tvec<8, float> operator-(const float x, const tvec<8, float>& v)
+{
+	return simd::store(_mm256_sub_ps(_mm256_set1_ps(x), simd::load(v)));
+}
+inline tvec<8, float> operator*(const tvec<8, float>& v0, const tvec<8, float>& v1)
+{
+	return simd::store(_mm256_mul_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec<8, float> operator*(const tvec<8, float>& v, const float x)
+{
+	return simd::store(_mm256_mul_ps(simd::load(v), _mm256_set1_ps(x)));
+}
+inline tvec<8, float> operator*(const float x, const tvec<8, float>& v)
+{
+	return simd::store(_mm256_mul_ps(_mm256_set1_ps(x), simd::load(v)));
+}
+inline tvec<8, float> operator/(const tvec<8, float>& v0, const tvec<8, float>& v1)
+{
+	return simd::store(_mm256_div_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec<8, float> operator/(const tvec<8, float>& v, const float x)
+{
+	return simd::store(_mm256_div_ps(simd::load(v), _mm256_set1_ps(x)));
+}
+inline tvec<8, float> operator/(const float x, const tvec<8, float>& v)
+{
+	return simd::store(_mm256_div_ps(_mm256_set1_ps(x), simd::load(v)));
+}
+
+template <> inline void tvec<8, float>::operator+=(const tvec<8, float>& v)
+{
+	_mm256_storeu_ps((float*)this, _mm256_add_ps(_mm256_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec<8, float>::operator+=(const float x)
+{
+	_mm256_storeu_ps((float*)this, _mm256_add_ps(_mm256_loadu_ps((const float*)this), _mm256_set1_ps(x)));
+}
+template <> inline void tvec<8, float>::operator-=(const tvec<8, float>& v)
+{
+	_mm256_storeu_ps((float*)this, _mm256_sub_ps(_mm256_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec<8, float>::operator-=(const float x)
+{
+	_mm256_storeu_ps((float*)this, _mm256_sub_ps(_mm256_loadu_ps((const float*)this), _mm256_set1_ps(x)));
+}
+template <> inline void tvec<8, float>::operator*=(const tvec<8, float>& v)
+{
+	_mm256_storeu_ps((float*)this, _mm256_mul_ps(_mm256_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec<8, float>::operator*=(const float x)
+{
+	_mm256_storeu_ps((float*)this, _mm256_mul_ps(_mm256_loadu_ps((const float*)this), _mm256_set1_ps(x)));
+}
+template <> inline void tvec<8, float>::operator/=(const tvec<8, float>& v)
+{
+	_mm256_storeu_ps((float*)this, _mm256_div_ps(_mm256_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec<8, float>::operator/=(const float x)
+{
+	_mm256_storeu_ps((float*)this, _mm256_div_ps(_mm256_loadu_ps((const float*)this), _mm256_set1_ps(x)));
+}
+template <> inline tvec<8, float> tvec<8, float>::operator&&(const tvec<8, float>& v) const
+{
+	return simd::store(_mm256_min_ps(simd::load(*this), simd::load(v)));
+}
+template <> inline tvec<8, float> tvec<8, float>::operator||(const tvec<8, float>& v) const
+{
+	return simd::store(_mm256_max_ps(simd::load(*this), simd::load(v)));
+}
+
+inline float dot(const tvec<8, float>& v0, const tvec<8, float>& v1)
+{
+	__m256 d = _mm256_dp_ps(simd::load(v0), simd::load(v1), 0xF1);
+	return _mm_cvtss_f32(_mm_add_ss(_mm256_castps256_ps128(d), _mm256_extractf128_ps(d, 1)));
+}
+inline float magnitude(const tvec<8, float>& v)
+{
+	return sqrtf(dot(v, v));
+}
+inline float distance(const tvec<8, float>& v0, const tvec<8, float>& v1)
+{
+	return magnitude(v0 - v1);
+}
+inline tvec<8, float> normalize(const tvec<8, float>& v)
+{
+	float m = magnitude(v);
+	return m == 0.0f ? tvec<8, float>() : v / m;
+}
+#endif
+
+#if defined(GMATH_AVX512)
+namespace simd
+{
+
+inline __m512 load(const tvec<16, float>& v)
+{
+	return _mm512_loadu_ps((const float*)&v);
+}
+inline tvec<16, float> store(const __m512 x)
+{
+	tvec<16, float> v;
+	_mm512_storeu_ps((float*)&v, x);
+	return v;
+}
+
+}
+
+inline tvec<16, float> operator+(const tvec<16, float>& v0, const tvec<16, float>& v1)
+{
+	return simd::store(_mm512_add_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec<16, float> operator+(const tvec<16, float>& v, const float x)
+{
+	return simd::store(_mm512_add_ps(simd::load(v), _mm512_set1_ps(x)));
+}
+inline tvec<16, float> operator+(const float x, const tvec<16, float>& v)
+{
+	return simd::store(_mm512_add_ps(_mm512_set1_ps(x), simd::load(v)));
+}
+inline tvec<16, float> operator-(const tvec<16, float>& v0, const tvec<16, float>& v1)
+{
+	return simd::store(_mm512_sub_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec<16, float> operator-(const tvec<16, float>& v, const float x)
+{
+	return simd::store(_mm512_sub_ps(simd::load(v), _mm512_set1_ps(x)));
+}
+inline tvec<16, float> operator-(const float x, const tvec<16, float>& v)
+{
+	return simd::store(_mm512_sub_ps(_mm512_set1_ps(x), simd::load(v)));
+}
+inline tvec<16, float> operator*(const tvec<16, float>& v0, const tvec<16, float>& v1)
+{
+	return simd::store(_mm512_mul_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec<16, float> operator*(const tvec<16, float>& v, const float x)
+{
+	return simd::store(_mm512_mul_ps(simd::load(v), _mm512_set1_ps(x)));
+}
+inline tvec<16, float> operator*(const float x, const tvec<16, float>& v)
+{
+	return simd::store(_mm512_mul_ps(_mm512_set1_ps(x), simd::load(v)));
+}
+inline tvec<16, float> operator/(const tvec<16, float>& v0, const tvec<16, float>& v1)
+{
+	return simd::store(_mm512_div_ps(simd::load(v0), simd::load(v1)));
+}
+inline tvec<16, float> operator/(const tvec<16, float>& v, const float x)
+{
+	return simd::store(_mm512_div_ps(simd::load(v), _mm512_set1_ps(x)));
+}
+inline tvec<16, float> operator/(const float x, const tvec<16, float>& v)
+{
+	return simd::store(_mm512_div_ps(_mm512_set1_ps(x), simd::load(v)));
+}
+
+template <> inline void tvec<16, float>::operator+=(const tvec<16, float>& v)
+{
+	_mm512_storeu_ps((float*)this, _mm512_add_ps(_mm512_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec<16, float>::operator+=(const float x)
+{
+	_mm512_storeu_ps((float*)this, _mm512_add_ps(_mm512_loadu_ps((const float*)this), _mm512_set1_ps(x)));
+}
+template <> inline void tvec<16, float>::operator-=(const tvec<16, float>& v)
+{
+	_mm512_storeu_ps((float*)this, _mm512_sub_ps(_mm512_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec<16, float>::operator-=(const float x)
+{
+	_mm512_storeu_ps((float*)this, _mm512_sub_ps(_mm512_loadu_ps((const float*)this), _mm512_set1_ps(x)));
+}
+template <> inline void tvec<16, float>::operator*=(const tvec<16, float>& v)
+{
+	_mm512_storeu_ps((float*)this, _mm512_mul_ps(_mm512_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec<16, float>::operator*=(const float x)
+{
+	_mm512_storeu_ps((float*)this, _mm512_mul_ps(_mm512_loadu_ps((const float*)this), _mm512_set1_ps(x)));
+}
+template <> inline void tvec<16, float>::operator/=(const tvec<16, float>& v)
+{
+	_mm512_storeu_ps((float*)this, _mm512_div_ps(_mm512_loadu_ps((const float*)this), simd::load(v)));
+}
+template <> inline void tvec<16, float>::operator/=(const float x)
+{
+	_mm512_storeu_ps((float*)this, _mm512_div_ps(_mm512_loadu_ps((const float*)this), _mm512_set1_ps(x)));
+}
+// The zero-masked forms, the plain ones start from an undefined register and GCC warns about it.
+template <> inline tvec<16, float> tvec<16, float>::operator&&(const tvec<16, float>& v) const
+{
+	return simd::store(_mm512_maskz_min_ps(0xFFFF, simd::load(*this), simd::load(v)));
+}
+template <> inline tvec<16, float> tvec<16, float>::operator||(const tvec<16, float>& v) const
+{
+	return simd::store(_mm512_maskz_max_ps(0xFFFF, simd::load(*this), simd::load(v)));
+}
+
+inline float dot(const tvec<16, float>& v0, const tvec<16, float>& v1)
+{
+	__m512d d = _mm512_castps_pd(_mm512_mul_ps(simd::load(v0), simd::load(v1)));
+	__m256 h = _mm256_add_ps(_mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, d, 0)), _mm256_castpd_ps(_mm512_maskz_extractf64x4_pd(0xF, d, 1)));
+	__m128 q = _mm_add_ps(_mm256_castps256_ps128(h), _mm256_extractf128_ps(h, 1));
+	q = _mm_add_ps(q, _mm_movehl_ps(q, q));
+	return _mm_cvtss_f32(_mm_add_ss(q, _mm_movehdup_ps(q)));
+}
+inline float magnitude(const tvec<16, float>& v)
+{
+	return sqrtf(dot(v, v));
+}
+inline float distance(const tvec<16, float>& v0, const tvec<16, float>& v1)
+{
+	return magnitude(v0 - v1);
+}
+inline tvec<16, float> normalize(const tvec<16, float>& v)
+{
+	float m = magnitude(v);
+	return m == 0.0f ? tvec<16, float>() : v / m;
+}
+#endif
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,521 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+#include <gmath.hpp>
+
+namespace gmath
+{
+
+inline void* alignedAlloc(const size_t bytes)
+{
+#if defined(_MSC_VER)
+	return _aligned_malloc(bytes, 64);
+#else
+	void* p = 0;
+	return posix_memalign(&p, 64, bytes) == 0 ? p : 0;
+#endif
+}
+inline void alignedFree(void* p)
+{
+#if defined(_MSC_VER)
+	_aligned_free(p);
+#else
+	free(p);
+#endif
+}
+
+#if !(defined(tvec3stream) || defined(tvec4stream) || defined(vec3stream) || defined(vec4stream))
+template <typename T, int N> class tvecstream
+{
+public:
+
+	tvecstream() : _count(0), _capacity(0), _data(0) {}
+	explicit tvecstream(const int count) : _count(0), _capacity(0), _data(0)
+	{
+		this->resize(count);
+	}
+	tvecstream(const tvecstream<T, N>& s) : _count(0), _capacity(0), _data(0)
+	{
+		*this = s;
+	}
+	~tvecstream()
+	{
+		this->clear();
+	}
+
+	void resize(const int count)
+	{
+		if (count < 1)
+		{
+			if (this->_data != 0)
+			{
+				alignedFree(this->_data);
+			}
+
+			this->_count = 0;
+			this->_capacity = 0;
+			this->_data = 0;
+			return;
+		}
+
+		if (count <= this->_capacity)
+		{
+			this->_count = count;
+			return;
+		}
+
+		const int capacity = (count + 15) & ~15;
+		T* clean = (T*)alignedAlloc(sizeof(T) * capacity * N);
+		if (clean == 0)
+		{
+			throw std::bad_alloc();
+		}
+
+		memset(clean, 0, sizeof(T) * capacity * N);
+		if (this->_data != 0)
+		{
+			for (int k = 0; k < N; k++)
+			{
+				memcpy(clean + (capacity * k), this->_data + (this->_capacity * k), sizeof(T) * this->_count);
+			}
+
+			alignedFree(this->_data);
+		}
+
+		this->_count = count;
+		this->_capacity = capacity;
+		this->_data = clean;
+	}
+	void clear()
+	{
+		this->resize(0);
+	}
+
+	T* component(const int index) const
+	{
+		return this->_data + (this->_capacity * (index % N));
+	}
+	T* x() const
+	{
+		return this->component(0);
+	}
+	T* y() const
+	{
+		return this->component(1);
+	}
+	T* z() const
+	{
+		return this->component(2);
+	}
+	T* w() const
+	{
+		return this->component(3);
+	}
+
+	const int count() const
+	{
+		return this->_count;
+	}
+	const int capacity() const
+	{
+		return this->_capacity;
+	}
+	const int length() const
+	{
+		return N;
+	}
+
+	void operator=(const tvecstream<T, N>& s)
+	{
+		this->resize(s._count);
+		for (int k = 0; k < N; k++)
+		{
+			memcpy(this->component(k), s.component(k), sizeof(T) * s._count);
+		}
+	}
+
+private:
+
+	int _count;
+	int _capacity;
+	T* _data;
+
+};
+
+template <typename T> class tvec3stream : public tvecstream<T, 3>
+{
+public:
+
+	tvec3stream() : tvecstream<T, 3>() {}
+	explicit tvec3stream(const int count) : tvecstream<T, 3>(count) {}
+	tvec3stream(const tvec3<T>* v, const int count) : tvecstream<T, 3>()
+	{
+		this->gather(v, count);
+	}
+
+	void gather(const tvec3<T>* v, const int count)
+	{
+		this->resize(count);
+		T* x = this->x();
+		T* y = this->y();
+		T* z = this->z();
+		for (int i = 0; i < count; i++)
+		{
+			x[i] = v[i].x;
+			y[i] = v[i].y;
+			z[i] = v[i].z;
+		}
+	}
+	void scatter(tvec3<T>* v) const
+	{
+		const T* x = this->x();
+		const T* y = this->y();
+		const T* z = this->z();
+		for (int i = 0; i < this->count(); i++)
+		{
+			v[i].x = x[i];
+			v[i].y = y[i];
+			v[i].z = z[i];
+		}
+	}
+
+	tvec3<T> get(const int index) const
+	{
+		return tvec3<T>(this->x()[index], this->y()[index], this->z()[index]);
+	}
+	void set(const int index, const tvec3<T>& v)
+	{
+		this->x()[index] = v.x;
+		this->y()[index] = v.y;
+		this->z()[index] = v.z;
+	}
+
+};
+
+template <typename T> class tvec4stream : public tvecstream<T, 4>
+{
+public:
+
+	tvec4stream() : tvecstream<T, 4>() {}
+	explicit tvec4stream(const int count) : tvecstream<T, 4>(count) {}
+	tvec4stream(const tvec4<T>* v, const int count) : tvecstream<T, 4>()
+	{
+		this->gather(v, count);
+	}
+
+	void gather(const tvec4<T>* v, const int count)
+	{
+		this->resize(count);
+		T* x = this->x();
+		T* y = this->y();
+		T* z = this->z();
+		T* w = this->w();
+		for (int i = 0; i < count; i++)
+		{
+			x[i] = v[i].x;
+			y[i] = v[i].y;
+			z[i] = v[i].z;
+			w[i] = v[i].w;
+		}
+	}
+	void scatter(tvec4<T>* v) const
+	{
+		const T* x = this->x();
+		const T* y = this->y();
+		const T* z = this->z();
+		const T* w = this->w();
+		for (int i = 0; i < this->count(); i++)
+		{
+			v[i].x = x[i];
+			v[i].y = y[i];
+			v[i].z = z[i];
+			v[i].w = w[i];
+		}
+	}
+
+	tvec4<T> get(const int index) const
+	{
+		return tvec4<T>(this->x()[index], this->y()[index], this->z()[index], this->w()[index]);
+	}
+	void set(const int index, const tvec4<T>& v)
+	{
+		this->x()[index] = v.x;
+		this->y()[index] = v.y;
+		this->z()[index] = v.z;
+		this->w()[index] = v.w;
+	}
+
+};
+
+namespace stream
+{
+
+template <typename L, typename T, int N> inline int dot(int i, const tvecstream<T, N>& v0, const tvecstream<T, N>& v1, T* out)
+{
+	for (; i + L::width <= v0.count(); i += L::width)
+	{
+		L r = L::load(v0.x() + i) * L::load(v1.x() + i);
+		for (int k = 1; k < N; k++)
+		{
+			r = madd(L::load(v0.component(k) + i), L::load(v1.component(k) + i), r);
+		}
+
+		r.store(out + i);
+	}
+
+	return i;
+}
+template <typename L, typename T, int N> inline int magnitude(int i, const tvecstream<T, N>& v, T* out)
+{
+	for (; i + L::width <= v.count(); i += L::width)
+	{
+		L x = L::load(v.x() + i);
+		L r = x * x;
+		for (int k = 1; k < N; k++)
+		{
+			x = L::load(v.component(k) + i);
+			r = madd(x, x, r);
+		}
+
+		sqrt(r).store(out + i);
+	}
+
+	return i;
+}
+template <typename L, typename T, int N> inline int distance(int i, const tvecstream<T, N>& v0, const tvecstream<T, N>& v1, T* out)
+{
+	for (; i + L::width <= v0.count(); i += L::width)
+	{
+		L x = L::load(v0.x() + i) - L::load(v1.x() + i);
+		L r = x * x;
+		for (int k = 1; k < N; k++)
+		{
+			x = L::load(v0.component(k) + i) - L::load(v1.component(k) + i);
+			r = madd(x, x, r);
+		}
+
+		sqrt(r).store(out + i);
+	}
+
+	return i;
+}
+template <typename L, int N> inline void normalize(L* x)
+{
+	L r = x[0] * x[0];
+	for (int k = 1; k < N; k++)
+	{
+		r = madd(x[k], x[k], r);
+	}
+
+	L m = sqrt(r);
+	L zero((typename L::type)0);
+	typename L::mask degenerate = m == zero;
+	for (int k = 0; k < N; k++)
+	{
+		x[k] = select(degenerate, zero, x[k] / m);
+	}
+}
+template <typename L, typename T, int N> inline int normalize(int i, const tvecstream<T, N>& v, tvecstream<T, N>& out)
+{
+	for (; i + L::width <= v.count(); i += L::width)
+	{
+		L x[N];
+		for (int k = 0; k < N; k++)
+		{
+			x[k] = L::load(v.component(k) + i);
+		}
+
+		normalize<L, N>(x);
+		for (int k = 0; k < N; k++)
+		{
+			x[k].store(out.component(k) + i);
+		}
+	}
+
+	return i;
+}
+template <typename L, typename T, int N> inline int lerp(int i, const tvecstream<T, N>& v0, const tvecstream<T, N>& v1, const T t, tvecstream<T, N>& out)
+{
+	const L s(t);
+	for (; i + L::width <= v0.count(); i += L::width)
+	{
+		for (int k = 0; k < N; k++)
+		{
+			L x = L::load(v0.component(k) + i);
+			madd(L::load(v1.component(k) + i) - x, s, x).store(out.component(k) + i);
+		}
+	}
+
+	return i;
+}
+template <typename L, typename T, int N> inline int clamp(int i, const tvecstream<T, N>& v, const T min, const T max, tvecstream<T, N>& out)
+{
+	const L lo(min);
+	const L hi(max);
+	for (; i + L::width <= v.count(); i += L::width)
+	{
+		for (int k = 0; k < N; k++)
+		{
+			L x = L::load(v.component(k) + i);
+			select(x < lo, lo, simd::min(hi, x)).store(out.component(k) + i);
+		}
+	}
+
+	return i;
+}
+template <typename L, typename T, int N> inline int select(int i, const unsigned int* mask, const tvecstream<T, N>& v0, const tvecstream<T, N>& v1, tvecstream<T, N>& out)
+{
+	for (; i + L::width <= v0.count(); i += L::width)
+	{
+		typename L::mask m = L::expand((int)(mask[i >> 5] >> (i & 31)));
+		for (int k = 0; k < N; k++)
+		{
+			select(m, L::load(v0.component(k) + i), L::load(v1.component(k) + i)).store(out.component(k) + i);
+		}
+	}
+
+	return i;
+}
+template <typename L, typename T> inline int cross(int i, const tvecstream<T, 3>& v0, const tvecstream<T, 3>& v1, tvecstream<T, 3>& out)
+{
+	for (; i + L::width <= v0.count(); i += L::width)
+	{
+		L x0 = L::load(v0.x() + i);
+		L y0 = L::load(v0.y() + i);
+		L z0 = L::load(v0.z() + i);
+		L x1 = L::load(v1.x() + i);
+		L y1 = L::load(v1.y() + i);
+		L z1 = L::load(v1.z() + i);
+		L r[3] = { (y0 * z1) - (z0 * y1), (z0 * x1) - (x0 * z1), (x0 * y1) - (y0 * x1) };
+		normalize<L, 3>(r);
+		r[0].store(out.x() + i);
+		r[1].store(out.y() + i);
+		r[2].store(out.z() + i);
+	}
+
+	return i;
+}
+template <typename L, typename T> inline int reflect(int i, const tvecstream<T, 3>& v, const tvecstream<T, 3>& n, tvecstream<T, 3>& out)
+{
+	const L two((T)2);
+	for (; i + L::width <= v.count(); i += L::width)
+	{
+		L x0 = L::load(v.x() + i);
+		L y0 = L::load(v.y() + i);
+		L z0 = L::load(v.z() + i);
+		L x1 = L::load(n.x() + i);
+		L y1 = L::load(n.y() + i);
+		L z1 = L::load(n.z() + i);
+		L d = madd(z1, z0, madd(y1, y0, x1 * x0)) * two;
+		L r[3] = { (x1 * d) - x0, (y1 * d) - y0, (z1 * d) - z0 };
+		normalize<L, 3>(r);
+		r[0].store(out.x() + i);
+		r[1].store(out.y() + i);
+		r[2].store(out.z() + i);
+	}
+
+	return i;
+}
+template <typename L, typename T> inline int refract(int i, const tvecstream<T, 3>& v, const tvecstream<T, 3>& n, const T theta, tvecstream<T, 3>& out)
+{
+	const L one((T)1);
+	const L zero((T)0);
+	const L eta(theta);
+	for (; i + L::width <= v.count(); i += L::width)
+	{
+		L x0 = L::load(v.x() + i);
+		L y0 = L::load(v.y() + i);
+		L z0 = L::load(v.z() + i);
+		L x1 = L::load(n.x() + i);
+		L y1 = L::load(n.y() + i);
+		L z1 = L::load(n.z() + i);
+		L d = madd(z1, z0, madd(y1, y0, x1 * x0));
+		L k = one - (eta * eta * (one - (d * d)));
+		typename L::mask internal = k < zero;
+		L s = madd(eta, d, sqrt(max(k, zero)));
+		L r[3] = { (eta * x0) - (s * x1), (eta * y0) - (s * y1), (eta * z0) - (s * z1) };
+		normalize<L, 3>(r);
+		select(internal, zero, r[0]).store(out.x() + i);
+		select(internal, zero, r[1]).store(out.y() + i);
+		select(internal, zero, r[2]).store(out.z() + i);
+	}
+
+	return i;
+}
+
+}
+
+template <typename T, int N> inline void dot(const tvecstream<T, N>& v0, const tvecstream<T, N>& v1, T* out)
+{
+	int i = stream::dot<typename simd::widest<T>::type>(0, v0, v1, out);
+	stream::dot<simd::lane<T> >(i, v0, v1, out);
+}
+template <typename T, int N> inline void magnitude(const tvecstream<T, N>& v, T* out)
+{
+	int i = stream::magnitude<typename simd::widest<T>::type>(0, v, out);
+	stream::magnitude<simd::lane<T> >(i, v, out);
+}
+template <typename T, int N> inline void distance(const tvecstream<T, N>& v0, const tvecstream<T, N>& v1, T* out)
+{
+	int i = stream::distance<typename simd::widest<T>::type>(0, v0, v1, out);
+	stream::distance<simd::lane<T> >(i, v0, v1, out);
+}
+template <typename T, int N> inline void normalize(const tvecstream<T, N>& v, tvecstream<T, N>& out)
+{
+	out.resize(v.count());
+	int i = stream::normalize<typename simd::widest<T>::type>(0, v, out);
+	stream::normalize<simd::lane<T> >(i, v, out);
+}
+template <typename T, int N> inline void lerp(const tvecstream<T, N>& v0, const tvecstream<T, N>& v1, const T t, tvecstream<T, N>& out)
+{
+	out.resize(v0.count());
+	int i = stream::lerp<typename simd::widest<T>::type>(0, v0, v1, truth(t), out);
+	stream::lerp<simd::lane<T> >(i, v0, v1, truth(t), out);
+}
+template <typename T, int N> inline void clamp(const tvecstream<T, N>& v, const T min, const T max, tvecstream<T, N>& out)
+{
+	out.resize(v.count());
+	int i = stream::clamp<typename simd::widest<T>::type>(0, v, min, max, out);
+	stream::clamp<simd::lane<T> >(i, v, min, max, out);
+}
+// Element i of out is v0[i] where bit (i % 32) of mask[i / 32] is set and v1[i] where it is not,
+// which is the layout cullSpheres and cullBoxes write.
+template <typename T, int N> inline void select(const unsigned int* mask, const tvecstream<T, N>& v0, const tvecstream<T, N>& v1, tvecstream<T, N>& out)
+{
+	out.resize(v0.count());
+	int i = stream::select<typename simd::widest<T>::type>(0, mask, v0, v1, out);
+	stream::select<simd::lane<T> >(i, mask, v0, v1, out);
+}
+template <typename T> inline void cross(const tvecstream<T, 3>& v0, const tvecstream<T, 3>& v1, tvecstream<T, 3>& out)
+{
+	out.resize(v0.count());
+	int i = stream::cross<typename simd::widest<T>::type>(0, v0, v1, out);
+	stream::cross<simd::lane<T> >(i, v0, v1, out);
+}
+template <typename T> inline void reflect(const tvecstream<T, 3>& v, const tvecstream<T, 3>& n, tvecstream<T, 3>& out)
+{
+	out.resize(v.count());
+	int i = stream::reflect<typename simd::widest<T>::type>(0, v, n, out);
+	stream::reflect<simd::lane<T> >(i, v, n, out);
+}
+template <typename T> inline void refract(const tvecstream<T, 3>& v, const tvecstream<T, 3>& n, const T theta, tvecstream<T, 3>& out)
+{
+	out.resize(v.count());
+	int i = stream::refract<typename simd::widest<T>::type>(0, v, n, theta, out);
+	stream::refract<simd::lane<T> >(i, v, n, theta, out);
+}
+
+typedef tvec3stream<float> vec3stream;
+typedef tvec4stream<float> vec4stream;
+#endif
+
+}
+
+#endif
\ No newline at end of file
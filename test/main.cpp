@@ -2,15 +2,1281 @@
 #include <fuzzy.hpp>
 #include <ray.hpp>
 #include <box.hpp>
+#include <gmath.hpp>
+#include <batch.hpp>
+#include <stream.hpp>
+#include <projector.hpp>
+#include <affine.hpp>
+#include <hierarchy.hpp>
+#include <frustum.hpp>
+#include <dispatch.hpp>
+#include <fixed.hpp>
+#include <half.hpp>
+#include <intersect.hpp>
+#include <packet.hpp>
+#include <bvh.hpp>
+#include <aabb.hpp>
+#include <broadphase.hpp>
 
 #include <encode.hpp>
 #include <random.hpp>
 #include <delegate.hpp>
 
+#include <vector>
+
 //using namespace gmath;
 
+static bool equivalent(const float x, const float y)
+{
+	float d = x - y;
+	return (d < 0.0f ? -d : d) <= 1e-4f * (1.0f + (y < 0.0f ? -y : y));
+}
+static bool equivalent(const double x, const double y, const double e)
+{
+	double d = x - y;
+	return (d < 0.0 ? -d : d) <= e * (1.0 + (y < 0.0 ? -y : y));
+}
+static bool equivalent(const gmath::tvec3<double>& v0, const gmath::tvec3<double>& v1, const double e)
+{
+	return equivalent(v0.x, v1.x, e) && equivalent(v0.y, v1.y, e) && equivalent(v0.z, v1.z, e);
+}
+static bool equivalent(const gmath::tmat4x4<double>& m0, const gmath::tmat4x4<double>& m1, const double e)
+{
+	bool r = true;
+	for (int i = 0; i < 4; i++)
+	{
+		r = r && equivalent(gmath::tvec3<double>(m0._columns[i]), gmath::tvec3<double>(m1._columns[i]), e) && equivalent(m0._columns[i].w, m1._columns[i].w, e);
+	}
+
+	return r;
+}
+static bool equivalent(const gmath::vec3& v0, const gmath::vec3& v1)
+{
+	return equivalent(v0.x, v1.x) && equivalent(v0.y, v1.y) && equivalent(v0.z, v1.z);
+}
+static bool equivalent(const gmath::vec4& v0, const gmath::vec4& v1)
+{
+	return equivalent(v0.x, v1.x) && equivalent(v0.y, v1.y) && equivalent(v0.z, v1.z) && equivalent(v0.w, v1.w);
+}
+static bool equivalent(const gmath::quat& q0, const gmath::quat& q1)
+{
+	// q and -q are the same rotation
+	float d = (q0.x * q1.x) + (q0.y * q1.y) + (q0.z * q1.z) + (q0.w * q1.w);
+	return equivalent(d < 0.0f ? -d : d, 1.0f);
+}
+static bool equivalent(const gmath::mat4& m0, const gmath::mat4& m1)
+{
+	return equivalent(m0._columns[0], m1._columns[0]) && equivalent(m0._columns[1], m1._columns[1]) && equivalent(m0._columns[2], m1._columns[2]) && equivalent(m0._columns[3], m1._columns[3]);
+}
+
+#if (__cplusplus >= 201402L) || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+// The builders fold in constant evaluation, where csin/ccos/ctan take the series. PI is
+// a float constant, so the builders only match to single precision.
+static constexpr bool cequivalent(const double x, const double y, const double e = 1e-15)
+{
+	return (x - y < 0.0 ? y - x : x - y) <= e * (1.0 + (y < 0.0 ? -y : y));
+}
+static_assert(gmath::csin(0.0) == 0.0 && gmath::ccos(0.0) == 1.0, "csin/ccos");
+static_assert(cequivalent(gmath::csin(0.5), 0.479425538604203) && cequivalent(gmath::ccos(-2.0), -0.416146836547142), "csin/ccos");
+static_assert(cequivalent(gmath::csin(63.0), 0.167355700302807) && cequivalent(gmath::ccos(630.0), -0.110447163899974), "csin/ccos");
+static_assert(cequivalent(gmath::ctan(1.0), 1.5574077246549023), "ctan");
+static_assert(cequivalent(gmath::rotateZ(30.0)._columns[0].y, 0.5, 1e-7) && cequivalent(gmath::rotateX(90.0)._columns[2].y, -1.0, 1e-7), "rotate");
+static_assert(cequivalent(gmath::perspective(90.0, 1.0, 1.0, 10.0)._columns[1].y, 1.0, 1e-7), "perspective");
+static_assert(gmath::translate(1.0, 2.0, 3.0)._columns[3].z == 3.0 && gmath::scale(2.0, 3.0, 4.0)._columns[1].y == 3.0, "translate/scale");
+#endif
+
+static int testSimd()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	vec4 a(1.5f, -2.0f, 3.25f, 0.5f);
+	vec4 b(-0.75f, 4.0f, 2.0f, -8.0f);
+	mat4 m0 = translate(rotate(scale(2.0f, 3.0f, 0.5f), 30.0f, vec3(1.0f, 2.0f, 3.0f)), 4.0f, -5.0f, 6.0f);
+	mat4 m1 = perspective(60.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+
+	failures += !equivalent(a + b, operator+<4, float>(a, b));
+	failures += !equivalent(a - b, operator-<4, float>(a, b));
+	failures += !equivalent(a * b, operator*<4, float>(a, b));
+	failures += !equivalent(a / b, operator/<4, float>(a, b));
+	failures += !equivalent(a * 3.0f, operator*<4, float>(a, 3.0f));
+	failures += !equivalent(3.0f - a, operator-<4, float>(3.0f, a));
+	failures += !equivalent(dot(a, b), dot<4, float>(a, b));
+	failures += !equivalent(magnitude(a), magnitude<4, float>(a));
+	failures += !equivalent(normalize(a), normalize<4, float>(a));
+	failures += !equivalent(normalize(vec4(0.0f)), vec4(0.0f));
+	failures += !equivalent(m0 * a, operator*<float>(m0, a));
+	failures += !equivalent(a * m0, operator*<float>(a, m0));
+	failures += !equivalent(m0 * m1, operator*<float>(m0, m1));
+	failures += !equivalent(m1 * m0, operator*<float>(m1, m0));
+
+	vec4 c = a;
+	c += b;
+	c *= 2.0f;
+	failures += !equivalent(c, operator*<4, float>(operator+<4, float>(a, b), 2.0f));
+
+	failures += bitmask(lessThan(a, b)) != bitmask(lessThan<4, float>(a, b)) || bitmask(lessThan(a, b)) != 0x2;
+	failures += bitmask(greaterThanEqual(a, b)) != bitmask(greaterThanEqual<4, float>(a, b));
+	failures += bitmask(notEqual(a, a)) != 0 || !all(equal(b, b)) || any(greaterThan(a, a));
+	failures += !equivalent(select(lessThan(a, b), a, b), select<4, float>(lessThan<4, float>(a, b), a, b));
+	failures += !equivalent(clamp(a, vec4(-1.0f), vec4(1.0f)), vec4(1.0f, -1.0f, 1.0f, 0.5f));
+	failures += !equivalent(sign(a), sign<4, float>(a));
+
+	const tvec4<double> da(a);
+	const tvec4<double> db(b);
+	const tmat4x4<double> dm = translate(rotate(scale(2.0, 3.0, 0.5), 30.0, tvec3<double>(1.0, 2.0, 3.0)), 4.0, -5.0, 6.0);
+	double determinant;
+	failures += !equivalent(vec4((da * db) + 1.0), vec4(operator+<4, double>(operator*<4, double>(da, db), 1.0)));
+	failures += !equivalent((float)dot(da, db), (float)dot<4, double>(da, db));
+	failures += !equivalent(vec4(normalize(da)), vec4(normalize<4, double>(da)));
+	failures += !equivalent(vec4(dm * da), vec4(operator*<double>(dm, da)));
+	failures += !equivalent(vec4(da * dm), vec4(operator*<double>(da, dm)));
+	failures += !equivalent(vec4((dm * dm) * db), vec4(operator*<double>(operator*<double>(dm, dm), db)));
+	failures += !equivalent(vec4(inverse(dm) * db), vec4(inverse<double>(dm, determinant) * db));
+
+	float lanes[16];
+	for (int i = 0; i < 16; i++)
+	{
+		lanes[i] = ((float)i * 0.75f) - 4.0f;
+	}
+	const vec16 w0(lanes);
+	const vec16 w1 = vec16(2.5f) - w0;
+	const vec16 w2 = (w0 * w1) + 1.0f;
+	const vec16 w3 = lerp(w0, w1, 0.25f);
+	float d = 0.0f;
+	for (int i = 0; i < 16; i++)
+	{
+		const float x = lanes[i] * (2.5f - lanes[i]);
+		d += x;
+		failures += !equivalent(w2[i], x + 1.0f);
+		failures += !equivalent(w3[i], lanes[i] + ((2.5f - (2.0f * lanes[i])) * 0.25f));
+		failures += (w0 && w1)[i] != min(lanes[i], 2.5f - lanes[i]) || (w0 || w1)[i] != max(lanes[i], 2.5f - lanes[i]);
+	}
+	failures += !equivalent(dot(w0, w1), d);
+	failures += !((w0 && w1) <= (w0 || w1));
+	vec16 w4 = w0;
+	w4 -= w1;
+	w4 *= 0.5f;
+	failures += !(w4 == (w0 - w1) * 0.5f);
+	const vec8 v0(lanes);
+	failures += !equivalent(magnitude(normalize(v0)), 1.0f);
+	failures += !(normalize(vec8()) == vec8());
+	failures += !equivalent(distance(v0, vec8()), magnitude(v0));
+
+	return failures;
+}
+
+static int testBatch()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	const int count = 19;
+	mat4 m[count];
+	mat4 inverses[count];
+	mat4 products[count];
+	unsigned char singular[count];
+	for (int i = 0; i < count; i++)
+	{
+		float f = (float)i;
+		m[i] = translate(rotate(scale(1.0f + f, 2.0f, 0.5f), f * 20.0f, vec3(1.0f, 2.0f, 3.0f)), f, -f, 1.0f);
+	}
+	m[5] = perspective(60.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+	m[11] = scale(1.0f, 0.0f, 1.0f);
+
+	inverseBatch(m, inverses, singular, count, 1e-6f);
+	multiplyBatch(m, inverses, products, count);
+	for (int i = 0; i < count; i++)
+	{
+		failures += singular[i] != (i == 11 ? 1 : 0);
+		failures += !equivalent(inverses[i], i == 11 ? mat4() : inverse(m[i]));
+		failures += !equivalent(products[i], m[i] * inverses[i]);
+	}
+
+	// a kernel throwing on the calling thread passes the exception on once the workers are joined
+	std::vector<int> done(4 * GMATH_BATCH_GRAIN, 0);
+	bool thrown = false;
+	try
+	{
+		parallel(done.size(), 2, [&](const size_t begin, const size_t end)
+		{
+			if (begin > 0)
+			{
+				throw 1;
+			}
+			std::fill(done.begin() + begin, done.begin() + end, 1);
+		});
+	}
+	catch (const int)
+	{
+		thrown = true;
+	}
+	failures += !thrown || done[0] != 1 || done[done.size() / 2] != 0;
+
+	return failures;
+}
+
+// The AVX double paths against the scalar templates, compared in double.
+static int testBatchDouble()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	const int count = 19;
+	const tmat4x4<double> m = translate(rotate(scale(2.0, 3.0, 0.5), 30.0, tvec3<double>(1.0, 2.0, 3.0)), 4.0, -5.0, 6.0);
+	const tmat4x4<double> p = perspective(60.0, 4.0 / 3.0, 0.1, 100.0) * translate(tmat4x4<double>(), 0.0, 0.0, -8.0);
+	// far enough from the origin that float could not hold the offsets
+	const tvec3<double> origin(6378137.25, -1234567.5, 4.0e6);
+	tvec3<double> offsets[count];
+	tvec3<double> world[count];
+	tvec3<double> out[count];
+	tvec3<double> expected[count];
+	tvec3<float> local[count];
+	tvec3<float> localExpected[count];
+	tmat4x4<double> matrices[count];
+	tmat4x4<double> inverses[count];
+	unsigned char singular[count];
+	for (int i = 0; i < count; i++)
+	{
+		double f = (double)i;
+		offsets[i] = tvec3<double>(sin(f) * 3.0, cos(f) * 0.001, (f * 0.37) - 2.0);
+		world[i] = origin + offsets[i];
+		matrices[i] = translate(rotate(scale(1.0 + f, 2.0, 0.5), f * 20.0, tvec3<double>(1.0, 2.0, 3.0)), f, -f, 1.0);
+	}
+	matrices[5] = perspective(60.0, 4.0 / 3.0, 0.1, 100.0);
+	matrices[11] = scale(1.0, 0.0, 1.0);
+
+	transformPoints(m, world, out, count);
+	transformPoints<double>(m, world, expected, count);
+	for (int i = 0; i < count; i++)
+	{
+		failures += !equivalent(out[i], expected[i], 1e-14);
+	}
+
+	transformProjected(p, offsets, out, count);
+	transformProjected<double>(p, offsets, expected, count);
+	for (int i = 0; i < count; i++)
+	{
+		failures += !equivalent(out[i], expected[i], 1e-14);
+	}
+
+	rebase(origin, world, local, count);
+	rebase<double>(origin, world, localExpected, count);
+	for (int i = 0; i < count; i++)
+	{
+		failures += local[i].x != localExpected[i].x || local[i].y != localExpected[i].y || local[i].z != localExpected[i].z;
+		failures += !equivalent(tvec3<double>(local[i]), offsets[i], 1e-6);
+	}
+
+	inverseBatch(matrices, inverses, singular, count, 1e-12);
+	for (int i = 0; i < count; i++)
+	{
+		double determinant;
+		failures += singular[i] != (i == 11 ? 1 : 0);
+		failures += !equivalent(inverses[i], i == 11 ? tmat4x4<double>() : inverse<double>(matrices[i], determinant), 1e-12);
+	}
+
+	return failures;
+}
+
+static int testStream()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	// an odd count runs both the SIMD body and the scalar tail
+	const int count = 37;
+	vec3 a[count];
+	vec3 b[count];
+	for (int i = 0; i < count; i++)
+	{
+		float f = (float)i;
+		a[i] = vec3(sinf(f) * 3.0f, cosf(f * 0.5f), f * 0.25f - 4.0f);
+		b[i] = vec3(cosf(f * 1.5f), sinf(f * 0.3f) * 2.0f, 1.0f);
+	}
+	a[3] = vec3(0.0f);
+
+	vec3stream s0(a, count);
+	vec3stream s1(b, count);
+	vec3stream out;
+	float dots[count];
+	float lengths[count];
+	float distances[count];
+	dot(s0, s1, dots);
+	magnitude(s0, lengths);
+	distance(s0, s1, distances);
+	normalize(s0, out);
+	failures += out.count() != count || s0.capacity() % 16 != 0;
+	for (int i = 0; i < count; i++)
+	{
+		failures += !equivalent(s0.get(i), a[i]);
+		failures += !equivalent(dots[i], dot(a[i], b[i])) || !equivalent(lengths[i], magnitude(a[i])) || !equivalent(distances[i], distance(a[i], b[i]));
+		failures += !equivalent(out.get(i), i == 3 ? vec3(0.0f) : normalize(a[i]));
+	}
+
+	cross(s0, s1, out);
+	for (int i = 0; i < count; i++)
+	{
+		failures += !equivalent(out.get(i), i == 3 ? vec3(0.0f) : normalize(cross(a[i], b[i])));
+	}
+
+	clamp(s0, -1.0f, 0.5f, out);
+	for (int i = 0; i < count; i++)
+	{
+		failures += !equivalent(out.get(i), clamp(a[i], -1.0f, 0.5f));
+	}
+
+	const unsigned int mask[2] = { 0x9A3C5F21u, 0x15u };
+	select(mask, s0, s1, out);
+	failures += out.count() != count;
+	for (int i = 0; i < count; i++)
+	{
+		failures += !equivalent(out.get(i), ((mask[i >> 5] >> (i & 31)) & 1) != 0 ? a[i] : b[i]);
+	}
+
+	vec3stream copy(s0);
+	copy.set(0, vec3(9.0f));
+	vec3 back[count];
+	copy.scatter(back);
+	failures += !equivalent(back[0], vec3(9.0f)) || !equivalent(back[1], a[1]) || !equivalent(s0.get(0), a[0]);
+
+	// a count never turns into a stream by accident
+	failures += std::is_convertible<int, vec3stream>::value || std::is_convertible<int, vec4stream>::value;
+	return failures;
+}
+
+static int testProjector()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	mat4 model = translate(rotate(scale(1.5f, 1.0f, 0.75f), 25.0f, vec3(0.0f, 1.0f, 0.0f)), 0.5f, -1.0f, -6.0f);
+	mat4 proj = perspective(60.0f, 4.0f / 3.0f, 0.5f, 50.0f);
+	projector p(model, proj);
+	failures += !equivalent(p.combined(), proj * model) || !equivalent(p.inverse(), inverse(proj * model));
+
+	// the cached matrices follow setModel
+	model = translate(model, 1.0f, 2.0f, 0.0f);
+	p.setModel(model);
+	failures += !equivalent(p.inverse(), inverse(proj * model));
+
+	const int count = 21;
+	vec3 points[count];
+	vec3 window[count];
+	vec3 back[count];
+	for (int i = 0; i < count; i++)
+	{
+		float f = (float)i;
+		points[i] = vec3(sinf(f) * 2.0f, cosf(f * 0.7f), sinf(f * 0.3f));
+	}
+	p.project(points, window, count);
+	p.unproject(window, back, count);
+	for (int i = 0; i < count; i++)
+	{
+		failures += !equivalent(window[i], project(points[i], model, proj)) || !equivalent(p.project(points[i]), window[i]);
+		failures += !equivalent(back[i], unproject(window[i], model, proj));
+		failures += !equivalent(p.unproject(window[i]), points[i]);
+	}
+
+	// a depth map unprojects through pixel centers
+	Map<float> depth(7, 5);
+	for (int y = 0; y < 5; y++)
+	{
+		for (int x = 0; x < 7; x++)
+		{
+			depth.get(x, y) = 0.3f + ((float)(x + y) * 0.05f);
+		}
+	}
+	Map<vec3> world;
+	p.unproject(depth, world);
+	failures += world.width() != 7 || world.height() != 5;
+	for (int y = 0; y < 5; y++)
+	{
+		for (int x = 0; x < 7; x++)
+		{
+			vec3 w(((float)x + 0.5f) / 7.0f, ((float)y + 0.5f) / 5.0f, depth.get(x, y));
+			failures += !equivalent(world.get(x, y), unproject(w, model, proj));
+		}
+	}
+
+	return failures;
+}
+
+static int testAffine()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	const mat4 t = translate(1.0f, -2.0f, 3.0f);
+	const mat4 r = rotate(35.0f, vec3(1.0f, 2.0f, 3.0f));
+	const mat4 s = scale(2.0f, 3.0f, 0.5f);
+	const mat4 orders[4] = { t * r * s, t * s * r, s * r * t, r * t };
+	const vec3 p(0.5f, -1.25f, 2.0f);
+	for (int i = 0; i < 4; i++)
+	{
+		// conversion, transforms and the general inverse agree with tmat4x4 for every order
+		const affine3 a(orders[i]);
+		const vec4 q = orders[i] * vec4(p, 1.0f);
+		failures += !equivalent((mat4)a, orders[i]);
+		failures += !equivalent(a * p, vec3(q.x, q.y, q.z)) || !equivalent(vec4(transformVector(a, p), 0.0f), orders[i] * vec4(p, 0.0f));
+		failures += !equivalent(determinate(a), i == 3 ? 1.0f : 3.0f);
+		failures += !equivalent((mat4)inverse(a), inverse(orders[i]));
+		failures += !equivalent((mat4)(a * inverse(a)), mat4());
+		failures += !equivalent((mat4)(a * affine3(orders[(i + 1) % 4])), orders[i] * orders[(i + 1) % 4]);
+	}
+
+	// the shortcuts hold for the shapes they are meant for, and the orthogonal one fails on a scale after rotation
+	failures += !equivalent((mat4)inverseOrthogonal(affine3(orders[0])), inverse(orders[0]));
+	failures += equivalent((mat4)inverseOrthogonal(affine3(orders[1])), inverse(orders[1]));
+	failures += !equivalent((mat4)inverseRigid(affine3(orders[3])), inverse(orders[3]));
+
+	return failures;
+}
+
+static int testQuat()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	const vec3 axis(1.0f, 2.0f, -0.5f);
+	const vec3 v(0.3f, -1.5f, 2.0f);
+	const quat q0(40.0f, axis);
+	const quat q1(-75.0f, vec3(0.0f, 1.0f, 1.0f));
+	const vec4 r = rotate(40.0f, axis) * vec4(v, 0.0f);
+	failures += !equivalent((mat4)q0, rotate(40.0f, axis)) || !equivalent(q0 * v, vec3(r.x, r.y, r.z));
+	failures += !equivalent((mat4)(q0 * q1), (mat4)q0 * (mat4)q1);
+	failures += !equivalent(quat((mat4)q1), q1) || !equivalent(inverse(q0) * q0, quat());
+	failures += !equivalent(quat(vec3(0.0f, 30.0f, 0.0f)), quat(30.0f, vec3(0.0f, 1.0f, 0.0f)));
+
+	// the Euler rotate() matches the single axis builders
+	const mat4 m = translate(scale(2.0f, 1.0f, 0.5f), 1.0f, 2.0f, 3.0f);
+	failures += !equivalent(rotate(m, vec3(25.0f, 0.0f, 0.0f)), rotateX(m, 25.0f));
+	failures += !equivalent(rotate(m, vec3(0.0f, 0.0f, -60.0f)), rotateZ(m, -60.0f));
+
+	// slerp and nlerp stay on the arc, take the short way and hit the ends
+	const quat a(10.0f, axis);
+	const quat b(110.0f, axis);
+	failures += !equivalent(slerp(a, b, 0.0f), a) || !equivalent(slerp(a, b, 1.0f), b);
+	failures += !equivalent(slerp(a, b, 0.25f), quat(35.0f, axis)) || !equivalent(slerp(a, -b, 0.25f), quat(35.0f, axis));
+	failures += !equivalent(nlerp(a, b, 0.5f), quat(60.0f, axis)) || !equivalent(nlerp(a, -b, 0.5f), quat(60.0f, axis));
+	failures += !equivalent(magnitude(nlerp(a, b, 0.3f)), 1.0f) || !equivalent(slerp(a, quat(10.01f, axis), 0.5f), quat(10.005f, axis));
+
+	// the batch nlerp agrees with the scalar one across the SIMD body and tail
+	const int count = 11;
+	quat from[count];
+	quat to[count];
+	quat out[count];
+	float t[count];
+	for (int i = 0; i < count; i++)
+	{
+		float f = (float)i;
+		from[i] = quat(f * 20.0f, vec3(1.0f, f, 0.5f));
+		to[i] = quat(-f * 15.0f, vec3(0.0f, 1.0f, f));
+		t[i] = f / (float)count;
+	}
+	nlerp(from, to, t, out, count);
+	for (int i = 0; i < count; i++)
+	{
+		failures += !equivalent(out[i], nlerp(from[i], to[i], t[i]));
+	}
+
+	return failures;
+}
+
+static int testTrig()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	// at runtime the builders go through libm, whatever the standard
+	volatile double angles[] = { 0.3, -2.0, 63.0, 630.0, 1e5 };
+	for (int i = 0; i < 5; i++)
+	{
+		double x = angles[i];
+		failures += csin(x) != ::sin(x) || ccos(x) != ::cos(x) || ctan(x) != ::tan(x);
+	}
+	failures += !equivalent(rotateX(40.0f), rotate(40.0f, vec3(1.0f, 0.0f, 0.0f)));
+
+	return failures;
+}
+
+static int testHierarchy()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	// a chain 0 <- 1 <- 2 and a second child 3 under 0, plus a separate root 4
+	hierarchy h;
+	int root = h.add(-1, vec3(1.0f, 0.0f, 0.0f), quat(30.0f, vec3(0.0f, 1.0f, 0.0f)), vec3(2.0f, 2.0f, 2.0f));
+	int arm = h.add(root, vec3(0.0f, 1.0f, 0.0f), quat(45.0f, vec3(1.0f, 0.0f, 0.0f)), vec3(1.0f, 1.0f, 1.0f));
+	int hand = h.add(arm, vec3(0.0f, 0.0f, 2.0f), quat(), vec3(0.5f, 0.5f, 0.5f));
+	int leg = h.add(root, vec3(0.0f, -1.0f, 0.0f), quat(), vec3(1.0f, 1.0f, 1.0f));
+	int other = h.add(-1, vec3(5.0f, 5.0f, 5.0f), quat(), vec3(1.0f, 1.0f, 1.0f));
+
+	// invalid parents are rejected rather than turned into roots
+	failures += h.add(7) != -1 || h.add(-2) != -1 || h.add(h.size()) != -1 || h.size() != 5;
+	failures += h.depth(hand) != 2 || h.parent(hand) != arm || h.parent(other) != -1;
+
+	failures += h.update() != 5 || h.dirty(root) || h.dirty(hand);
+	failures += !equivalent(h.world(root), h.local(root)) || !equivalent(h.world(other), h.local(other));
+	failures += !equivalent(h.world(hand), h.local(root) * h.local(arm) * h.local(hand));
+	failures += !equivalent(h.world(leg), h.local(root) * h.local(leg));
+	failures += h.update() != 0;
+
+	// a change recomputes the node and what is below it, once per update
+	h.setPosition(arm, vec3(0.0f, 3.0f, 0.0f));
+	h.setScale(hand, vec3(1.0f, 1.0f, 1.0f));
+	failures += !h.dirty(arm) || !h.dirty(hand) || h.dirty(leg);
+	failures += h.update() != 2 || h.update() != 0;
+	failures += !equivalent(h.world(hand), h.local(root) * h.local(arm) * h.local(hand));
+
+	h.setRotation(root, quat(-60.0f, vec3(0.0f, 0.0f, 1.0f)));
+	failures += h.update(4) != 4;
+	failures += !equivalent(h.world(hand), h.local(root) * h.local(arm) * h.local(hand));
+	failures += !equivalent(h.world(leg), h.local(root) * h.local(leg));
+
+	return failures;
+}
+
+template <typename T> static int testCull()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	tviewfrustum<T> f(perspective((T)60, (T)1.5, (T)1, (T)100) * look(tvec3<T>((T)0, (T)2, (T)10), tvec3<T>(), tvec3<T>((T)0, (T)1, (T)0)));
+
+	// full words, a partial word, and chunks split across threads
+	const int count = (64 * 3) + 13;
+	std::vector<tvec4<T> > spheres(count);
+	std::vector<tvec3<T> > min(count), max(count);
+	unsigned int state = 3;
+	for (int i = 0; i < count; i++)
+	{
+		T v[7];
+		for (int k = 0; k < 7; k++)
+		{
+			state = (state * 1664525u) + 1013904223u;
+			v[k] = (T)(state >> 8) / (T)16777216;
+		}
+		tvec3<T> c((v[0] - (T)0.5) * (T)160, (v[1] - (T)0.5) * (T)120, (v[2] * (T)-140) + (T)20);
+		spheres[i] = tvec4<T>(c, v[3] * (T)8);
+		min[i] = c - (tvec3<T>(v[4], v[5], v[6]) * (T)6);
+		max[i] = c + (tvec3<T>(v[6], v[4], v[5]) * (T)6);
+	}
+
+	const int words = (count + 31) / 32;
+	for (unsigned int threads = 1; threads <= 4; threads += 3)
+	{
+		std::vector<unsigned int> sphereBits(words, ~0u), boxBits(words, ~0u);
+		cullSpheres(f, &spheres[0], &sphereBits[0], count, threads);
+		cullBoxes(f, &min[0], &max[0], &boxBits[0], count, threads);
+
+		int visible = 0;
+		for (int i = 0; i < count; i++)
+		{
+			bool sphere = (sphereBits[i >> 5] >> (i & 31)) & 1;
+			bool box = (boxBits[i >> 5] >> (i & 31)) & 1;
+			failures += sphere != f.intersects(spheres[i]) || box != f.intersects(min[i], max[i]);
+			visible += sphere ? 1 : 0;
+		}
+		failures += visible == 0 || visible == count;
+		failures += (sphereBits[words - 1] >> (count & 31)) != 0 || (boxBits[words - 1] >> (count & 31)) != 0;
+	}
+
+	return failures;
+}
+
+static int testDecompose()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	const vec3 t(1.0f, -2.0f, 3.0f);
+	const quat r(50.0f, vec3(1.0f, 2.0f, -1.0f));
+	const vec3 scales[] = {
+		vec3(2.0f, 0.5f, 3.0f), vec3(-2.0f, 0.5f, 3.0f),
+		vec3(0.0f, 0.5f, 3.0f), vec3(2.0f, 0.0f, 3.0f), vec3(2.0f, 0.5f, 0.0f),
+		vec3(0.0f, 0.0f, 3.0f), vec3(2.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 0.0f)
+	};
+	for (int i = 0; i < 8; i++)
+	{
+		mat4 m = compose(t, r, scales[i]);
+		vec3 t1, s1;
+		quat r1;
+		decompose(m, t1, r1, s1);
+
+		// the rotation is a unit quaternion whatever the scale, and the parts rebuild the matrix
+		failures += !equivalent(magnitude(r1), 1.0f) || !equivalent(t1, t);
+		failures += !equivalent(compose(t1, r1, s1), m);
+		failures += !equivalent(vec3(s1.x < 0.0f ? -s1.x : s1.x, s1.y, s1.z), vec3(scales[i].x < 0.0f ? -scales[i].x : scales[i].x, scales[i].y, scales[i].z));
+		if (i < 2)
+		{
+			failures += !equivalent(r1, r) || !equivalent(s1, scales[i]);
+		}
+		else if (i < 5)
+		{
+			// one flat axis is recovered exactly from the other two
+			failures += !equivalent(r1, r);
+		}
+	}
+
+	return failures;
+}
+
+static int testDispatch()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	const int count = 37;
+	mat4 m[count];
+	mat4 reversed[count];
+	mat4 inverses[count];
+	mat4 products[count];
+	vec3 v[count];
+	vec3 points[count];
+	vec3 vectors[count];
+	vec3 normals[count];
+	unsigned char singular[count];
+	for (int i = 0; i < count; i++)
+	{
+		float f = (float)i;
+		m[i] = translate(rotate(scale(1.0f + f, 2.0f, 0.5f), f * 20.0f, vec3(1.0f, 2.0f, 3.0f)), f, -f, 1.0f);
+		v[i] = vec3(f, 1.0f - f, 0.5f * f);
+	}
+	m[5] = perspective(60.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+	m[21] = scale(1.0f, 0.0f, 1.0f);
+	v[0] = vec3(0.0f);
+	for (int i = 0; i < count; i++)
+	{
+		reversed[i] = m[count - 1 - i];
+	}
+
+	const dispatch::level selected = dispatch::selected();
+	for (int l = dispatch::scalar; l <= dispatch::detected(); l++)
+	{
+		failures += dispatch::select((dispatch::level)l) != l;
+		dispatch::transformPoints(m[3], v, points, count);
+		dispatch::transformVectors(m[3], v, vectors, count);
+		dispatch::normalize(v, normals, count);
+		dispatch::inverseBatch(m, inverses, singular, count, 1e-6f);
+		dispatch::multiplyBatch(m, reversed, products, count);
+		for (int i = 0; i < count; i++)
+		{
+			failures += !equivalent(vec4(points[i], 1.0f), m[3] * vec4(v[i], 1.0f));
+			failures += !equivalent(vec4(vectors[i], 0.0f), m[3] * vec4(v[i], 0.0f));
+			failures += !equivalent(vec4(normals[i], 0.0f), vec4(normalize(v[i]), 0.0f));
+			failures += singular[i] != (i == 21 ? 1 : 0);
+			failures += !equivalent(inverses[i], i == 21 ? mat4() : inverse(m[i]));
+			failures += !equivalent(products[i], m[i] * reversed[i]);
+		}
+	}
+	dispatch::select(selected);
+
+	return failures;
+}
+
+static int testFixed()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	// products floor, quotients truncate, the same on every platform
+	failures += (fixed32::bits(-3) * fixed32(0.5)).value != -2;
+	failures += (fixed32(-1) / fixed32(3)).value != -21845;
+	failures += (fixed64::bits(-3) * fixed64(0.5)).value != -2;
+	failures += (fixed64(-1) / fixed64(3)).value != -1431655765LL;
+	failures += sqrt(fixed32(2)).value != 92681;
+	failures += sqrt(fixed64(2)).value != 6074000999LL;
+	failures += fixed32(40000).value != (std::numeric_limits<int>::max)() || fixed32(-40000).value != -(std::numeric_limits<int>::max)() || fixed32(-32768).value != (std::numeric_limits<int>::min)();
+
+	// the root is the floor, around squares and across every table entry
+	unsigned int state = 7;
+	for (int i = 0; i < 4096; i++)
+	{
+		state = (state * 1664525u) + 1013904223u;
+		unsigned long long x = i < 64 ? (unsigned long long)i : ((unsigned long long)state << 32 | (state * 2654435761u)) >> (i & 63);
+		unsigned long long r = fixedpoint::isqrt(x);
+		unsigned long long hi;
+		unsigned long long lo;
+		fixedpoint::wide(r + 1, r + 1, hi, lo);
+		failures += r * r > x || (hi == 0 && lo <= x);
+		failures += fixedpoint::isqrt(r * r) != r || (r > 0 && fixedpoint::isqrt((r * r) - 1) != r - 1);
+	}
+	failures += fixedpoint::isqrt(~0ULL) != 0xFFFFFFFFULL;
+	failures += fixedpoint::root((long long)0x7FFFFFFFFFFFFFFFLL, 32) != (long long)(sqrtl(0x7FFFFFFFFFFFFFFFLL * 4294967296.0L));
+
+	// one reciprocal stays within a step of dividing each component by the length
+	for (int i = 1; i < 200; i++)
+	{
+		tvec3<fixed32> a(fixed32::bits(i * 977), fixed32::bits(-i * i * 13), fixed32::bits(65536 / i));
+		tvec3<fixed32> n = normalize(a);
+		fixed32 l = sqrt(dot(a, a));
+		tvec3<fixed64> b(fixed64(i * 0.37), fixed64(-1.0 / i), fixed64(i * -2.5));
+		tvec3<fixed64> o = normalize(b);
+		fixed64 k = sqrt(dot(b, b));
+		for (int j = 0; j < 3; j++)
+		{
+			int e = (n[j] - (a[j] / l)).value;
+			long long f = (o[j] - (b[j] / k)).value;
+			failures += e < -1 || e > 1 || f < -1 || f > 1;
+		}
+	}
+	failures += normalize(tvec3<fixed32>()).x.value != 0;
+	for (int i = -64; i <= 64; i++)
+	{
+		fixed64 a(i * 0.1);
+		failures += !equivalent((float)sin(a), sinf(i * 0.1f));
+		failures += !equivalent((float)cos(fixed32(i * 0.1)), cosf(i * 0.1f));
+	}
+
+	tmat4x4<fixed32> m = rotate(translate(tmat4x4<fixed32>(), fixed32(1), fixed32(2), fixed32(3)), fixed32(30), tvec3<fixed32>(fixed32(0), fixed32(1), fixed32(0)));
+	tvec3<fixed32> in[7];
+	tvec3<fixed32> out[7];
+	tvec3<fixed32> reference[7];
+	for (int i = 0; i < 7; i++)
+	{
+		in[i] = tvec3<fixed32>(fixed32(i * 0.5), fixed32(-i), fixed32(1.25));
+	}
+	transformPoints(m, in, out, 7);
+	transformPoints<fixed32>(m, in, reference, 7);
+	failures += memcmp(out, reference, sizeof(out)) != 0;
+
+	tmat4x4<fixed32> p = perspective(fixed32(60), fixed32(1.5), fixed32(0.1), fixed32(100));
+	tmat4x4<fixed32> product = p * m;
+	tmat4x4<fixed32> scalar = operator*<fixed32>(p, m);
+	failures += memcmp(&product, &scalar, sizeof(product)) != 0;
+
+	return failures;
+}
+
+static int testHalf()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	// every finite half survives the round trip through float
+	for (int i = 0; i < 0x10000; i++)
+	{
+		half h = half::bits((unsigned short)i);
+		failures += (i & 0x7C00) != 0x7C00 && half((float)h).value != h.value;
+	}
+	failures += half(65520.0f).value != 0x7C00;
+	failures += half(5.9604645e-8f).value != 0x0001;
+
+	const int count = 333;
+	vec3 v[count];
+	vec3 back[count];
+	hvec3 h[count];
+	snvec3 s[count];
+	for (int i = 0; i < count; i++)
+	{
+		float f = (float)(i - (count / 2));
+		v[i] = vec3(f * 0.0071f, f * -1.3f, 1.0f / (f + 0.5f));
+	}
+
+	// half keeps 11 significant bits, relative error at most 2^-11 in the normal range
+	pack(v, h, count);
+	unpack(h, back, count);
+	for (int i = 0; i < count; i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			float x = v[i][k];
+			float e = back[i][k] - x;
+			failures += (e < 0.0f ? -e : e) > (x < 0.0f ? -x : x) * (1.0f / 2048.0f);
+			failures += h[i][k].value != half(x).value;
+		}
+	}
+
+	// snorm16 is within half a step of the clamped value
+	pack(v, s, count);
+	unpack(s, back, count);
+	for (int i = 0; i < count; i++)
+	{
+		for (int k = 0; k < 3; k++)
+		{
+			float x = clamp(v[i][k], -1.0f, 1.0f);
+			float e = back[i][k] - x;
+			failures += (e < 0.0f ? -e : e) > 0.5f / 32767.0f + 1e-7f;
+			failures += s[i][k].value != snorm16(v[i][k]).value;
+		}
+	}
+	failures += (float)snorm16::bits(-32768) != -1.0f;
+
+	return failures;
+}
+
+static int testIntersect()
+{
+	using namespace gmath;
+	int failures = 0;
+
+	ray r(glm::tvec3<float>(0.25f, 0.25f, -5.0f), glm::tvec3<float>(0.0f, 0.0f, 1.0f));
+	hit h;
+	float d = 0.0f;
+	failures += !intersectTriangle(r, vec3(0.0f, 0.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f), h);
+	failures += !equivalent(h.distance, 5.0f) || !equivalent(h.u, 0.25f) || !equivalent(h.v, 0.25f);
+	failures += !intersectSphere(r, vec4(0.0f, 0.0f, 0.0f, 1.0f), d) || !equivalent(d, 5.0f - sqrtf(0.875f));
+	failures += !intersectPlane(r, vec4(0.0f, 0.0f, 1.0f, -2.0f), d) || !equivalent(d, 7.0f);
+	failures += !intersectBox(r, vec3(-1.0f, -1.0f, 3.0f), vec3(1.0f, 1.0f, 4.0f), d) || !equivalent(d, 8.0f);
+	failures += intersectTriangle(ray(r.origin, r.direction, 4.0f), vec3(0.0f, 0.0f, 0.0f), vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f), h);
+
+	// assignment and comparison take the length along
+	ray c;
+	c = ray(r.origin, r.direction, 4.0f);
+	failures += c.length != 4.0f || c == r || !(c != r);
+	c = r;
+	failures += c != r || !(c == r);
+
+	// the batches agree with the single tests, remainders included
+	const int count = 37;
+	vec3 v0[count];
+	vec3 v1[count];
+	vec3 v2[count];
+	vec4 spheres[count];
+	ray rays[count];
+	hit hits[count];
+	float distances[count];
+	for (int i = 0; i < count; i++)
+	{
+		float f = (float)i / (float)count;
+		v0[i] = vec3(f - 1.0f, -0.5f, f * 4.0f);
+		v1[i] = vec3(1.0f, f - 0.5f, 2.0f);
+		v2[i] = vec3(-f, 1.0f, 3.0f - f);
+		spheres[i] = vec4(f - 0.5f, 0.5f - f, 2.0f + f, 0.25f + (f * 0.25f));
+		rays[i] = ray(glm::tvec3<float>(f - 0.5f, f * 0.5f, -1.0f), glm::tvec3<float>(0.1f - (f * 0.2f), 0.0f, 1.0f));
+	}
+
+	size_t nearest = intersectTriangles(r, v0, v1, v2, hits, count);
+	float best = FLT_MAX;
+	for (int i = 0; i < count; i++)
+	{
+		hit s;
+		bool k = intersectTriangle(r, v0[i], v1[i], v2[i], s);
+		failures += k != (hits[i].distance != FLT_MAX) || (k && !equivalent(hits[i].distance, s.distance));
+		best = k && s.distance < best ? s.distance : best;
+	}
+	failures += nearest == (size_t)count || !equivalent(hits[nearest].distance, best);
+
+	intersectSphere(rays, spheres[count / 2], distances, count);
+	for (int i = 0; i < count; i++)
+	{
+		float s = 0.0f;
+		bool k = intersectSphere(rays[i], spheres[count / 2], s);
+		failures += k != (distances[i] != FLT_MAX) || (k && !equivalent(distances[i], s));
+	}
+
+	return failures;
+}
+
+static int testPacket()
+{
+	using namespace gmath;
+	typedef simd::widest<float>::type L;
+	typedef traypacket<L> packet;
+	int failures = 0;
+
+	// the packet tests agree with the single ray ones, in mixed and coherent directions
+	ray rays[L::width];
+	for (int j = 0; j < 2; j++)
+	{
+		for (int i = 0; i < L::width; i++)
+		{
+			float f = (float)i / (float)L::width;
+			float x = j == 0 ? 0.5f - f : 0.0f;
+			rays[i] = ray(glm::tvec3<float>(f - 0.5f, f * 0.5f, -2.0f), glm::tvec3<float>(x, -0.125f * f, 1.0f), 10.0f);
+		}
+
+		packet p(rays);
+		failures += p.coherent() != (j == 1 || L::width == 1);
+		L t;
+		L u;
+		L v;
+		float d[L::width];
+		float ud[L::width];
+		int m = simd::bits(p.intersect(vec3(-0.45f, -0.25f, 1.0f), vec3(0.25f, 0.5f, 2.0f), t));
+		t.store(d);
+		for (int i = 0; i < L::width; i++)
+		{
+			float s = 0.0f;
+			bool k = intersectBox(rays[i], vec3(-0.45f, -0.25f, 1.0f), vec3(0.25f, 0.5f, 2.0f), s);
+			failures += k != ((m >> i) & 1) || (k && !equivalent(d[i], s));
+		}
+
+		m = simd::bits(p.intersect(vec3(-1.0f, -1.0f, 1.0f), vec3(1.0f, -1.0f, 3.0f), vec3(-1.0f, 1.0f, 2.0f), t, u, v));
+		t.store(d);
+		u.store(ud);
+		for (int i = 0; i < L::width; i++)
+		{
+			hit s;
+			bool k = intersectTriangle(rays[i], vec3(-1.0f, -1.0f, 1.0f), vec3(1.0f, -1.0f, 3.0f), vec3(-1.0f, 1.0f, 2.0f), s);
+			failures += k != ((m >> i) & 1) || (k && (!equivalent(d[i], s.distance) || !equivalent(ud[i], s.u)));
+		}
+
+		// clipped lanes no longer see the triangle behind the box
+		p.clip(p.intersect(vec3(-0.45f, -0.25f, 1.0f), vec3(0.25f, 0.5f, 2.0f), t), t);
+		m &= simd::bits(p.intersect(vec3(-0.45f, -0.25f, 1.0f), vec3(0.25f, 0.5f, 2.0f), t));
+		failures += (simd::bits(p.intersect(vec3(-1.0f, -1.0f, 1.0f), vec3(1.0f, -1.0f, 3.0f), vec3(-1.0f, 1.0f, 2.0f), t, u, v)) & m) != 0;
+	}
+
+	// lanes whose length ends before the box do not hit it
+	for (int i = 0; i < L::width; i++)
+	{
+		float f = (float)i / (float)L::width;
+		rays[i] = ray(glm::tvec3<float>(f - 0.5f, f * 0.25f, -2.0f), glm::tvec3<float>(0.0f, 0.0f, 1.0f), (i & 1) ? 2.5f : 10.0f);
+	}
+	packet shorter;
+	L entry;
+	shorter.set(rays);
+	int hits = simd::bits(shorter.intersect(vec3(-1.0f, -1.0f, 1.0f), vec3(1.0f, 1.0f, 2.0f), entry));
+	for (int i = 0; i < L::width; i++)
+	{
+		float s = 0.0f;
+		failures += ((hits >> i) & 1) != ((i & 1) == 0) || intersectBox(rays[i], vec3(-1.0f, -1.0f, 1.0f), vec3(1.0f, 1.0f, 2.0f), s) != ((i & 1) == 0);
+	}
+
+	// rays lying in a face plane count as inside that slab, the same for the packet and the single test,
+	// with the direction signs all alike and mixed
+	for (int j = 0; j < 2; j++)
+	{
+		for (int i = 0; i < L::width; i++)
+		{
+			float f = (float)i / (float)L::width;
+			float x = j == 1 && (i & 2) != 0 ? -0.0f : 0.0f;
+			rays[i] = ray(glm::tvec3<float>((i & 1) ? 0.5f : -0.5f, f - 0.5f, -2.0f), glm::tvec3<float>(x, 0.0f, 1.0f), 10.0f);
+		}
+
+		packet face(rays);
+		float d[L::width];
+		int m = simd::bits(face.intersect(vec3(-0.5f, -0.5f, 1.0f), vec3(0.5f, 0.5f, 2.0f), entry));
+		entry.store(d);
+		failures += m != (1 << L::width) - 1;
+		for (int i = 0; i < L::width; i++)
+		{
+			float s = 0.0f;
+			failures += !intersectBox(rays[i], vec3(-0.5f, -0.5f, 1.0f), vec3(0.5f, 0.5f, 2.0f), s) || !equivalent(s, 3.0f) || !equivalent(d[i], s);
+		}
+	}
+
+	// primary rays through the middle of the screen start on the near plane and look down the view axis
+	mat4 inv = inverse(perspective(60.0f, 1.0f, 0.5f, 50.0f) * look(vec3(0.0f, 0.0f, 5.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f)));
+	packet camera(inv, L(0.0f), L(0.0f));
+	float o[L::width];
+	float dz[L::width];
+	float len[L::width];
+	camera.origin[2].store(o);
+	camera.direction[2].store(dz);
+	camera.tmax.store(len);
+	failures += !equivalent(o[0], 4.5f) || !equivalent(dz[0], -1.0f) || fabsf(len[0] - 49.5f) > 1e-3f || !camera.coherent();
+	L t;
+	failures += simd::bits(camera.intersect(vec3(-1.0f), vec3(1.0f), t)) != (1 << L::width) - 1;
+
+	return failures;
+}
+
+template <int N> static int testBvh(const gmath::vec3* v0, const gmath::vec3* v1, const gmath::vec3* v2, const int count, const ray* rays, const int rayCount)
+{
+	using namespace gmath;
+	int failures = 0;
+
+	// the closest hit matches a linear scan, before and after moving every vertex
+	tbvh<float, N> tree;
+	tree.build(v0, v1, v2, count, 4);
+	std::vector<vec3> m0(v0, v0 + count);
+	std::vector<vec3> m1(v1, v1 + count);
+	std::vector<vec3> m2(v2, v2 + count);
+	std::vector<hit> hits(count);
+	for (int pass = 0; pass < 2; pass++)
+	{
+		for (int i = 0; i < rayCount; i++)
+		{
+			hit h;
+			size_t nearest = intersectTriangles(rays[i], &m0[0], &m1[0], &m2[0], &hits[0], count);
+			int index = tree.intersect(rays[i], h);
+			failures += (index < 0) != (nearest == (size_t)count) || tree.occluded(rays[i]) != (index >= 0);
+			failures += index >= 0 && (!equivalent(h.distance, hits[nearest].distance) || !equivalent(h.distance, hits[index].distance));
+
+			// the closest hit is rejected by a ray stopping just short of it
+			if (index >= 0)
+			{
+				ray shorter(rays[i].origin, rays[i].direction, h.distance * 0.999f);
+				failures += tree.intersect(shorter, h) != -1 || tree.occluded(shorter);
+			}
+		}
+
+		for (int i = 0; i < count; i++)
+		{
+			vec3 d(sinf((float)i), 0.5f, cosf((float)i * 0.5f));
+			m0[i] += d;
+			m1[i] += d * 0.5f;
+			m2[i] -= d;
+		}
+		tree.refit(&m0[0], &m1[0], &m2[0], 2);
+	}
+
+	return failures;
+}
+
+static int testBvh()
+{
+	using namespace gmath;
+	const int count = 6000;
+	const int rayCount = 200;
+	std::vector<vec3> v0(count);
+	std::vector<vec3> v1(count);
+	std::vector<vec3> v2(count);
+	std::vector<ray> rays(rayCount);
+	for (int i = 0; i < count; i++)
+	{
+		float a = (float)i;
+		vec3 c(sinf(a * 1.3f) * 8.0f, cosf(a * 0.7f) * 8.0f, sinf(a * 0.11f) * 8.0f);
+		v0[i] = c;
+		v1[i] = c + vec3(0.5f, sinf(a) * 0.25f, 0.1f);
+		v2[i] = c + vec3(cosf(a) * 0.25f, 0.5f, -0.2f);
+	}
+	for (int i = 0; i < rayCount; i++)
+	{
+		float a = (float)i;
+		glm::tvec3<float> o(sinf(a * 0.3f) * 12.0f, cosf(a * 0.9f) * 12.0f, -12.0f);
+		glm::tvec3<float> d(sinf(a * 1.7f) - (o.x / 12.0f), cosf(a * 2.3f) - (o.y / 12.0f), 1.0f);
+		rays[i] = ray(o, d, i % 3 == 0 ? 20.0f : FLT_MAX);
+	}
+
+	tbvh<float, 4> empty;
+	hit h;
+	int failures = empty.intersect(rays[0], h) != -1 || empty.occluded(rays[0]);
+	failures += testBvh<4>(&v0[0], &v1[0], &v2[0], count, &rays[0], rayCount);
+	failures += testBvh<8>(&v0[0], &v1[0], &v2[0], count, &rays[0], rayCount);
+	failures += testBvh<4>(&v0[0], &v1[0], &v2[0], 3, &rays[0], rayCount);
+	return failures;
+}
+
+static bool equivalent(const gmath::aabb3& a, const gmath::aabb3& b)
+{
+	return equivalent(a.min.x, b.min.x) && equivalent(a.min.y, b.min.y) && equivalent(a.min.z, b.min.z) && equivalent(a.max.x, b.max.x) && equivalent(a.max.y, b.max.y) && equivalent(a.max.z, b.max.z);
+}
+static int testAabb()
+{
+	using namespace gmath;
+	const int count = 10000;
+	std::vector<aabb2> squares(count);
+	std::vector<aabb3> boxes(count);
+	for (int i = 0; i < count; i++)
+	{
+		float a = (float)i;
+		vec3 c(sinf(a * 1.3f) * 8.0f, cosf(a * 0.7f) * 8.0f, sinf(a * 0.11f) * 8.0f);
+		vec3 e(1.0f + sinf(a), 1.0f + cosf(a * 3.0f), 0.75f + (sinf(a * 5.0f) * 0.5f));
+		boxes[i] = aabb3(c - e, c + e);
+		squares[i] = aabb2(vec2(c.x - e.x, c.y - e.y), vec2(c.x + e.x, c.y + e.y));
+	}
+	boxes[7] = aabb3();
+	squares[7] = aabb2();
+
+	// the SIMD overloads agree with the generic ones, which plain float arguments no longer reach
+	int failures = 0;
+	const mat4 m = translate(rotate(0.7f, vec3(0.48f, 0.6f, 0.64f)), 1.0f, -2.0f, 3.0f);
+	for (int i = 0; i + 1 < 200; i++)
+	{
+		const aabb3& a = boxes[i];
+		const aabb3& b = boxes[i + 1];
+		failures += overlaps(a, b) != overlaps<float>(a, b);
+		failures += contains(a, b) != contains<float>(a, b) || !contains(merge(a, b), b) || !contains(a, a);
+		failures += contains(a, center(b)) != contains<float>(a, center(b));
+		failures += !equivalent(merge(a, b), merge<float>(a, b)) || !equivalent(intersection(a, b), intersection<float>(a, b));
+		failures += empty(intersection(a, b)) == overlaps(a, b);
+		failures += !equivalent(area(a), area<float>(a)) || !equivalent(area(a), i == 7 ? 0.0f : 2.0f * ((size(a).x * size(a).y) + (size(a).y * size(a).z) + (size(a).z * size(a).x)));
+
+		// Arvo's box holds every transformed corner and touches the extremes
+		aabb3 t = transform(m, a);
+		failures += !equivalent(t, transform<float>(m, a)) || empty(t) != empty(a);
+		aabb3 corners;
+		for (int k = 0; k < 8 && !empty(a); k++)
+		{
+			vec4 p = m * vec4((k & 1) ? a.max.x : a.min.x, (k & 2) ? a.max.y : a.min.y, (k & 4) ? a.max.z : a.min.z, 1.0f);
+			corners = merge(corners, vec3(p.x, p.y, p.z));
+		}
+		failures += !empty(a) && !equivalent(t, corners);
+
+		const aabb2& c = squares[i];
+		const aabb2& d = squares[i + 1];
+		failures += overlaps(c, d) != overlaps<float>(c, d) || contains(c, d) != contains<float>(c, d);
+		failures += contains(c, center(d)) != contains<float>(c, center(d)) || !contains(c, c);
+		failures += !contains(merge(c, d), d) || empty(intersection(c, d)) == overlaps(c, d);
+	}
+
+	// bitmasks, with a partial last word and across threads
+	std::vector<unsigned int> bits((count + 31) / 32);
+	for (int j = 0; j < 2; j++)
+	{
+		const aabb3& box = boxes[j * 100];
+		const aabb2& square = squares[j * 100];
+		overlaps(box, &boxes[0], &bits[0], count - 5, j + 1);
+		for (int i = 0; i < count - 5; i++)
+		{
+			failures += ((bits[i >> 5] >> (i & 31)) & 1) != (overlaps(box, boxes[i]) ? 1u : 0u);
+		}
+		failures += (bits[(count - 6) >> 5] >> ((count - 5) & 31)) != 0;
+
+		overlaps(square, &squares[0], &bits[0], count, j + 1);
+		for (int i = 0; i < count; i++)
+		{
+			failures += ((bits[i >> 5] >> (i & 31)) & 1) != (overlaps(square, squares[i]) ? 1u : 0u);
+		}
+	}
+
+	return failures;
+}
+
+static int testBroadphase()
+{
+	using namespace gmath;
+	const int count = 400;
+	broadphase tree(0.25f);
+	std::vector<int> proxies(count);
+	std::vector<vec3> centers(count);
+	std::vector<char> contacts(count * count);
+	std::vector<char> found(count * count);
+	std::vector<int> owners;
+	int failures = 0;
+
+	for (int tick = 0; tick < 20; tick++)
+	{
+		// everything drifts, the first ticks create the proxies and a few are recreated each tick
+		for (int i = 0; i < count; i++)
+		{
+			float a = (float)i;
+			float t = (float)tick * 0.1f;
+			centers[i] = vec3(sinf((a * 1.3f) + t) * 6.0f, cosf((a * 0.7f) + (t * 0.5f)) * 6.0f, sinf(a * 0.11f) * 6.0f);
+			aabb3 box(centers[i] - vec3(0.5f), centers[i] + vec3(0.5f));
+			if (tick == 0)
+			{
+				proxies[i] = tree.create(box);
+			}
+			else if ((i + tick) % 37 == 0)
+			{
+				tree.destroy(proxies[i]);
+				proxies[i] = tree.create(box);
+			}
+			else
+			{
+				tree.move(proxies[i], box);
+			}
+		}
+
+		// the contacts kept from reported pairs, dropped once the fat boxes part, are all the overlapping pairs
+		owners.assign(count * 2, -1);
+		for (int i = 0; i < count; i++)
+		{
+			owners[proxies[i]] = i;
+		}
+		for (int i = 0; i < count * count; i++)
+		{
+			int a = i / count;
+			int b = i % count;
+			contacts[i] = contacts[i] && ((a + tick) % 37 != 0) && ((b + tick) % 37 != 0) && tree.overlapping(proxies[a], proxies[b]);
+		}
+		std::fill(found.begin(), found.end(), 0);
+		int pairs = tree.pairs([&](const int a, const int b)
+		{
+			failures += a >= b || found[(owners[a] * count) + owners[b]]++ != 0;
+			contacts[(owners[a] * count) + owners[b]] = 1;
+			contacts[(owners[b] * count) + owners[a]] = 1;
+		});
+		failures += tree.stats().pairs != pairs || tree.stats().proxies != count || tree.size() != count;
+		for (int a = 0; a < count; a++)
+		{
+			for (int b = 0; b < count; b++)
+			{
+				failures += a != b && contacts[(a * count) + b] != (char)overlaps(tree.bounds(proxies[a]), tree.bounds(proxies[b]));
+			}
+		}
+	}
+	failures += tree.height() > 24;
+
+	// box, ray and frustum queries find exactly the fat boxes a brute force test does
+	aabb3 region(vec3(-2.0f), vec3(3.0f, 1.0f, 2.0f));
+	std::fill(found.begin(), found.end(), 0);
+	tree.query(region, [&](const int p) { found[p]++; });
+	for (int i = 0; i < count; i++)
+	{
+		failures += found[proxies[i]] != (char)overlaps(region, tree.bounds(proxies[i]));
+	}
+
+	ray r(glm::tvec3<float>(-9.0f, 0.5f, 0.25f), glm::tvec3<float>(1.0f, 0.1f, 0.05f), 20.0f);
+	std::fill(found.begin(), found.end(), 0);
+	tree.query(r, [&](const int p, const float) { found[p]++; return FLT_MAX; });
+	for (int i = 0; i < count; i++)
+	{
+		float t = 0.0f;
+		bool hit = intersectBox(r, tree.bounds(proxies[i]).min, tree.bounds(proxies[i]).max, t);
+		failures += found[proxies[i]] != (char)hit;
+	}
+
+	// a ray lying in a face of a box enters it, as intersectBox has it
+	const aabb3 face = tree.bounds(proxies[0]);
+	ray grazing(glm::tvec3<float>(face.min.x, face.min.y - 1.0f, (face.min.z + face.max.z) * 0.5f), glm::tvec3<float>(0.0f, 1.0f, 0.0f), 20.0f);
+	std::fill(found.begin(), found.end(), 0);
+	tree.query(grazing, [&](const int p, const float) { found[p]++; return FLT_MAX; });
+	failures += found[proxies[0]] != 1;
+	for (int i = 0; i < count; i++)
+	{
+		float t = 0.0f;
+		failures += found[proxies[i]] != (char)intersectBox(grazing, tree.bounds(proxies[i]).min, tree.bounds(proxies[i]).max, t);
+	}
+
+	// cutting the ray at the first box entered leaves only boxes that start before it
+	float first = FLT_MAX;
+	tree.query(r, [&](const int, const float t) { first = t < first ? t : first; return t; });
+	int reached = 0;
+	int total = 0;
+	tree.query(r, [&](const int, const float) { reached++; return first; });
+	tree.query(r, [&](const int, const float) { total++; return FLT_MAX; });
+	failures += reached < 1 || reached >= total;
+
+	viewfrustum f(perspective(60.0f, 1.0f, 0.5f, 50.0f) * look(vec3(0.0f, 0.0f, 12.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f)));
+	std::fill(found.begin(), found.end(), 0);
+	tree.query(f, [&](const int p) { found[p]++; });
+	int visible = 0;
+	for (int i = 0; i < count; i++)
+	{
+		bool inside = f.intersects(tree.bounds(proxies[i]).min, tree.bounds(proxies[i]).max);
+		failures += found[proxies[i]] != (char)inside;
+		visible += inside ? 1 : 0;
+	}
+	failures += visible == 0 || visible == count;
+
+	for (int i = 0; i < count; i++)
+	{
+		tree.destroy(proxies[i]);
+	}
+	failures += tree.size() != 0 || tree.height() != 0 || tree.pairs([&](const int, const int) {}) != 0;
+	return failures;
+}
+
 int main(int argc, char** argv)
 {
+	int failures = testSimd();
+	failures += testBatch();
+	failures += testBatchDouble();
+	failures += testStream();
+	failures += testProjector();
+	failures += testAffine();
+	failures += testQuat();
+	failures += testTrig();
+	failures += testHierarchy();
+	failures += testDecompose();
+	failures += testCull<float>();
+	failures += testCull<double>();
+	failures += testDispatch();
+	failures += testFixed();
+	failures += testHalf();
+	failures += testIntersect();
+	failures += testPacket();
+	failures += testBvh();
+	failures += testAabb();
+	failures += testBroadphase();
+
 	unsigned int i = 0xFF0088AA;
 	unsigned char* read = (unsigned char*)&i;
 	unsigned char col0 = read[0];
@@ -315,5 +1581,5 @@ int main(int argc, char** argv)
 	fuzzy fz0;
 	tbox<int> b0;
 
-	return 0;
+	return failures;
 }
\ No newline at end of file